@@ -256,10 +256,10 @@ void GUIApplicationInterface::requestExit()
   pres->exit();
 }
 
-void GUIApplicationInterface::forceExit()
+void GUIApplicationInterface::forceExit(int exitCode)
 {
   requestExit();
-  QTimer::singleShot(500, [] { QCoreApplication::quit(); });
+  QTimer::singleShot(500, [exitCode] { QCoreApplication::exit(exitCode); });
 }
 
 GUIApplicationContext::GUIApplicationContext(
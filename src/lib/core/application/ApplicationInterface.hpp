@@ -62,6 +62,7 @@ public:
   void registerPlugin(score::Plugin_QtInterface&);
 
   void requestExit();
-  void forceExit();
+  //! Closes the documents without asking, then exits with the given code
+  void forceExit(int exitCode = 0);
 };
 }
@@ -12,6 +12,8 @@
 #include <QString>
 
 #include <score_git_info.hpp>
+
+#include <algorithm>
 namespace score
 {
 void ApplicationSettings::parse(QStringList cargs, int& argc, char** argv)
@@ -62,6 +64,57 @@ void ApplicationSettings::parse(QStringList cargs, int& argc, char** argv)
       "");
   parser.addOption(uiOpt);
 
+  QCommandLineOption benchOpt(
+      "benchmark",
+      QCoreApplication::translate(
+          "main",
+          "Run the loaded scenario faster than realtime without a sound card "
+          "and write execution timings to a JSON file."),
+      "file", "");
+  parser.addOption(benchOpt);
+
+  QCommandLineOption benchBufferOpt(
+      "benchmark-buffer-size",
+      QCoreApplication::translate("main", "Buffer size used for --benchmark."), "N",
+      "512");
+  parser.addOption(benchBufferOpt);
+
+  QCommandLineOption benchRateOpt(
+      "benchmark-rate",
+      QCoreApplication::translate("main", "Sample rate used for --benchmark."), "N",
+      "48000");
+  parser.addOption(benchRateOpt);
+
+  QCommandLineOption benchDurationOpt(
+      "benchmark-duration",
+      QCoreApplication::translate(
+          "main",
+          "Seconds of scenario to run for --benchmark. "
+          "Defaults to the duration of the root interval."),
+      "S", "0");
+  parser.addOption(benchDurationOpt);
+
+  QCommandLineOption compactUndoOpt(
+      "compact-undo",
+      QCoreApplication::translate(
+          "main", "Compact the commands after the N most recent ones in the undo list."),
+      "N", "0");
+  parser.addOption(compactUndoOpt);
+
+  QCommandLineOption undoMemoryOpt(
+      "undo-memory-limit",
+      QCoreApplication::translate(
+          "main", "Memory used by the compacted commands before using the disk."),
+      "MB", "64");
+  parser.addOption(undoMemoryOpt);
+
+  QCommandLineOption checkpointOpt(
+      "checkpoint-interval",
+      QCoreApplication::translate(
+          "main", "Idle time before a checkpoint of the crash backup, 0 to disable."),
+      "seconds", "30");
+  parser.addOption(checkpointOpt);
+
 #if defined(__APPLE__)
   // Bogus macOS gatekeeper BS:
   // https://stackoverflow.com/questions/55562155/qt-application-for-mac-not-being-launched
@@ -122,10 +175,29 @@ void ApplicationSettings::parse(QStringList cargs, int& argc, char** argv)
   if(parser.isSet(noGL))
     opengl = false;
 
+  if(parser.isSet(benchOpt))
+  {
+    benchmark = parser.value(benchOpt);
+    gui = false;
+    if(parser.isSet(benchBufferOpt))
+      benchmarkBufferSize = std::max(1, parser.value(benchBufferOpt).toInt());
+    if(parser.isSet(benchRateOpt))
+      benchmarkRate = std::max(1, parser.value(benchRateOpt).toInt());
+    if(parser.isSet(benchDurationOpt))
+      benchmarkDuration = std::max(0., parser.value(benchDurationOpt).toDouble());
+  }
+
   if(!gui)
     tryToRestore = false;
   autoplay = parser.isSet(autoplayOpt);
 
+  if(parser.isSet(compactUndoOpt))
+    compactUndoAfter = std::max(0, parser.value(compactUndoOpt).toInt());
+  if(parser.isSet(undoMemoryOpt))
+    undoMemoryLimit = std::max(1, parser.value(undoMemoryOpt).toInt());
+  if(parser.isSet(checkpointOpt))
+    checkpointInterval = std::max(0, parser.value(checkpointOpt).toInt());
+
   if(parser.isSet(waitLoadOpt))
     waitAfterLoad = parser.value(waitLoadOpt).toInt();
 
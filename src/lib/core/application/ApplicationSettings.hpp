@@ -48,6 +48,31 @@ struct SCORE_LIB_BASE_EXPORT ApplicationSettings
   //! UI event processing rate in ms (used for plug-in gui updates, etc)
   int uiEventRate = 64;
 
+  //! Commands kept as is at the top of the undo stack, the older ones are
+  //! compacted. 0 keeps all the commands as is.
+  int compactUndoAfter = 0;
+
+  //! Memory used by the compacted commands of a document before they are
+  //! moved to a temporary file, in MB
+  int undoMemoryLimit = 64;
+
+  //! Seconds without new commands before a checkpoint of the crash backup is
+  //! taken. 0 disables the checkpoints.
+  int checkpointInterval = 30;
+
+  //! If not empty, run an offline benchmark of the loaded scenario and
+  //! write the results as JSON to this file.
+  QString benchmark;
+
+  //! Buffer size used for the offline benchmark
+  int benchmarkBufferSize = 512;
+
+  //! Sample rate used for the offline benchmark
+  int benchmarkRate = 48000;
+
+  //! Seconds of execution to benchmark, 0 meaning the root interval's duration
+  double benchmarkDuration = 0.;
+
   //! Parse the arguments.
   void parse(QStringList args, int& argc, char** argv);
 };
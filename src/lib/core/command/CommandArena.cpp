@@ -0,0 +1,136 @@
+#include "CommandArena.hpp"
+
+#include <score/application/GUIApplicationContext.hpp>
+#include <score/command/CommandData.hpp>
+#include <score/document/DocumentContext.hpp>
+#include <score/serialization/DataStreamVisitor.hpp>
+#include <score/tools/Debug.hpp>
+
+#include <QDebug>
+
+#include <limits>
+#include <memory>
+
+namespace score
+{
+CompactCommand::CompactCommand(CommandArena& arena, const score::Command& cmd)
+    : m_arena{arena}
+    , m_parentKey{cmd.parentKey()}
+    , m_key{cmd.key()}
+    , m_description{cmd.description()}
+    , m_compressed{qCompress(cmd.serialize())}
+{
+  m_arena.add(*this);
+}
+
+CompactCommand::~CompactCommand()
+{
+  m_arena.remove(*this);
+}
+
+CommandData CompactCommand::data() const
+{
+  CommandData d;
+  d.parentKey = m_parentKey;
+  d.commandKey = m_key;
+  d.data = m_arena.read(*this);
+  return d;
+}
+
+void CompactCommand::undo(const score::DocumentContext& ctx) const
+{
+  std::unique_ptr<score::Command> cmd{
+      ctx.app.components.instantiateUndoCommand(data())};
+  cmd->undo(ctx);
+}
+
+void CompactCommand::redo(const score::DocumentContext& ctx) const
+{
+  std::unique_ptr<score::Command> cmd{
+      ctx.app.components.instantiateUndoCommand(data())};
+  cmd->redo(ctx);
+}
+
+void CompactCommand::serializeImpl(DataStreamInput& s) const
+{
+  const auto raw = m_arena.read(*this);
+  s.stream.writeRawData(raw.constData(), raw.size());
+}
+
+void CompactCommand::deserializeImpl(DataStreamOutput&)
+{
+  // Compact commands are only created from existing commands
+  SCORE_ABORT;
+}
+
+CommandArena::CommandArena(qint64 memoryLimit)
+    : m_memoryLimit{memoryLimit}
+{
+}
+
+CommandArena::~CommandArena()
+{
+  // The commands must be removed from the stack before
+  SCORE_ASSERT(m_commands.empty());
+}
+
+void CommandArena::add(CompactCommand& cmd)
+{
+  m_memory += cmd.m_compressed.size();
+  cmd.m_position = m_commands.insert(m_commands.end(), &cmd);
+
+  if(m_memory > m_memoryLimit)
+    spill();
+}
+
+void CommandArena::remove(CompactCommand& cmd)
+{
+  // The space used by spilled commands is only reclaimed with the file
+  if(cmd.m_offset < 0)
+  {
+    m_memory -= cmd.m_compressed.size();
+    m_commands.erase(cmd.m_position);
+  }
+}
+
+QByteArray CommandArena::read(const CompactCommand& cmd)
+{
+  if(cmd.m_offset < 0)
+    return qUncompress(cmd.m_compressed);
+
+  m_file.seek(cmd.m_offset);
+  return qUncompress(m_file.read(cmd.m_size));
+}
+
+void CommandArena::spill()
+{
+  if(!m_file.isOpen() && !m_file.open())
+  {
+    qWarning() << "Cannot open the command storage file:" << m_file.errorString();
+    m_memoryLimit = std::numeric_limits<qint64>::max();
+    return;
+  }
+
+  // Move the oldest commands to the disk, until half of the allowed memory is free
+  const qint64 target = m_memoryLimit / 2;
+  while(m_memory > target && !m_commands.empty())
+  {
+    auto& cmd = *m_commands.front();
+    const qint64 offset = m_file.size();
+    m_file.seek(offset);
+    if(m_file.write(cmd.m_compressed) != cmd.m_compressed.size())
+    {
+      qWarning() << "Cannot write to the command storage file:" << m_file.errorString();
+      m_memoryLimit = std::numeric_limits<qint64>::max();
+      return;
+    }
+
+    m_memory -= cmd.m_compressed.size();
+    cmd.m_offset = offset;
+    cmd.m_size = cmd.m_compressed.size();
+    cmd.m_compressed = QByteArray{};
+    m_commands.pop_front();
+  }
+  m_file.flush();
+}
+}
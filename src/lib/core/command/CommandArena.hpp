@@ -0,0 +1,90 @@
+#pragma once
+#include <score/command/Command.hpp>
+
+#include <QByteArray>
+#include <QTemporaryFile>
+
+#include <list>
+
+namespace score
+{
+class CommandArena;
+struct CommandData;
+
+/**
+ * @brief Stand-in for a command of the stack which is rarely accessed.
+ *
+ * Only the compressed serialized data of the command is kept.
+ * The actual command is instantiated again each time it is undone or redone.
+ * Serializing a CompactCommand gives exactly the data of the original
+ * command, thus it is saved and backed up like it.
+ */
+class SCORE_LIB_BASE_EXPORT CompactCommand final : public score::Command
+{
+public:
+  CompactCommand(CommandArena& arena, const score::Command& cmd);
+  ~CompactCommand();
+
+  void undo(const score::DocumentContext& ctx) const override;
+  void redo(const score::DocumentContext& ctx) const override;
+
+  const CommandGroupKey& parentKey() const noexcept override { return m_parentKey; }
+  const CommandKey& key() const noexcept override { return m_key; }
+  QString description() const override { return m_description; }
+
+protected:
+  void serializeImpl(DataStreamInput&) const override;
+  void deserializeImpl(DataStreamOutput&) override;
+
+private:
+  friend class CommandArena;
+  CommandData data() const;
+
+  CommandArena& m_arena;
+  CommandGroupKey m_parentKey;
+  CommandKey m_key;
+  QString m_description;
+
+  // Compressed data, empty once it has been moved to the disk
+  QByteArray m_compressed;
+  qint64 m_offset{-1};
+  qint64 m_size{};
+
+  std::list<CompactCommand*>::iterator m_position;
+};
+
+/**
+ * @brief Storage of the compacted commands of a CommandStack.
+ *
+ * The compressed data of the commands stays in memory up to a given amount
+ * of bytes, after which the oldest ones are moved to a temporary file.
+ */
+class SCORE_LIB_BASE_EXPORT CommandArena
+{
+public:
+  //! memoryLimit is in bytes
+  explicit CommandArena(qint64 memoryLimit);
+  ~CommandArena();
+
+  CommandArena(const CommandArena&) = delete;
+  CommandArena& operator=(const CommandArena&) = delete;
+
+  //! Bytes of compressed data currently in memory
+  qint64 memory() const noexcept { return m_memory; }
+
+private:
+  friend class CompactCommand;
+  void add(CompactCommand& cmd);
+  void remove(CompactCommand& cmd);
+  QByteArray read(const CompactCommand& cmd);
+
+  void spill();
+
+  // In memory commands, from the oldest to the newest
+  std::list<CompactCommand*> m_commands;
+  qint64 m_memory{};
+  qint64 m_memoryLimit{};
+
+  QTemporaryFile m_file;
+};
+}
@@ -5,6 +5,8 @@
 #include <score/command/Validity/ValidityChecker.hpp>
 #include <score/document/DocumentContext.hpp>
 
+#include <core/application/ApplicationSettings.hpp>
+#include <core/command/CommandArena.hpp>
 #include <core/command/CommandStack.hpp>
 #include <core/document/Document.hpp>
 
@@ -28,12 +30,14 @@ CommandStack::~CommandStack()
 
 void CommandStack::enableActions()
 {
+  m_actionsEnabled = true;
   canUndoChanged(canUndo());
   canRedoChanged(canRedo());
 }
 
 void CommandStack::disableActions()
 {
+  m_actionsEnabled = false;
   canUndoChanged(false);
   canRedoChanged(false);
 }
@@ -167,6 +171,7 @@ void CommandStack::push(Command* cmd)
       m_redoable.clear();
     }
 
+    compact();
     sig_push();
   });
 }
@@ -194,10 +199,38 @@ void CommandStack::pushQuiet(Command* cmd)
       m_redoable.clear();
     }
 
+    compact();
     sig_push();
   });
 }
 
+void CommandStack::compact()
+{
+  const auto& settings = m_ctx.app.applicationSettings;
+  const int keep = settings.compactUndoAfter;
+  if(keep <= 0)
+    return;
+
+  if(!m_arena)
+  {
+    const qint64 limit = std::max(1, settings.undoMemoryLimit);
+    m_arena = std::make_unique<CommandArena>(limit * 1024 * 1024);
+  }
+
+  // The older commands have already been compacted, unless the stack was
+  // just loaded
+  for(int i = m_undoable.size() - keep - 1; i >= 0; i--)
+  {
+    auto& cmd = m_undoable[i];
+    if(dynamic_cast<CompactCommand*>(cmd))
+      break;
+
+    auto compacted = new CompactCommand{*m_arena, *cmd};
+    delete cmd;
+    cmd = compacted;
+  }
+}
+
 void CommandStack::setSavedIndex(int index)
 {
   if(index != m_savedIndex)
@@ -6,10 +6,12 @@
 #include <QStack>
 #include <QString>
 
+#include <memory>
 #include <verdigris>
 
 namespace score
 {
+class CommandArena;
 class Document;
 
 /**
@@ -21,6 +23,9 @@ class Document;
  * This class should never be used directly to send commands.
  * Instead, the various command dispatchers, in score/command/Dispatchers
  * should be used.
+ *
+ * When ApplicationSettings::compactUndoAfter is set, the commands further
+ * down the undo stack are replaced by CompactCommand to save memory.
  */
 class SCORE_LIB_BASE_EXPORT CommandStack final : public QObject
 {
@@ -48,6 +53,9 @@ public:
    */
   void disableActions();
 
+  //! False while an ongoing action is being performed
+  bool actionsEnabled() const noexcept { return m_actionsEnabled; }
+
   bool canUndo() const;
 
   bool canRedo() const;
@@ -209,7 +217,12 @@ private:
   QStack<score::Command*> m_undoable;
   QStack<score::Command*> m_redoable;
 
+  void compact();
+
   int m_savedIndex{};
+  bool m_actionsEnabled{true};
+
+  std::unique_ptr<CommandArena> m_arena;
 
   DocumentValidator m_checker;
   const score::DocumentContext& m_ctx;
@@ -141,6 +141,10 @@ Document::~Document()
   // (Else we would have to fine-grain the deletion of the selection stack).
 
   blockAllSignals();
+
+  // The entries would otherwise be dropped one by one with the objects
+  m_pathCache.clear();
+
   delete m_presenter;
   delete m_view;
   delete m_model;
@@ -1,6 +1,7 @@
 #pragma once
 #include <score/document/DocumentContext.hpp>
 #include <score/locking/ObjectLocker.hpp>
+#include <score/model/path/ObjectPathCache.hpp>
 #include <score/selection/FocusManager.hpp>
 #include <score/selection/SelectionStack.hpp>
 
@@ -70,6 +71,7 @@ public:
   FocusManager& focusManager() noexcept { return m_focus; }
 
   ObjectLocker& locker() noexcept { return m_objectLocker; }
+  ObjectPathCache& pathCache() noexcept { return m_pathCache; }
 
   const DocumentContext& context() const noexcept { return m_context; }
 
@@ -87,6 +89,9 @@ public:
   void saveAsJson(JSONObject::Serializer& writer);
   QByteArray saveAsByteArray();
 
+  //! Same as saveAsByteArray, without marking the document as saved
+  QByteArray serializeAsByteArray();
+
   //! Indicates if the document has just been created and can be safely
   //! discarded.
   bool virgin() const
@@ -135,6 +140,7 @@ private:
 
   SelectionStack m_selectionStack;
   ObjectLocker m_objectLocker;
+  ObjectPathCache m_pathCache;
   FocusManager m_focus;
   QTimer m_documentCoarseUpdateTimer;
   QTimer m_execTimer;
@@ -4,13 +4,83 @@
 
 #include "Document.hpp"
 
+#include <score/application/GUIApplicationContext.hpp>
+#include <score/tools/Bind.hpp>
+#include <score/tools/ThreadPool.hpp>
+
+#include <core/application/ApplicationSettings.hpp>
 #include <core/application/CommandBackupFile.hpp>
 #include <core/application/OpenDocumentsFile.hpp>
+#include <core/command/CommandStack.hpp>
+#include <core/document/DocumentBackups.hpp>
 
+#include <QDataStream>
 #include <QFile>
+#include <QSaveFile>
 #include <QSettings>
 #include <QVariant>
 
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+
+namespace
+{
+// When this many commands would have to be replayed, a shorter pause of the
+// user is enough to take a checkpoint.
+constexpr int maxCommandsBetweenCheckpoints = 256;
+constexpr int shortIdleDelay = 1000;
+
+// The model is serialized in the GUI thread: not more often than this.
+constexpr int minCheckpointInterval = 5000;
+}
+
+/**
+ * Writes the checkpoints in the background.
+ *
+ * Only the latest checkpoint is written: a write whose generation is
+ * outdated is cancelled, or removed if it was already committed.
+ * The mutex only orders the writes between themselves, the GUI thread never
+ * waits for it.
+ */
+struct score::DocumentBackupManager::CheckpointWriter
+{
+  QString path;
+  std::mutex mutex;
+  std::atomic<int64_t> generation{};
+
+  void write(int64_t gen, int commands, const QByteArray& doc)
+  {
+    std::lock_guard lock{mutex};
+    if(gen != generation)
+      return;
+
+    // The previous checkpoint stays valid until the new one is complete
+    QSaveFile f{path};
+    if(!f.open(QIODevice::WriteOnly))
+      return;
+
+    QDataStream s{&f};
+    s << qint32(commands) << doc;
+    if(gen != generation)
+    {
+      f.cancelWriting();
+      return;
+    }
+    f.commit();
+
+    // remove() may have run between the check and the commit
+    if(gen != generation)
+      QFile::remove(path);
+  }
+
+  void remove()
+  {
+    generation++;
+    QFile::remove(path);
+  }
+};
+
 score::DocumentBackupManager::DocumentBackupManager(
     const QByteArray& data, score::Document& doc)
     : QObject{&doc}
@@ -22,6 +92,7 @@ score::DocumentBackupManager::DocumentBackupManager(
   m_modelFile.write(data);
   m_modelFile.flush();
 
+  init_checkpoints();
   m_commandFile = new CommandBackupFile{doc.commandStack(), this};
 }
 
@@ -36,11 +107,21 @@ score::DocumentBackupManager::DocumentBackupManager(
   m_modelFile.write(prev.doc);
   m_modelFile.flush();
 
+  init_checkpoints();
+  if(!prev.checkpoint.isEmpty())
+  {
+    m_checkpointWriter->write(
+        m_checkpointWriter->generation, prev.checkpointCommands, prev.checkpoint);
+    m_checkpointCommands = prev.checkpointCommands;
+  }
+
   m_commandFile = new CommandBackupFile{doc.commandStack(), prev.commands, this};
 }
 
 score::DocumentBackupManager::~DocumentBackupManager()
 {
+  removeCheckpoint();
+
 #if !defined(__EMSCRIPTEN__)
   // If we are getting there, it means that we could close the document
   // normally thus we can just remove the associated files
@@ -67,6 +148,87 @@ score::CommandBackupFile& score::DocumentBackupManager::crashCommandFile()
   return *m_commandFile;
 }
 
+void score::DocumentBackupManager::init_checkpoints()
+{
+  m_checkpointWriter = std::make_shared<CheckpointWriter>();
+  m_checkpointWriter->path
+      = DocumentBackups::checkpointFileName(crashDataFile().fileName());
+
+  m_checkpointTimer.setSingleShot(true);
+  m_lastCheckpoint.start();
+  con(m_checkpointTimer, &QTimer::timeout, this, [this] {
+    if(m_dirty)
+      checkpoint();
+  });
+
+  // Must be connected before the CommandBackupFile: an outdated checkpoint
+  // has to be removed before the new commands are written.
+  auto& stack = m_doc.commandStack();
+  con(stack, &CommandStack::sig_push, this,
+      &DocumentBackupManager::on_commandsChanged);
+  con(stack, &CommandStack::sig_undo, this,
+      &DocumentBackupManager::on_commandsChanged);
+  con(stack, &CommandStack::sig_redo, this,
+      &DocumentBackupManager::on_commandsChanged);
+  con(stack, &CommandStack::sig_indexChanged, this,
+      &DocumentBackupManager::on_commandsChanged);
+}
+
+void score::DocumentBackupManager::on_commandsChanged()
+{
+  const int commands = m_doc.commandStack().undoable().size();
+  if(commands < m_checkpointCommands)
+    removeCheckpoint();
+
+  const int interval = m_doc.context().app.applicationSettings.checkpointInterval;
+  if(interval <= 0)
+    return;
+
+  // The checkpoint is only taken once the user stops editing for a while:
+  // every new command restarts the timer.
+  m_dirty = true;
+  int delay = interval * 1000;
+  if(commands - std::max(m_checkpointCommands, 0) >= maxCommandsBetweenCheckpoints)
+  {
+    delay = std::max(
+        shortIdleDelay, minCheckpointInterval - int(m_lastCheckpoint.elapsed()));
+  }
+  m_checkpointTimer.start(std::min(delay, interval * 1000));
+}
+
+void score::DocumentBackupManager::checkpoint()
+{
+  // Not while something is being moved: the model is not in sync with the
+  // command stack
+  if(!m_doc.commandStack().actionsEnabled())
+  {
+    m_checkpointTimer.start(minCheckpointInterval);
+    return;
+  }
+
+  m_checkpointTimer.stop();
+  m_lastCheckpoint.restart();
+  m_dirty = false;
+
+  // The model can only be accessed from the GUI thread: it is serialized here,
+  // and written to the disk in the background.
+  const int commands = m_doc.commandStack().undoable().size();
+  auto data = m_doc.serializeAsByteArray();
+  m_checkpointCommands = commands;
+
+  const int64_t gen = ++m_checkpointWriter->generation;
+  score::TaskPool::instance().post(
+      [writer = m_checkpointWriter, gen, commands, data = std::move(data)] {
+    writer->write(gen, commands, data);
+  });
+}
+
+void score::DocumentBackupManager::removeCheckpoint()
+{
+  m_checkpointCommands = -1;
+  m_checkpointWriter->remove();
+}
+
 void score::DocumentBackupManager::updateBackupData()
 {
 #if !defined(__EMSCRIPTEN__)
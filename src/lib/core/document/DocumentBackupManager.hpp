@@ -1,7 +1,11 @@
 #pragma once
 #include <QByteArray>
+#include <QElapsedTimer>
 #include <QObject>
 #include <QTemporaryFile>
+#include <QTimer>
+
+#include <memory>
 
 namespace score
 {
@@ -19,14 +23,15 @@ struct RestorableDocument;
  * when it was loaded, and one that saves all the command that have been
  * applied.
  *
- * TODO : update the document part each time the user saves the document. This
- * way there will be much fewer operations to apply if there is a crash.
- * However we have to be very careful in case of the user saving, and then
- * going before
- * his "saved" point in the undo / redo list.
- * Maybe we should keep the previous document saves somewhere and reload from
- * the
- * correct document save according to our position in the command stack.
+ * So that restoring does not have to replay the whole history of long
+ * sessions, a checkpoint of the model is saved next to the document part
+ * when the user pauses (see ApplicationSettings::checkpointInterval), with
+ * the number of commands of the undo stack it contains.
+ * When restoring, only the commands after the checkpoint are replayed, the
+ * others are just put back in the undo stack.
+ *
+ * If the user undoes past the checkpoint, it no longer matches the command
+ * stack and is removed until the next one is taken.
  *
  * \see score::OpenDocumentsFile
  * \see score::CommandBackupFile
@@ -50,12 +55,29 @@ public:
 
   void updateBackupData();
 
+  //! Saves the current state of the model as the new checkpoint
+  void checkpoint();
+
 private:
+  struct CheckpointWriter;
+
   QTemporaryFile& crashDataFile();
   CommandBackupFile& crashCommandFile();
 
+  void init_checkpoints();
+  void on_commandsChanged();
+  void removeCheckpoint();
+
   score::Document& m_doc;
   QTemporaryFile m_modelFile;
   CommandBackupFile* m_commandFile{};
+
+  QTimer m_checkpointTimer;
+  QElapsedTimer m_lastCheckpoint;
+  std::shared_ptr<CheckpointWriter> m_checkpointWriter;
+
+  //! Commands of the undo stack contained in the checkpoint, -1 if there is none
+  int m_checkpointCommands{-1};
+  bool m_dirty{false};
 };
 }
@@ -10,6 +10,7 @@
 #include <ossia/detail/algorithms.hpp>
 
 #include <QApplication>
+#include <QDataStream>
 #include <QDateTime>
 #include <QFile>
 #include <QIcon>
@@ -62,6 +63,9 @@ static void loadRestorableDocumentData(
       arr.push_back(
           {save_filename, data_filename, command_filename, data_file.readAll(),
            command_file.readAll()});
+      auto& doc = arr.back();
+      score::DocumentBackups::readCheckpoint(
+          data_filename, doc.checkpoint, doc.checkpointCommands);
     }
     else
     {
@@ -75,7 +79,11 @@ static void loadRestorableDocumentData(
         it->docPath = data_filename;
         it->commandsPath = command_filename;
         it->doc = data_file.readAll();
-        it->commandsPath = command_file.readAll();
+        it->commands = command_file.readAll();
+        it->checkpoint.clear();
+        it->checkpointCommands = 0;
+        score::DocumentBackups::readCheckpoint(
+            data_filename, it->checkpoint, it->checkpointCommands);
       }
     }
   }
@@ -117,6 +125,7 @@ SCORE_LIB_BASE_EXPORT void score::DocumentBackups::clear()
       for(auto it = existing_files.cbegin(); it != existing_files.cend(); ++it)
       {
         QFile{it.key()}.remove();
+        QFile{checkpointFileName(it.key())}.remove();
         auto files = it.value().value<QPair<QString, QString>>();
         QFile{files.second}.remove();
       }
@@ -127,3 +136,27 @@ SCORE_LIB_BASE_EXPORT void score::DocumentBackups::clear()
   }
 #endif
 }
+
+QString score::DocumentBackups::checkpointFileName(const QString& dataFile)
+{
+  return dataFile + QStringLiteral(".checkpoint");
+}
+
+bool score::DocumentBackups::readCheckpoint(
+    const QString& dataFile, QByteArray& doc, int& commands)
+{
+  QFile f{checkpointFileName(dataFile)};
+  if(!f.open(QIODevice::ReadOnly))
+    return false;
+
+  QDataStream s{&f};
+  qint32 count{};
+  QByteArray data;
+  s >> count >> data;
+  if(s.status() != QDataStream::Ok || count < 0 || data.isEmpty())
+    return false;
+
+  doc = std::move(data);
+  commands = count;
+  return true;
+}
@@ -17,6 +17,10 @@ struct RestorableDocument
   QString commandsPath;
   QByteArray doc;
   QByteArray commands;
+
+  //! State of the document after its first checkpointCommands commands, if any
+  QByteArray checkpoint;
+  int checkpointCommands{};
 };
 
 /**
@@ -42,5 +46,12 @@ struct SCORE_LIB_BASE_EXPORT DocumentBackups
 
   // Removes all the on-disk files that contains document backups.
   static void clear();
+
+  // File containing the latest checkpoint of the document backed up in dataFile.
+  static QString checkpointFileName(const QString& dataFile);
+
+  // Reads a checkpoint file, returns false if there is no valid checkpoint.
+  static bool
+  readCheckpoint(const QString& dataFile, QByteArray& doc, int& commands);
 };
 }
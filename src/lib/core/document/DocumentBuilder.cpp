@@ -187,9 +187,19 @@ Document* DocumentBuilder::restoreDocument(
     doclist.push_back(doc);
 
     // We restore the pre-crash command stack.
+    // The first commands are already applied if the model comes from a checkpoint:
+    // they only go back in the undo stack.
+    int skip = restore.checkpoint.isEmpty() ? 0 : restore.checkpointCommands;
     DataStream::Deserializer writer(restore.commands);
     loadCommandStack(
-        ctx.components, writer, doc->commandStack(), [doc](score::Command* cmd) {
+        ctx.components, writer, doc->commandStack(),
+        [doc, &skip](score::Command* cmd) {
+      if(skip > 0)
+      {
+        skip--;
+        return true;
+      }
+
       try
       {
         cmd->redo(doc->context());
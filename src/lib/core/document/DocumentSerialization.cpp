@@ -41,6 +41,151 @@
 
 namespace score
 {
+namespace
+{
+/**
+ * Binary documents (.scorebin, crash backups) are a table of contents
+ * followed by independent chunks:
+ *
+ *   "SCOREBIN", version, number of chunks
+ *   for each chunk: kind, offset, size, SHA-512 of the chunk
+ *   the chunks, the offsets being relative to the end of the table
+ *
+ * The layout of the table entries never changes, so that a reader can
+ * always find the Version chunk, which names the release that wrote the file,
+ * even when the format version is too recent for it.
+ *
+ * The chunks are deserialized in place from the mapped file, and the
+ * processes they contain are read in place too, see
+ * DataStreamWriter::readByteArrayInPlace. The whole document model is still a
+ * single chunk: the processes are QObjects needed by the presenters and the
+ * execution as soon as the document is open, so they are neither split in
+ * separate chunks nor loaded lazily.
+ *
+ * Documents saved before this format, which start directly with the
+ * document data, can still be loaded. Releases older than this format cannot
+ * open the new files: they report them as invalid, and the JSON .score
+ * format has to be used to exchange documents with them.
+ */
+constexpr char binaryMagic[8] = {'S', 'C', 'O', 'R', 'E', 'B', 'I', 'N'};
+constexpr quint32 binaryVersion = 2;
+
+enum class BinaryChunk : quint32
+{
+  Document = 1,
+  Plugin = 2,
+  Version = 3
+};
+
+[[noreturn]] void invalidBinary(const QString& reason)
+{
+  throw std::runtime_error(
+      QObject::tr("The file is corrupted and cannot be loaded: %1.")
+          .arg(reason)
+          .toStdString());
+}
+
+void readBinaryChunks(
+    const QByteArray& data, QByteArray& doc, std::vector<QByteArray>& plugins)
+{
+  QDataStream s{data};
+  s.skipRawData(sizeof(binaryMagic));
+
+  quint32 version{}, count{};
+  s >> version >> count;
+
+  struct entry
+  {
+    quint32 kind{};
+    quint64 offset{};
+    quint64 size{};
+    QByteArray hash;
+  };
+
+  std::vector<entry> toc;
+  for(quint32 i = 0; i < count && s.status() == QDataStream::Ok; i++)
+  {
+    auto& e = toc.emplace_back();
+    s >> e.kind >> e.offset >> e.size >> e.hash;
+  }
+  if(s.status() != QDataStream::Ok)
+    invalidBinary(QObject::tr("truncated table of contents"));
+
+  const quint64 start = s.device()->pos();
+  const quint64 available = data.size() - start;
+  auto chunk_at = [&](const entry& e) {
+    if(e.offset > available || e.size > available - e.offset)
+      invalidBinary(QObject::tr("a chunk is outside of the file"));
+    return QByteArray::fromRawData(data.constData() + start + e.offset, e.size);
+  };
+
+  if(version > binaryVersion)
+  {
+    QString writer = QObject::tr("a newer version of score");
+    for(const auto& e : toc)
+      if(BinaryChunk(e.kind) == BinaryChunk::Version)
+        writer = QStringLiteral("score ") + QString::fromUtf8(chunk_at(e));
+
+    throw std::runtime_error(
+        QObject::tr("This file was saved by %1 in the binary format version %2, "
+                    "which score %3 cannot read.\n"
+                    "Update score, or save the document as .score with %1.")
+            .arg(writer)
+            .arg(version)
+            .arg(QString::fromUtf8(SCORE_TAG_NO_V))
+            .toStdString());
+  }
+
+  bool has_document = false;
+  for(const auto& e : toc)
+  {
+    auto chunk = chunk_at(e);
+    if(QCryptographicHash::hash(chunk, QCryptographicHash::Algorithm::Sha512)
+       != e.hash)
+      invalidBinary(QObject::tr("checksum mismatch"));
+
+    switch(BinaryChunk(e.kind))
+    {
+      case BinaryChunk::Document:
+        doc = chunk;
+        has_document = true;
+        break;
+      case BinaryChunk::Plugin:
+        plugins.push_back(chunk);
+        break;
+      default:
+        // Version, and chunks added in later versions
+        break;
+    }
+  }
+
+  if(!has_document)
+    invalidBinary(QObject::tr("no document chunk"));
+}
+
+void readLegacyBinary(
+    const QByteArray& data, QByteArray& doc, std::vector<QByteArray>& plugins)
+{
+  QVector<QPair<QByteArray, QByteArray>> documentPluginModels;
+  QByteArray hash;
+
+  QDataStream wr{data};
+  wr >> doc >> documentPluginModels >> hash;
+
+  // Perform hash verification
+  QByteArray verif_arr;
+  QDataStream writer(&verif_arr, QIODevice::WriteOnly);
+  writer << doc << documentPluginModels;
+  if(QCryptographicHash::hash(verif_arr, QCryptographicHash::Algorithm::Sha512) != hash)
+  {
+    invalidBinary(QObject::tr("checksum mismatch"));
+  }
+
+  for(const auto& plugin : documentPluginModels)
+    plugins.push_back(plugin.first);
+}
+}
+
 QByteArray Document::saveDocumentModelAsByteArray()
 {
   // TODO refactor this
@@ -100,47 +245,55 @@ void Document::saveAsJson(JSONObject::Serializer& writer)
 }
 
 QByteArray Document::saveAsByteArray()
+{
+  auto global = serializeAsByteArray();
+
+  // Indicate in the stack that the current position is saved
+  m_commandStack.markCurrentIndexAsSaved();
+  return global;
+}
+
+QByteArray Document::serializeAsByteArray()
 {
   using namespace std;
-  QByteArray global;
-  QDataStream writer(&global, QIODevice::WriteOnly);
 
   // Save the document
-  auto docByteArray = saveDocumentModelAsByteArray();
+  std::vector<std::pair<BinaryChunk, QByteArray>> chunks;
+  chunks.emplace_back(BinaryChunk::Version, QByteArrayLiteral(SCORE_TAG_NO_V));
+  chunks.emplace_back(BinaryChunk::Document, saveDocumentModelAsByteArray());
 
   // Save the document plug-ins
-  QVector<QPair<QByteArray, QByteArray>> documentPluginModels;
-
   for(const auto& plugin : model().pluginModels())
   {
     if(auto serializable_plugin = qobject_cast<SerializableDocumentPlugin*>(plugin))
     {
-      //static_assert(
-      //    is_identified_object<SerializableDocumentPlugin>::value, "");
-      //static_assert(
-      //    (is_identified_object<SerializableDocumentPlugin>::value
-      //     && !is_entity<SerializableDocumentPlugin>::value
-      //     && abstract_base<SerializableDocumentPlugin>
-      //     && !is_custom_serialized<SerializableDocumentPlugin>::value),
-      //    "");
       static_assert(
           (abstract_base<SerializableDocumentPlugin>
            && !is_custom_serialized<SerializableDocumentPlugin>::value),
           "");
-      QByteArray arr_before, arr_after;
-      DataStream::Serializer s_before{&arr_before};
-      s_before.readFrom(*serializable_plugin);
-      documentPluginModels.push_back({std::move(arr_before), std::move(arr_after)});
+      QByteArray arr;
+      DataStream::Serializer s{&arr};
+      s.readFrom(*serializable_plugin);
+      chunks.emplace_back(BinaryChunk::Plugin, std::move(arr));
     }
   }
 
-  writer << docByteArray << documentPluginModels;
+  QByteArray global;
+  QDataStream writer(&global, QIODevice::WriteOnly);
+  writer.writeRawData(binaryMagic, sizeof(binaryMagic));
+  writer << binaryVersion << quint32(chunks.size());
 
-  auto hash = QCryptographicHash::hash(global, QCryptographicHash::Algorithm::Sha512);
-  writer << hash;
+  quint64 offset = 0;
+  for(const auto& [kind, data] : chunks)
+  {
+    writer << quint32(kind) << offset << quint64(data.size())
+           << QCryptographicHash::hash(data, QCryptographicHash::Algorithm::Sha512);
+    offset += data.size();
+  }
+
+  for(const auto& [kind, data] : chunks)
+    writer.writeRawData(data.constData(), data.size());
 
-  // Indicate in the stack that the current position is saved
-  m_commandStack.markCurrentIndexAsSaved();
   return global;
 }
 
@@ -194,7 +347,9 @@ Document::Document(
     , m_context{*this}
     , m_initialData{data}
 {
-  restoreModel(data.doc, factory);
+  // The commands contained in the checkpoint are not replayed, see
+  // DocumentBuilder::restoreDocument
+  restoreModel(data.checkpoint.isEmpty() ? data.doc : data.checkpoint, factory);
 
   if(parentview)
   {
@@ -300,20 +455,11 @@ void DocumentModel::loadDocumentAsByteArray(
 {
   // Deserialize the first parts
   QByteArray doc;
-  QVector<QPair<QByteArray, QByteArray>> documentPluginModels;
-  QByteArray hash;
-
-  QDataStream wr{data};
-  wr >> doc >> documentPluginModels >> hash;
-
-  // Perform hash verification
-  QByteArray verif_arr;
-  QDataStream writer(&verif_arr, QIODevice::WriteOnly);
-  writer << doc << documentPluginModels;
-  if(QCryptographicHash::hash(verif_arr, QCryptographicHash::Algorithm::Sha512) != hash)
-  {
-    throw std::runtime_error("Invalid file.");
-  }
+  std::vector<QByteArray> documentPluginModels;
+  if(data.startsWith(QByteArray::fromRawData(binaryMagic, sizeof(binaryMagic))))
+    readBinaryChunks(data, doc, documentPluginModels);
+  else
+    readLegacyBinary(data, doc, documentPluginModels);
 
   // Set the id
 
@@ -326,16 +472,14 @@ void DocumentModel::loadDocumentAsByteArray(
   // in order to be deserialized. (e.g. the groups for the network)
   // First load the plugin models
 
-  const auto plug_n = documentPluginModels.size();
+  const int plug_n = documentPluginModels.size();
 
   auto& plugin_factories = ctx.app.interfaces<DocumentPluginFactoryList>();
   std::vector<score::DocumentPlugin*> docs(plug_n, nullptr);
 
   for(int i = 0; i < plug_n; i++)
   {
-    const auto& plugin_raw = documentPluginModels[i];
-
-    DataStream::Deserializer plug_writer{plugin_raw.first};
+    DataStream::Deserializer plug_writer{documentPluginModels[i]};
     auto plug = deserialize_interface(plugin_factories, plug_writer, ctx, this);
 
     qDebug() << plug;
@@ -726,6 +726,7 @@ void DocumentManager::restoreDocuments(const score::GUIApplicationContext& ctx)
     for(auto& doc : prev_docs)
     {
       QFile{doc.docPath}.remove();
+      QFile{DocumentBackups::checkpointFileName(doc.docPath)}.remove();
       QFile{doc.commandsPath}.remove();
     }
     QSettings s{score::OpenDocumentsFile::path(), QSettings::IniFormat};
@@ -153,6 +153,10 @@ QObject* ObjectPath::find_impl(const score::DocumentContext& ctx) const
   QObject* obj = &ctx.document.model();
   SCORE_ASSERT(obj);
 
+  auto& cache = ctx.document.pathCache();
+  if(auto cached = cache.find(*this, obj))
+    return cached;
+
   for(const auto& currentObjIdentifier : m_objectIdentifiers)
   {
     const QObjectList& children = obj->children();
@@ -188,6 +192,7 @@ QObject* ObjectPath::find_impl(const score::DocumentContext& ctx) const
     }
   }
 
+  cache.insert(*this, obj);
   return obj;
 }
 
@@ -196,6 +201,10 @@ QObject* ObjectPath::find_impl_unsafe(const score::DocumentContext& ctx) const n
   using namespace score;
   QObject* obj = &ctx.document.model();
 
+  auto& cache = ctx.document.pathCache();
+  if(auto cached = cache.find(*this, obj))
+    return cached;
+
   for(const auto& currentObjIdentifier : m_objectIdentifiers)
   {
     const QObjectList& children = obj->children();
@@ -225,6 +234,7 @@ QObject* ObjectPath::find_impl_unsafe(const score::DocumentContext& ctx) const n
     }
   }
 
+  cache.insert(*this, obj);
   return obj;
 }
 
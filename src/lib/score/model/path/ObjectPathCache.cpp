@@ -0,0 +1,66 @@
+#include "ObjectPathCache.hpp"
+
+#include <score/model/IdentifiedObjectAbstract.hpp>
+
+#include <algorithm>
+
+namespace score
+{
+QObject* ObjectPathCache::find(const ObjectPath& path, const QObject* root) noexcept
+{
+  auto it = m_objects.find(path);
+  if(it == m_objects.end())
+    return nullptr;
+
+  QObject* obj = it->second.data();
+  if(!obj)
+  {
+    m_objects.erase(it);
+    return nullptr;
+  }
+
+  // Check that the object is still at the end of the path
+  const auto& ids = path.vec();
+  const QObject* cur = obj;
+  for(auto id_it = ids.rbegin(); id_it != ids.rend(); ++id_it)
+  {
+    if(!cur || cur->objectName() != id_it->objectName())
+      return nullptr;
+
+    auto itf = qobject_cast<const IdentifiedObjectAbstract*>(cur);
+    if(!itf || itf->id_val() != id_it->id())
+      return nullptr;
+
+    cur = cur->parent();
+  }
+
+  return cur == root ? obj : nullptr;
+}
+
+void ObjectPathCache::insert(const ObjectPath& path, QObject* obj)
+{
+  if(m_objects.size() >= m_purgeSize)
+    purge();
+
+  m_objects[path] = obj;
+}
+
+void ObjectPathCache::clear() noexcept
+{
+  m_objects.clear();
+}
+
+void ObjectPathCache::purge() noexcept
+{
+  // Drop the entries of the objects which were deleted since
+  for(auto it = m_objects.begin(); it != m_objects.end();)
+  {
+    if(it->second.isNull())
+      it = m_objects.erase(it);
+    else
+      ++it;
+  }
+
+  m_purgeSize = std::max(std::size_t(1024), 2 * m_objects.size());
+}
+}
@@ -0,0 +1,38 @@
+#pragma once
+#include <score/model/path/ObjectPath.hpp>
+#include <score/tools/std/HashMap.hpp>
+
+#include <QPointer>
+
+#include <score_lib_base_export.h>
+
+namespace score
+{
+/**
+ * @brief Objects of a document already found through an ObjectPath.
+ *
+ * Finding an object from its path goes through all the children of each
+ * level of the hierarchy. Resolving a path already seen instead checks that
+ * the cached object is still at this place, by going up its parents: this
+ * only costs the depth of the path.
+ *
+ * The entries are QPointers: removing an object from its EntityMap deletes
+ * it, which invalidates the entry. Adding objects cannot make an entry wrong.
+ *
+ * Only used from the GUI thread.
+ */
+class SCORE_LIB_BASE_EXPORT ObjectPathCache
+{
+public:
+  //! Returns nullptr if the path is not in the cache or the object moved
+  QObject* find(const ObjectPath& path, const QObject* root) noexcept;
+  void insert(const ObjectPath& path, QObject* obj);
+  void clear() noexcept;
+
+private:
+  void purge() noexcept;
+
+  score::hash_map<ObjectPath, QPointer<QObject>> m_objects;
+  std::size_t m_purgeSize{1024};
+};
+}
@@ -4,8 +4,7 @@
 template <typename T, typename... Args>
 auto deserialize_known_interface(DataStream::Deserializer& des, Args&&... args) -> T*
 {
-  QByteArray b;
-  des.stream() >> b;
+  const QByteArray b = des.readByteArrayInPlace();
   DataStream::Deserializer sub{b};
 
   // Deserialize the interface identifier
@@ -31,8 +30,7 @@ auto deserialize_known_interface(DataStream::Deserializer& des, Args&&... args)
 template <typename T, typename... Args>
 auto deserialize_known_interface(DataStream::Deserializer&& des, Args&&... args) -> T*
 {
-  QByteArray b;
-  des.stream() >> b;
+  const QByteArray b = des.readByteArrayInPlace();
   DataStream::Deserializer sub{b};
 
   // Deserialize the interface identifier
@@ -20,8 +20,7 @@ auto deserialize_interface(
     const FactoryList_T& factories, DataStream::Deserializer& des, Args&&... args) ->
     typename FactoryList_T::object_type*
 {
-  QByteArray b;
-  des.stream() >> b;
+  const QByteArray b = des.readByteArrayInPlace();
   DataStream::Deserializer sub{b};
 
   // Deserialize the interface identifier
@@ -58,8 +57,7 @@ auto deserialize_interface(
     const FactoryList_T& factories, DataStream::Deserializer&& des, Args&&... args) ->
     typename FactoryList_T::object_type*
 {
-  QByteArray b;
-  des.stream() >> b;
+  const QByteArray b = des.readByteArrayInPlace();
   DataStream::Deserializer sub{b};
 
   // Deserialize the interface identifier
@@ -4,6 +4,7 @@
 
 #include <score/application/ApplicationContext.hpp>
 
+#include <QBuffer>
 #include <QIODevice>
 
 #include <stdexcept>
@@ -44,6 +45,33 @@ DataStreamWriter::DataStreamWriter(QIODevice* dev)
 {
 }
 
+QByteArray DataStreamWriter::readByteArrayInPlace()
+{
+  auto& s = m_stream_impl;
+  if(auto buf = qobject_cast<QBuffer*>(s.device()))
+  {
+    const qint64 pos = buf->pos();
+    quint32 len{};
+    s >> len;
+
+    // Null and very large arrays have a different encoding
+    if(s.status() == QDataStream::Ok && len < 0xfffffffe
+       && pos + 4 + qint64(len) <= buf->size())
+    {
+      const char* data = buf->data().constData() + pos + 4;
+      s.skipRawData(len);
+      return QByteArray::fromRawData(data, len);
+    }
+
+    buf->seek(pos);
+    s.resetStatus();
+  }
+
+  QByteArray b;
+  s >> b;
+  return b;
+}
+
 void DataStreamWriter::checkDelimiter()
 {
   int val{};
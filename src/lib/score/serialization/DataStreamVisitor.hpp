@@ -230,6 +230,15 @@ public:
 
   void writeTo(QByteArray& obj) { m_stream_impl >> obj; }
 
+  /**
+   * @brief Reads a QByteArray without copying it when possible.
+   *
+   * Unlike writeTo, the result may refer to the data being deserialized:
+   * it must not outlive it. Used for the nested blobs of polymorphic objects,
+   * which would otherwise be copied once per level of nesting.
+   */
+  QByteArray readByteArrayInPlace();
+
   template <typename T>
   void writeTo(T& obj)
   {
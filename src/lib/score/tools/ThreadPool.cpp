@@ -1,6 +1,7 @@
 #include <score/application/ApplicationServices.hpp>
 #include <score/tools/ThreadPool.hpp>
 
+#include <algorithm>
 #include <thread>
 #if __has_include(<sys/resource.h>)
 #include <sys/resource.h>
@@ -87,22 +88,26 @@ void ThreadPool::releaseThread()
   }
 }
 
+namespace
+{
+// Index of the worker running on the current thread, if any
+thread_local std::size_t g_currentWorker = std::size_t(-1);
+}
+
 TaskPool::TaskPool()
 {
+  const int n = std::max(1, int(std::thread::hardware_concurrency()));
+  m_workers.reserve(n);
+  for(int i = 0; i < n; i++)
+    m_workers.push_back(std::make_unique<worker>());
+
   m_running = true;
-  int i = 0;
-  for(auto& t : m_threads)
+  for(std::size_t i = 0; i < m_workers.size(); i++)
   {
-    t = std::thread{[this, i = i++] {
+    m_workers[i]->thread = std::thread{[this, i] {
       ossia::set_thread_name("ossia task " + std::to_string(i));
-      while(m_running)
-      {
-        task t{};
-        if(m_queue.wait_dequeue_timed(t, 100000))
-        {
-          t();
-        }
-      }
+      g_currentWorker = i;
+      run(i);
     }};
   }
 }
@@ -110,9 +115,83 @@ TaskPool::TaskPool()
 TaskPool::~TaskPool()
 {
   m_running = false;
-  for(auto& t : m_threads)
+  m_sleep.signal(m_workers.size());
+
+  for(auto& w : m_workers)
+  {
+    w->thread.join();
+  }
+}
+
+void TaskPool::push(item&& t, TaskPriority prio)
+{
+  const std::size_t idx = g_currentWorker;
+  if(idx < m_workers.size())
+  {
+    auto& w = *m_workers[idx];
+    std::lock_guard lck{w.mutex};
+    w.queues[std::size_t(prio)].push_back(std::move(t));
+  }
+  else
+  {
+    // May be the audio thread: neither locks nor waits
+    m_injected[std::size_t(prio)].enqueue(std::move(t));
+  }
+
+  m_pending.fetch_add(1, std::memory_order_release);
+  m_sleep.signal();
+}
+
+bool TaskPool::pop(std::size_t self, item& t)
+{
+  const std::size_t n = m_workers.size();
+  for(std::size_t prio = 0; prio < 3; prio++)
+  {
+    // Our own queue first, oldest task first, then the other workers' ones
+    for(std::size_t k = 0; k < n; k++)
+    {
+      auto& w = *m_workers[(self + k) % n];
+      std::unique_lock lck{w.mutex, std::try_to_lock};
+      if(!lck.owns_lock())
+      {
+        if(k != 0)
+          continue;
+        lck.lock();
+      }
+
+      auto& q = w.queues[prio];
+      if(!q.empty())
+      {
+        t = std::move(q.front());
+        q.pop_front();
+        return true;
+      }
+
+      if(k == 0 && m_injected[prio].try_dequeue(t))
+        return true;
+    }
+  }
+  return false;
+}
+
+void TaskPool::run(std::size_t self)
+{
+  while(m_running)
   {
-    t.join();
+    item t;
+    if(pop(self, t))
+    {
+      m_pending.fetch_sub(1, std::memory_order_relaxed);
+      if(!t.token || !t.token->cancelled())
+        t.func();
+    }
+    else
+    {
+      // Queues which were locked by another worker were skipped:
+      // only sleep when no task at all is pending
+      if(m_pending.load(std::memory_order_acquire) == 0)
+        m_sleep.wait(100000);
+    }
   }
 }
 
@@ -123,4 +202,48 @@ TaskPool& TaskPool::instance()
   return *score::AppServices().taskpool;
 }
 
+struct TaskStrand::state : std::enable_shared_from_this<state>
+{
+  // Preallocated so that posting from the audio thread does not allocate
+  moodycamel::ConcurrentQueue<TaskPool::task> queue{64};
+  TaskPriority prio{};
+
+  // Number of tasks queued or running: the strand is scheduled in the
+  // pool while it is not zero
+  std::atomic_int pending{};
+
+  void schedule()
+  {
+    TaskPool::instance().post([self = shared_from_this()] { self->runOne(); }, prio);
+  }
+
+  void runOne()
+  {
+    // The push that counted this task may not be visible to us yet
+    TaskPool::task t;
+    while(!queue.try_dequeue(t))
+      std::this_thread::yield();
+
+    t();
+
+    // One task at a time, so that the other strands get their turn
+    if(pending.fetch_sub(1, std::memory_order_acq_rel) > 1)
+      schedule();
+  }
+};
+
+TaskStrand::TaskStrand(TaskPriority prio)
+    : m_state{std::make_shared<state>()}
+{
+  m_state->prio = prio;
+}
+
+void TaskStrand::push(TaskPool::task&& t) const
+{
+  auto& s = *m_state;
+  s.queue.enqueue(std::move(t));
+  if(s.pending.fetch_add(1, std::memory_order_acq_rel) == 0)
+    s.schedule();
+}
+
 }
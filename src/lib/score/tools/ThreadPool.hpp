@@ -1,13 +1,23 @@
 #pragma once
 #include <QAbstractEventDispatcher>
+#include <QCoreApplication>
+#include <QPointer>
 #include <QThread>
 
-#include <blockingconcurrentqueue.h>
+#include <concurrentqueue.h>
+#include <lightweightsemaphore.h>
 #include <score_lib_base_export.h>
 #include <smallfun.hpp>
 
+#include <array>
+#include <atomic>
+#include <deque>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <thread>
+#include <type_traits>
+#include <vector>
 namespace score
 {
 class SCORE_LIB_BASE_EXPORT ThreadPool
@@ -29,6 +39,47 @@ private:
   int m_inFlight = 0;
 };
 
+enum class TaskPriority : int8_t
+{
+  //! Work that the user is waiting for, e.g. what is visible on screen
+  Interactive,
+  Background,
+  //! Only runs when there is nothing else to do
+  Idle
+};
+
+/**
+ * @brief Shared flag used to cancel tasks which have not started yet.
+ *
+ * Long-running tasks can also check it regularly to stop early.
+ */
+class CancellationToken
+{
+public:
+  CancellationToken()
+      : m_flag{std::make_shared<std::atomic_bool>(false)}
+  {
+  }
+
+  void cancel() const noexcept { m_flag->store(true, std::memory_order_release); }
+  bool cancelled() const noexcept { return m_flag->load(std::memory_order_acquire); }
+
+private:
+  std::shared_ptr<std::atomic_bool> m_flag;
+};
+
+/**
+ * @brief Pool of worker threads for short background tasks.
+ *
+ * There is one worker per core. Each worker has its own queues for the
+ * tasks posted from it. Tasks posted from other threads go to lock-free
+ * queues shared by all the workers, so that posting from the audio thread
+ * never takes a lock. Idle workers steal tasks from the other ones.
+ *
+ * All the Interactive tasks are run before the Background ones, which
+ * are run before the Idle ones. Tasks of a same priority are not
+ * guaranteed to run in order: use a TaskStrand for that.
+ */
 class SCORE_LIB_BASE_EXPORT TaskPool
 {
 public:
@@ -37,12 +88,64 @@ public:
   static TaskPool& instance();
 
   template <typename F>
-  void post(F&& func)
+  void post(F&& func, TaskPriority prio = TaskPriority::Background)
   {
-    m_queue.enqueue(std::forward<F>(func));
+    push(item{task{std::forward<F>(func)}, {}}, prio);
   }
 
-private:
+  //! The task is dropped if the token is cancelled before it starts
+  template <typename F>
+  void post(const CancellationToken& token, F&& func,
+            TaskPriority prio = TaskPriority::Background)
+  {
+    push(item{task{std::forward<F>(func)}, token}, prio);
+  }
+
+  /**
+   * @brief Runs func in the pool then passes its result to cont in the GUI thread.
+   *
+   * cont is not called if ctx has been deleted in the meantime: func must
+   * not depend on ctx.
+   */
+  template <typename F, typename C>
+  void post(QObject* ctx, F&& func, C&& cont,
+            TaskPriority prio = TaskPriority::Background)
+  {
+    using result_type = std::invoke_result_t<std::decay_t<F>&>;
+
+    // Stored on the heap as the two functions may not fit in a task.
+    // The QPointer is only read in the GUI thread.
+    struct state
+    {
+      QPointer<QObject> ctx;
+      std::decay_t<F> func;
+      std::decay_t<C> cont;
+    };
+    auto st = std::make_shared<state>(
+        state{ctx, std::forward<F>(func), std::forward<C>(cont)});
+    auto run = [st] {
+      if constexpr(std::is_void_v<result_type>)
+      {
+        st->func();
+        QMetaObject::invokeMethod(qApp, [st] {
+          if(st->ctx)
+            st->cont();
+        });
+      }
+      else
+      {
+        auto res = std::make_shared<std::decay_t<result_type>>(st->func());
+        QMetaObject::invokeMethod(qApp, [st, res] {
+          if(st->ctx)
+            st->cont(std::move(*res));
+        });
+      }
+    };
+    post(std::move(run), prio);
+  }
+
+  int threads() const noexcept { return m_workers.size(); }
+
   using task = smallfun::function<
       void(),
 #if defined(_MSC_VER) && !defined(NDEBUG)
@@ -52,8 +155,58 @@ private:
 #endif
       std::max((int)8, (int)std::max(alignof(std::function<void()>), alignof(double))),
       smallfun::Methods::Move>;
-  moodycamel::BlockingConcurrentQueue<task> m_queue;
-  std::array<std::thread, 1> m_threads;
+
+private:
+  struct item
+  {
+    task func;
+    std::optional<CancellationToken> token;
+  };
+
+  struct worker
+  {
+    std::mutex mutex;
+    std::array<std::deque<item>, 3> queues;
+    std::thread thread;
+  };
+
+  void push(item&& t, TaskPriority prio);
+  bool pop(std::size_t self, item& t);
+  void run(std::size_t self);
+
+  std::vector<std::unique_ptr<worker>> m_workers;
+  std::array<moodycamel::ConcurrentQueue<item>, 3> m_injected;
+
+  moodycamel::LightweightSemaphore m_sleep;
+  std::atomic_int m_pending{};
   std::atomic_bool m_running{};
 };
+
+/**
+ * @brief Runs tasks on the TaskPool one at a time, in the order they are posted.
+ *
+ * For work which must not run concurrently or out of order, e.g. the
+ * requests of a same plug-in instance. Copies share the same queue, and
+ * the queued tasks still run once every copy is destroyed.
+ *
+ * post() is lock-free so that it can be called from the audio thread.
+ * Tasks posted from different threads have no defined relative order.
+ */
+class SCORE_LIB_BASE_EXPORT TaskStrand
+{
+public:
+  explicit TaskStrand(TaskPriority prio = TaskPriority::Background);
+
+  template <typename F>
+  void post(F&& func) const
+  {
+    push(TaskPool::task{std::forward<F>(func)});
+  }
+
+private:
+  struct state;
+  void push(TaskPool::task&& t) const;
+
+  std::shared_ptr<state> m_state;
+};
 }
@@ -0,0 +1,156 @@
+#pragma once
+#include <score/tools/Debug.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+namespace Execution
+{
+/**
+ * @brief Runs a DSP which only processes fixed-size blocks with any host buffer size.
+ *
+ * When the host buffer size is a multiple of the block size, the blocks are
+ * aligned on the host buffers and processed directly during each call: there
+ * is no latency. A call which does not cover a whole block, e.g. when a
+ * process starts in the middle of a buffer, processes the block anyway, with
+ * zeros for the missing input:
+ * - before the call, this only shifts the DSP by less than a block;
+ * - after the call, the surplus output is kept and given back during the next
+ *   call, so that the DSP stays in time with the host. The input of the next
+ *   call for these samples is then not heard by the DSP.
+ *
+ * Otherwise, the host samples are accumulated in one block per channel. Once a
+ * block is full, it is processed, and its output is given back to the host
+ * during the following calls: the output is delayed by exactly latency() samples.
+ *
+ * The blocks are contiguous and non-interleaved: channel i starts at
+ * i * blockSize(), as expected for instance by libpd_process_raw.
+ * Nothing is allocated outside of reset().
+ */
+template <typename T>
+class BlockAdapter
+{
+public:
+  void reset(
+      std::size_t inputs, std::size_t outputs, std::size_t block,
+      std::size_t bufferSize)
+  {
+    SCORE_ASSERT(block > 0);
+    m_inputs = inputs;
+    m_outputs = outputs;
+    m_block = block;
+    m_fill = 0;
+    m_carry = 0;
+    m_direct = bufferSize > 0 && bufferSize % block == 0;
+    m_in.assign(inputs * block, T{});
+    m_out.assign(outputs * block, T{});
+  }
+
+  std::size_t blockSize() const noexcept { return m_block; }
+  std::size_t latency() const noexcept { return m_direct ? 0 : m_block; }
+
+  /**
+   * @param in One pointer per input channel, nullptr meaning silence
+   * @param out One pointer per output channel
+   * @param offset Position of the first frame in the host buffer
+   * @param dsp Called as dsp(T* in, T* out) for each block processed during the call
+   */
+  template <typename In, typename Out, typename F>
+  void process(
+      const In* const* in, Out* const* out, std::size_t offset, std::size_t frames,
+      F&& dsp)
+  {
+    if(m_direct)
+      processDirect(in, out, offset, frames, dsp);
+    else
+      processDelayed(in, out, frames, dsp);
+  }
+
+private:
+  template <typename In>
+  void copyInput(const In* const* in, std::size_t done, std::size_t pos, std::size_t n)
+  {
+    for(std::size_t c = 0; c < m_inputs; c++)
+    {
+      T* block = m_in.data() + c * m_block + pos;
+      if(in[c])
+        std::copy_n(in[c] + done, n, block);
+      else
+        std::fill_n(block, n, T{});
+    }
+  }
+
+  template <typename Out>
+  void copyOutput(Out* const* out, std::size_t done, std::size_t pos, std::size_t n)
+  {
+    for(std::size_t c = 0; c < m_outputs; c++)
+      std::copy_n(m_out.data() + c * m_block + pos, n, out[c] + done);
+  }
+
+  template <typename In, typename Out, typename F>
+  void processDirect(
+      const In* const* in, Out* const* out, std::size_t offset, std::size_t frames,
+      F& dsp)
+  {
+    std::size_t done = 0;
+    while(done < frames)
+    {
+      const std::size_t pos = (offset + done) % m_block;
+      const std::size_t n = std::min(frames - done, m_block - pos);
+
+      // The block was processed at the end of the previous call
+      if(m_carry > 0 && pos == m_block - m_carry)
+      {
+        copyOutput(out, done, pos, n);
+        m_carry -= n;
+        done += n;
+        continue;
+      }
+
+      m_carry = 0;
+      for(std::size_t c = 0; c < m_inputs; c++)
+      {
+        T* block = m_in.data() + c * m_block;
+        std::fill_n(block, pos, T{});
+        std::fill_n(block + pos + n, m_block - pos - n, T{});
+      }
+      copyInput(in, done, pos, n);
+
+      dsp(m_in.data(), m_out.data());
+
+      copyOutput(out, done, pos, n);
+      m_carry = m_block - pos - n;
+      done += n;
+    }
+  }
+
+  template <typename In, typename Out, typename F>
+  void processDelayed(const In* const* in, Out* const* out, std::size_t frames, F& dsp)
+  {
+    std::size_t done = 0;
+    while(done < frames)
+    {
+      const std::size_t n = std::min(frames - done, m_block - m_fill);
+      copyInput(in, done, m_fill, n);
+      copyOutput(out, done, m_fill, n);
+
+      m_fill += n;
+      done += n;
+      if(m_fill == m_block)
+      {
+        dsp(m_in.data(), m_out.data());
+        m_fill = 0;
+      }
+    }
+  }
+
+  std::vector<T> m_in, m_out;
+  std::size_t m_inputs{};
+  std::size_t m_outputs{};
+  std::size_t m_block{};
+  std::size_t m_fill{};
+  std::size_t m_carry{};
+  bool m_direct{};
+};
+}
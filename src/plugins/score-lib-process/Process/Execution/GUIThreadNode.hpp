@@ -0,0 +1,31 @@
+#pragma once
+#include <ossia/dataflow/graph_node.hpp>
+
+#include <QCoreApplication>
+#include <QThread>
+
+#include <memory>
+
+namespace Execution
+{
+/**
+ * @brief Creates a graph node which is always destroyed on the GUI thread.
+ *
+ * The last reference to a node is usually dropped by the GarbageCollector
+ * thread. Nodes owning objects with a thread affinity, such as QObjects,
+ * must be created with this instead of ossia::make_node.
+ */
+template <typename T, typename... Args>
+std::shared_ptr<T> make_gui_thread_node(const ossia::execution_state& st, Args&&... args)
+{
+  std::shared_ptr<T> n{new T(std::forward<Args>(args)...), [](T* node) {
+    auto app = QCoreApplication::instance();
+    if(!app || QThread::currentThread() == app->thread())
+      delete node;
+    else
+      QMetaObject::invokeMethod(app, [node] { delete node; }, Qt::QueuedConnection);
+  }};
+  n->prepare(st);
+  return n;
+}
+}
@@ -65,6 +65,9 @@ public:
   virtual void cleanup();
   virtual void stop() { process().stopExecution(); }
 
+  //! Samples by which the node delays its audio output, not compensated by the graph
+  virtual std::size_t latency() const noexcept { return 0; }
+
   const std::shared_ptr<ossia::time_process>& OSSIAProcessPtr()
   {
     return m_ossia_process;
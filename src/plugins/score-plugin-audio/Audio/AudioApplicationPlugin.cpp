@@ -7,6 +7,7 @@
 #include <Audio/AudioDevice.hpp>
 #include <Audio/AudioInterface.hpp>
 #include <Audio/AudioTick.hpp>
+#include <Audio/DummyInterface.hpp>
 #include <Audio/Settings/Model.hpp>
 
 #include <score/actions/ActionManager.hpp>
@@ -37,6 +38,15 @@ void ApplicationPlugin::initialize()
 {
   auto& set = context.settings<Audio::Settings::Model>();
 
+  // Offline benchmarks never touch the sound card: the settings are only
+  // overridden for this session and are not saved.
+  if(const auto& app_set = context.applicationSettings; !app_set.benchmark.isEmpty())
+  {
+    set.initDriver(Audio::DummyFactory::static_concreteKey());
+    set.initBufferSize(app_set.benchmarkBufferSize);
+    set.initRate(app_set.benchmarkRate);
+  }
+
   // First validate the current audio settings
 
   auto& engines = score::GUIAppContext().interfaces<Audio::AudioFactoryList>();
@@ -7,6 +7,7 @@
 #include <QFile>
 
 #include <AvndProcesses/AddressTools.hpp>
+#include <AvndProcesses/DeviceRecording.hpp>
 #include <halp/audio.hpp>
 
 #include <charconv>
@@ -413,9 +414,12 @@ public:
 
 namespace avnd_tools
 {
-/** Records the input into a CSV.
+/** Records the input into a file.
  *  To record an entire device: can be a pattern expression such as foo://
- *  
+ *
+ *  Files ending in .csv are written as text, one row per line; any other
+ *  file uses the binary format of DeviceRecording.hpp, written in batches
+ *  by a thread of its own.
  *  Writing to the disk is done in a worker thread as is tradition.
  */
 struct DeviceRecorder : PatternObject
@@ -435,21 +439,33 @@ struct DeviceRecorder : PatternObject
     std::vector<ossia::net::node_base*> roots;
     std::chrono::steady_clock::time_point first_ts;
     fmt::memory_buffer buf;
+    recording::writer binary;
+    std::vector<ossia::net::parameter_base*> params;
+    std::vector<ossia::value> row;
+    bool csv{};
     bool active{};
     int num_params = 0;
 
+    ~recorder_thread() { close(); }
+
     void setActive(bool b)
     {
       active = b;
       if(!b)
-        f.close();
+        close();
       else
         reopen();
     }
 
-    void reopen()
+    void close()
     {
+      binary.close();
       f.close();
+    }
+
+    void reopen()
+    {
+      close();
 
       auto filename = QByteArray::fromStdString(this->filename);
       filename.replace("%t", QDateTime::currentDateTimeUtc().toString().toUtf8());
@@ -464,6 +480,14 @@ struct DeviceRecorder : PatternObject
       if(!f.isOpen())
         return;
 
+      first_ts = std::chrono::steady_clock::now();
+      csv = filename.endsWith(".csv");
+      if(!csv)
+      {
+        openBinary();
+        return;
+      }
+
       f.write("timestamp");
       num_params = 0;
       for(auto in : this->roots)
@@ -484,6 +508,23 @@ struct DeviceRecorder : PatternObject
       buf.reserve(512);
     }
 
+    void openBinary()
+    {
+      std::vector<recording::column_info> columns;
+      params.clear();
+      for(auto in : this->roots)
+      {
+        if(auto p = in->get_parameter())
+        {
+          params.push_back(p);
+          columns.push_back(
+              {p->get_node().osc_address(), recording::columnType(p->get_value_type())});
+        }
+      }
+      row.resize(params.size());
+      binary.open(f, columns);
+    }
+
     void write()
     {
       if(!f.isOpen())
@@ -497,6 +538,14 @@ struct DeviceRecorder : PatternObject
 
     void write(int64_t timestamp)
     {
+      if(!csv)
+      {
+        for(std::size_t i = 0; i < params.size(); i++)
+          row[i] = params[i]->value();
+        binary.write(timestamp, row);
+        return;
+      }
+
       f.write(QString::number(timestamp).toUtf8());
       for(auto in : this->roots)
       {
@@ -534,6 +583,8 @@ struct DeviceRecorder : PatternObject
     std::chrono::steady_clock::time_point first_ts;
     boost::container::flat_map<int, ossia::net::parameter_base*> m_map;
     boost::container::flat_map<int64_t, std::vector<ossia::value>> m_vec;
+    recording::reader m_binary;
+    bool binary{};
     bool active{};
     bool loops{};
     int num_params{};
@@ -542,15 +593,23 @@ struct DeviceRecorder : PatternObject
     {
       active = b;
       if(!b)
-        f.close();
+        close();
       else
         reopen();
     }
 
+    void close()
+    {
+      // Unmaps the file
+      m_binary = {};
+      binary = false;
+      f.close();
+    }
+
     void setLoops(bool b) { loops = b; }
     void reopen()
     {
-      f.close();
+      close();
 
       auto filename = QByteArray::fromStdString(this->filename);
       filename.replace("%t", QDateTime::currentDateTimeUtc().toString().toUtf8());
@@ -582,6 +641,12 @@ struct DeviceRecorder : PatternObject
       m_vec.clear();
       m_map.clear();
 
+      if(recording::reader::isRecording(data, f.size()))
+      {
+        openBinary(data, f.size());
+        return;
+      }
+
       csv2::Reader<> r;
       r.parse_view({data, data + f.size()});
       m_vec.reserve(r.rows());
@@ -664,20 +729,57 @@ struct DeviceRecorder : PatternObject
       first_ts = std::chrono::steady_clock::now();
     }
 
+    void openBinary(const char* data, std::size_t size)
+    {
+      if(!m_binary.open(data, size))
+        return;
+      binary = true;
+
+      boost::container::flat_map<std::string, ossia::net::parameter_base*> params;
+      for(auto node : roots)
+        if(auto p = node->get_parameter())
+          params[node->osc_address()] = p;
+
+      const auto& columns = m_binary.columns();
+      for(std::size_t i = 0; i < columns.size(); i++)
+        if(auto it = params.find(columns[i].address); it != params.end())
+          m_map[i] = it->second;
+
+      first_ts = std::chrono::steady_clock::now();
+    }
+
     void read()
     {
-      if(m_vec.empty())
+      int64_t last_ts{};
+      if(binary && !m_binary.empty())
+        last_ts = m_binary.lastTimestamp();
+      else if(!m_vec.empty())
+        last_ts = m_vec.rbegin()->first;
+      else
         return;
 
       using namespace std::chrono;
       auto ts = duration_cast<milliseconds>(steady_clock::now() - first_ts).count();
       if(loops)
-        ts %= m_vec.rbegin()->first + 1;
+        ts %= last_ts + 1;
       read(ts);
     }
 
     void read(int64_t timestamp)
     {
+      if(binary)
+      {
+        m_binary.row(timestamp, [this](int i, ossia::value&& v) {
+          if(auto p = m_map.find(i); p != m_map.end())
+          {
+            if(v.get_type() != p->second->get_value_type())
+              ossia::convert(v, p->second->get_value_type());
+            p->second->push_value(std::move(v));
+          }
+        });
+        return;
+      }
+
       auto it = m_vec.lower_bound(timestamp);
       if(it != m_vec.end())
       {
@@ -0,0 +1,527 @@
+#pragma once
+#include <State/Value.hpp>
+
+#include <ossia/network/value/detail/value_conversion_impl.hpp>
+
+#include <QFile>
+
+#include <algorithm>
+#include <cinttypes>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+/**
+ * Binary recording of the values of a set of parameters, used by the
+ * DeviceRecorder when the file is not a .csv.
+ *
+ * The file starts with a header describing the columns, followed by chunks
+ * which are only ever appended. Each chunk holds a batch of rows, stored
+ * column by column:
+ *
+ *   chunk_header
+ *   int64_t timestamps[rows]
+ *   for each column, the values of the rows
+ *
+ * Numbers and vectors are stored as arrays of their components. Other
+ * values (strings, lists...) are stored as text: uint32_t end offsets[rows],
+ * followed by the characters.
+ * The chunk headers form the timestamp index: a file interrupted while a
+ * chunk was being written stays readable up to the previous chunk.
+ */
+namespace avnd_tools::recording
+{
+static constexpr uint32_t file_magic = 0x5243524f;  // ORCR
+static constexpr uint32_t chunk_magic = 0x4b4e4843; // CHNK
+static constexpr uint32_t format_version = 1;
+
+enum class column_type : uint8_t
+{
+  Float,
+  Int,
+  Bool,
+  Vec2f,
+  Vec3f,
+  Vec4f,
+  Text
+};
+
+inline column_type columnType(ossia::val_type t) noexcept
+{
+  switch(t)
+  {
+    case ossia::val_type::FLOAT:
+      return column_type::Float;
+    case ossia::val_type::INT:
+      return column_type::Int;
+    case ossia::val_type::BOOL:
+      return column_type::Bool;
+    case ossia::val_type::VEC2F:
+      return column_type::Vec2f;
+    case ossia::val_type::VEC3F:
+      return column_type::Vec3f;
+    case ossia::val_type::VEC4F:
+      return column_type::Vec4f;
+    default:
+      return column_type::Text;
+  }
+}
+
+//! Bytes used by a row, 0 for variable-size columns
+inline std::size_t columnWidth(column_type t) noexcept
+{
+  switch(t)
+  {
+    case column_type::Float:
+    case column_type::Int:
+      return 4;
+    case column_type::Bool:
+      return 1;
+    case column_type::Vec2f:
+      return 8;
+    case column_type::Vec3f:
+      return 12;
+    case column_type::Vec4f:
+      return 16;
+    default:
+      return 0;
+  }
+}
+
+struct chunk_header
+{
+  uint32_t magic{chunk_magic};
+  uint32_t rows{};
+
+  //! Size of the chunk in bytes, header included
+  uint64_t size{};
+  int64_t first_ts{};
+  int64_t last_ts{};
+};
+
+template <typename T>
+inline T load(const char* ptr) noexcept
+{
+  // The mapped data has no alignment guarantee
+  T t;
+  std::memcpy(&t, ptr, sizeof(T));
+  return t;
+}
+
+struct column_info
+{
+  std::string address;
+  column_type type{};
+};
+
+/**
+ * The rows are encoded in chunks by the thread calling write(), and the
+ * chunks are appended to the file by a thread of the writer, so that the
+ * recording never waits for the disk.
+ */
+class writer
+{
+public:
+  //! Rows kept in memory before being appended to the file as a chunk
+  static constexpr uint32_t chunk_rows = 1024;
+
+  ~writer() { close(); }
+
+  //! Writes the header of a new recording in f, which must stay open until close()
+  void open(QFile& f, const std::vector<column_info>& columns)
+  {
+    close();
+    m_file = &f;
+    m_columns.clear();
+    m_timestamps.clear();
+
+    write_pod(file_magic);
+    write_pod(format_version);
+    write_pod(uint32_t(columns.size()));
+    for(const auto& col : columns)
+    {
+      write_pod(col.type);
+      write_pod(uint32_t(col.address.size()));
+      m_file->write(col.address.data(), col.address.size());
+      m_columns.push_back({col.type});
+    }
+    m_file->flush();
+
+    m_closing = false;
+    m_thread = std::thread{[this] { run(); }};
+  }
+
+  //! Appends a row, with one value per column
+  void write(int64_t timestamp, const std::vector<ossia::value>& row)
+  {
+    if(!m_file)
+      return;
+
+    m_timestamps.push_back(timestamp);
+    for(std::size_t i = 0; i < m_columns.size(); i++)
+    {
+      auto& col = m_columns[i];
+      const auto& v = row[i];
+      switch(col.type)
+      {
+        case column_type::Float:
+          append(col, ossia::convert<float>(v));
+          break;
+        case column_type::Int:
+          append(col, int32_t(ossia::convert<int>(v)));
+          break;
+        case column_type::Bool:
+          append(col, uint8_t(ossia::convert<bool>(v)));
+          break;
+        case column_type::Vec2f:
+          append(col, ossia::convert<ossia::vec2f>(v));
+          break;
+        case column_type::Vec3f:
+          append(col, ossia::convert<ossia::vec3f>(v));
+          break;
+        case column_type::Vec4f:
+          append(col, ossia::convert<ossia::vec4f>(v));
+          break;
+        case column_type::Text: {
+          m_buf.clear();
+          ossia::apply(ossia::detail::fmt_writer{m_buf}, v);
+          col.data.insert(col.data.end(), m_buf.data(), m_buf.data() + m_buf.size());
+          col.offsets.push_back(col.data.size());
+          break;
+        }
+      }
+    }
+
+    if(m_timestamps.size() >= chunk_rows)
+      flush();
+  }
+
+  //! Sends the pending rows to the writing thread as a chunk
+  void flush()
+  {
+    if(!m_file || m_timestamps.empty())
+      return;
+
+    const uint32_t rows = m_timestamps.size();
+    chunk_header header;
+    header.rows = rows;
+    header.first_ts = m_timestamps.front();
+    header.last_ts = m_timestamps.back();
+    header.size = sizeof(chunk_header) + rows * sizeof(int64_t);
+    for(auto& col : m_columns)
+      header.size += col.offsets.size() * sizeof(uint32_t) + col.data.size();
+
+    std::vector<char> chunk;
+    {
+      std::lock_guard lck{m_mutex};
+      if(!m_free.empty())
+      {
+        chunk = std::move(m_free.back());
+        m_free.pop_back();
+      }
+    }
+    chunk.clear();
+    chunk.reserve(header.size);
+
+    put(chunk, &header, 1);
+    put(chunk, m_timestamps.data(), rows);
+    for(auto& col : m_columns)
+    {
+      put(chunk, col.offsets.data(), col.offsets.size());
+      put(chunk, col.data.data(), col.data.size());
+      col.offsets.clear();
+      col.data.clear();
+    }
+    m_timestamps.clear();
+
+    {
+      std::lock_guard lck{m_mutex};
+      m_pending.push_back(std::move(chunk));
+    }
+    m_cv.notify_one();
+  }
+
+  //! Returns once all the rows are written to the file
+  void close()
+  {
+    if(!m_file)
+      return;
+
+    flush();
+    {
+      std::lock_guard lck{m_mutex};
+      m_closing = true;
+    }
+    m_cv.notify_one();
+    m_thread.join();
+    m_file = nullptr;
+  }
+
+private:
+  struct column
+  {
+    column_type type{};
+    std::vector<char> data;
+    std::vector<uint32_t> offsets;
+  };
+
+  void run()
+  {
+    std::unique_lock lck{m_mutex};
+    for(;;)
+    {
+      m_cv.wait(lck, [this] { return m_closing || !m_pending.empty(); });
+      if(m_pending.empty())
+        return;
+
+      auto chunk = std::move(m_pending.front());
+      m_pending.pop_front();
+      lck.unlock();
+
+      m_file->write(chunk.data(), chunk.size());
+      m_file->flush();
+
+      lck.lock();
+      m_free.push_back(std::move(chunk));
+    }
+  }
+
+  template <typename T>
+  static void append(column& col, const T& t)
+  {
+    const auto ptr = reinterpret_cast<const char*>(&t);
+    col.data.insert(col.data.end(), ptr, ptr + sizeof(T));
+  }
+
+  template <typename T>
+  static void put(std::vector<char>& vec, const T* t, std::size_t n)
+  {
+    const auto ptr = reinterpret_cast<const char*>(t);
+    vec.insert(vec.end(), ptr, ptr + n * sizeof(T));
+  }
+
+  template <typename T>
+  void write_pod(const T& t)
+  {
+    m_file->write(reinterpret_cast<const char*>(&t), sizeof(T));
+  }
+
+  QFile* m_file{};
+  std::vector<column> m_columns;
+  std::vector<int64_t> m_timestamps;
+  fmt::memory_buffer m_buf;
+
+  // Shared with the writing thread
+  std::thread m_thread;
+  std::mutex m_mutex;
+  std::condition_variable m_cv;
+  std::deque<std::vector<char>> m_pending;
+  std::vector<std::vector<char>> m_free;
+  bool m_closing{};
+};
+
+/**
+ * Reads a recording directly from the mapped file: opening it only goes
+ * through the chunk headers, and a row is decoded when it is played.
+ */
+class reader
+{
+public:
+  static bool isRecording(const char* data, std::size_t size) noexcept
+  {
+    return size >= sizeof(uint32_t) && load<uint32_t>(data) == file_magic;
+  }
+
+  bool open(const char* data, std::size_t size)
+  {
+    m_columns.clear();
+    m_chunks.clear();
+
+    const char* const end = data + size;
+    const char* ptr = data;
+    auto available = [&](std::size_t n) { return std::size_t(end - ptr) >= n; };
+
+    if(!available(12) || load<uint32_t>(ptr) != file_magic
+       || load<uint32_t>(ptr + 4) != format_version)
+      return false;
+
+    const auto columns = load<uint32_t>(ptr + 8);
+    ptr += 12;
+    for(uint32_t i = 0; i < columns; i++)
+    {
+      if(!available(5))
+        return false;
+      const auto type = load<column_type>(ptr);
+      const auto len = load<uint32_t>(ptr + 1);
+      ptr += 5;
+      if(!available(len))
+        return false;
+      m_columns.push_back({std::string(ptr, len), type});
+      ptr += len;
+    }
+
+    // Index of the chunks. A truncated chunk ends the recording.
+    while(available(sizeof(chunk_header)))
+    {
+      const auto header = load<chunk_header>(ptr);
+      if(header.magic != chunk_magic || header.rows == 0 || !available(header.size))
+        break;
+
+      // A complete chunk is only read if it is consistent
+      if(!validChunk(ptr, header.size, header.rows))
+      {
+        m_columns.clear();
+        m_chunks.clear();
+        return false;
+      }
+      m_chunks.push_back({header.first_ts, header.last_ts, ptr, header.rows});
+      ptr += header.size;
+    }
+    return true;
+  }
+
+  const std::vector<column_info>& columns() const noexcept { return m_columns; }
+  bool empty() const noexcept { return m_chunks.empty(); }
+  int64_t lastTimestamp() const noexcept
+  {
+    return m_chunks.empty() ? 0 : m_chunks.back().last_ts;
+  }
+
+  //! Calls f(column index, value) for each value of the first row at or after ts
+  template <typename F>
+  void row(int64_t ts, F&& f) const
+  {
+    auto chunk_it = std::lower_bound(
+        m_chunks.begin(), m_chunks.end(), ts,
+        [](const chunk& c, int64_t ts) { return c.last_ts < ts; });
+    if(chunk_it == m_chunks.end())
+      return;
+
+    const auto& chunk = *chunk_it;
+    const char* timestamps = chunk.data + sizeof(chunk_header);
+
+    // First row with a timestamp >= ts
+    uint32_t first = 0, count = chunk.rows;
+    while(count > 0)
+    {
+      const uint32_t step = count / 2;
+      if(load<int64_t>(timestamps + (first + step) * sizeof(int64_t)) < ts)
+      {
+        first += step + 1;
+        count -= step + 1;
+      }
+      else
+      {
+        count = step;
+      }
+    }
+    if(first == chunk.rows)
+      return;
+
+    const char* ptr = timestamps + chunk.rows * sizeof(int64_t);
+    for(std::size_t i = 0; i < m_columns.size(); i++)
+    {
+      const auto type = m_columns[i].type;
+      if(const auto width = columnWidth(type); width > 0)
+      {
+        f(i, decode(type, ptr + first * width));
+        ptr += chunk.rows * width;
+      }
+      else
+      {
+        const char* offsets = ptr;
+        const char* text = offsets + chunk.rows * sizeof(uint32_t);
+        const auto begin = first == 0 ? 0 : load<uint32_t>(offsets + (first - 1) * 4);
+        const auto end = load<uint32_t>(offsets + first * 4);
+        if(auto v = State::parseValue(std::string_view(text + begin, end - begin)))
+          f(i, std::move(*v));
+        ptr = text + load<uint32_t>(offsets + (chunk.rows - 1) * 4);
+      }
+    }
+  }
+
+private:
+  // Whether the columns and the text offsets stay inside the chunk
+  bool validChunk(const char* data, uint64_t size, uint32_t rows) const noexcept
+  {
+    if(size < sizeof(chunk_header))
+      return false;
+
+    const char* const end = data + size;
+    const char* ptr = data + sizeof(chunk_header);
+    auto available = [&](std::size_t n) { return std::size_t(end - ptr) >= n; };
+
+    if(!available(rows * sizeof(int64_t)))
+      return false;
+    ptr += rows * sizeof(int64_t);
+
+    for(const auto& col : m_columns)
+    {
+      if(const auto width = columnWidth(col.type); width > 0)
+      {
+        if(!available(rows * width))
+          return false;
+        ptr += rows * width;
+      }
+      else
+      {
+        if(!available(rows * sizeof(uint32_t)))
+          return false;
+
+        // End offsets of the texts: they never decrease
+        const char* offsets = ptr;
+        uint32_t text_size = 0;
+        for(uint32_t r = 0; r < rows; r++)
+        {
+          const auto offset = load<uint32_t>(offsets + r * sizeof(uint32_t));
+          if(offset < text_size)
+            return false;
+          text_size = offset;
+        }
+        ptr += rows * sizeof(uint32_t);
+
+        if(!available(text_size))
+          return false;
+        ptr += text_size;
+      }
+    }
+    return ptr == end;
+  }
+
+  static ossia::value decode(column_type type, const char* ptr) noexcept
+  {
+    switch(type)
+    {
+      case column_type::Float:
+        return load<float>(ptr);
+      case column_type::Int:
+        return int(load<int32_t>(ptr));
+      case column_type::Bool:
+        return bool(load<uint8_t>(ptr));
+      case column_type::Vec2f:
+        return load<ossia::vec2f>(ptr);
+      case column_type::Vec3f:
+        return load<ossia::vec3f>(ptr);
+      case column_type::Vec4f:
+        return load<ossia::vec4f>(ptr);
+      default:
+        return {};
+    }
+  }
+
+  struct chunk
+  {
+    int64_t first_ts{};
+    int64_t last_ts{};
+    const char* data{};
+    uint32_t rows{};
+  };
+
+  std::vector<column_info> m_columns;
+  std::vector<chunk> m_chunks;
+};
+}
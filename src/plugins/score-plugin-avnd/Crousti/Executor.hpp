@@ -898,13 +898,15 @@ public:
       soundfile_inputs_type::for_all_n2(
           avnd::get_inputs<Node>(eff), setup_Impl0<Node>{element, ctx, ptr, this});
 
-      auto& tq = score::TaskPool::instance();
+      // The files are loaded in the order they are requested,
+      // so that the last requested one is the one which is kept
       node.soundfiles.load_request
-          = [&tq, p = std::weak_ptr{ptr}, &ctx](std::string& str, int idx) {
+          = [strand = score::TaskStrand{}, p = std::weak_ptr{ptr},
+             &ctx](std::string& str, int idx) {
         auto eff_ptr = p.lock();
         if(!eff_ptr)
           return;
-        tq.post([eff_ptr = std::move(eff_ptr), filename = str, &ctx, idx]() mutable {
+        strand.post([eff_ptr = std::move(eff_ptr), filename = str, &ctx, idx]() mutable {
           if(auto file = loadSoundfile(filename, ctx.doc, ctx.execState))
           {
             ctx.executionQueue.enqueue(
@@ -1009,7 +1011,7 @@ public:
     if constexpr(avnd::has_worker<Node>)
     {
       // Initialize the thread pool beforehand
-      auto& tq = score::TaskPool::instance();
+      score::TaskPool::instance();
       using worker_type = decltype(eff.effect.worker);
       for(auto& eff : eff.effects())
       {
@@ -1017,12 +1019,13 @@ public:
         std::weak_ptr qex_ptr = std::shared_ptr<Execution::ExecutionCommandQueue>(
             ctx.alias.lock(), &ctx.executionQueue);
 
+        // The requests of an instance run one at a time, in order
         eff.worker.request
-            = [&tq, qex_ptr = std::move(qex_ptr),
+            = [strand = score::TaskStrand{}, qex_ptr = std::move(qex_ptr),
                eff_ptr = std::move(eff_ptr)]<typename... Args>(Args&&... f) {
           // request() is invoked in the DSP / processor thread
           // and just posts the task to the thread pool
-          tq.post([eff_ptr = std::move(eff_ptr), qex_ptr = std::move(qex_ptr),
+          strand.post([eff_ptr = std::move(eff_ptr), qex_ptr = std::move(qex_ptr),
                    ... ff = std::forward<Args>(f)]() mutable {
             // This happens in the worker thread
             // If for some reason the object has already been removed, not much
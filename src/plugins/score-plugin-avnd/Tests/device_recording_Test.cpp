@@ -0,0 +1,128 @@
+#include <AvndProcesses/DeviceRecording.hpp>
+
+#include <QTemporaryDir>
+
+#include <cstring>
+
+#include <catch2/catch_all.hpp>
+
+using namespace avnd_tools::recording;
+
+namespace
+{
+std::vector<ossia::value> expectedRow(int i)
+{
+  return {
+      float(i), std::string("row " + std::to_string(i)),
+      std::vector<ossia::value>{i, std::string("x")}};
+}
+
+// Records rows 0..count with a timestamp of 10 * row, then reads the file back
+QByteArray record(const QString& path, int count)
+{
+  QFile f{path};
+  if(!f.open(QIODevice::WriteOnly))
+    return {};
+
+  writer w;
+  w.open(
+      f, {{"/float", column_type::Float},
+          {"/string", column_type::Text},
+          {"/list", column_type::Text}});
+  for(int i = 0; i < count; i++)
+    w.write(10 * i, expectedRow(i));
+  w.close();
+  f.close();
+
+  if(!f.open(QIODevice::ReadOnly))
+    return {};
+  return f.readAll();
+}
+
+std::vector<ossia::value> readRow(const reader& r, int64_t ts)
+{
+  std::vector<ossia::value> res(r.columns().size());
+  r.row(ts, [&](int i, ossia::value&& v) { res[i] = std::move(v); });
+  return res;
+}
+}
+
+TEST_CASE("binary recording round-trip", "recording")
+{
+  QTemporaryDir dir;
+  const int count = 2 * writer::chunk_rows + 10;
+  const auto data = record(dir.filePath("rec.bin"), count);
+  REQUIRE(!data.isEmpty());
+
+  reader r;
+  REQUIRE(r.open(data.constData(), data.size()));
+  REQUIRE(r.columns().size() == 3);
+  REQUIRE(r.columns()[1].address == "/string");
+  REQUIRE(r.columns()[2].type == column_type::Text);
+  REQUIRE(r.lastTimestamp() == 10 * (count - 1));
+
+  for(int i : {0, 1, int(writer::chunk_rows) - 1, int(writer::chunk_rows), count - 1})
+  {
+    REQUIRE(readRow(r, 10 * i) == expectedRow(i));
+
+    // A timestamp between two rows gives the next one
+    if(i > 0)
+      REQUIRE(readRow(r, 10 * i - 5) == expectedRow(i));
+  }
+}
+
+TEST_CASE("truncated binary recording", "recording")
+{
+  QTemporaryDir dir;
+  const int count = writer::chunk_rows + 100;
+  auto data = record(dir.filePath("rec.bin"), count);
+  REQUIRE(!data.isEmpty());
+
+  // Interrupted while the second chunk was being written
+  data.chop(10);
+
+  reader r;
+  REQUIRE(r.open(data.constData(), data.size()));
+  REQUIRE(r.lastTimestamp() == 10 * (writer::chunk_rows - 1));
+  REQUIRE(readRow(r, 0) == expectedRow(0));
+  REQUIRE(readRow(r, r.lastTimestamp()) == expectedRow(writer::chunk_rows - 1));
+
+  // The rows of the truncated chunk are not read
+  REQUIRE(readRow(r, r.lastTimestamp() + 1) == std::vector<ossia::value>(3));
+}
+
+TEST_CASE("corrupted binary recording", "recording")
+{
+  QTemporaryDir dir;
+  const int count = 10;
+  auto data = record(dir.filePath("rec.bin"), count);
+  REQUIRE(!data.isEmpty());
+
+  // File header, then the chunk header, the timestamps and the float column
+  std::size_t pos = 12;
+  for(const char* address : {"/float", "/string", "/list"})
+    pos += 5 + std::strlen(address);
+  pos += sizeof(chunk_header) + count * sizeof(int64_t) + count * sizeof(float);
+
+  // The end offsets of the "/string" texts
+  uint32_t last_offset{};
+  std::memcpy(&last_offset, data.constData() + pos + (count - 1) * 4, 4);
+  REQUIRE(last_offset > 0);
+  REQUIRE(last_offset < std::size_t(data.size()));
+
+  // A text which would end past the chunk
+  const uint32_t bad_offset = 0xFFFFFF00;
+  data.replace(pos + (count - 1) * 4, 4, reinterpret_cast<const char*>(&bad_offset), 4);
+
+  reader r;
+  REQUIRE(!r.open(data.constData(), data.size()));
+  REQUIRE(r.empty());
+  REQUIRE(r.columns().empty());
+
+  // Decreasing offsets
+  data.replace(pos + (count - 1) * 4, 4, reinterpret_cast<const char*>(&last_offset), 4);
+  REQUIRE(r.open(data.constData(), data.size()));
+  const uint32_t zero = 0;
+  data.replace(pos + 4, 4, reinterpret_cast<const char*>(&zero), 4);
+  REQUIRE(!r.open(data.constData(), data.size()));
+}
@@ -29,6 +29,8 @@
 #include <score/widgets/MessageBox.hpp>
 #include <score/widgets/Pixmap.hpp>
 
+#include <core/application/ApplicationSettings.hpp>
+
 #include <ossia/detail/logger.hpp>
 #include <ossia/detail/thread.hpp>
 #include <ossia/network/context.hpp>
@@ -42,9 +44,11 @@
 #include <QObject>
 #include <QPushButton>
 #include <QString>
+#include <QTimer>
 
 #include <wobjectimpl.h>
 
+#include <algorithm>
 #include <stdexcept>
 #include <vector>
 W_OBJECT_IMPL(Explorer::DeviceDocumentPlugin)
@@ -434,9 +438,29 @@ void DeviceDocumentPlugin::reconnect(const QString& device)
 void DeviceDocumentPlugin::on_valueUpdated(
     const State::Address& addr, const ossia::value& v)
 {
-  ossia::qt::run_async(this, [this, aa = State::AddressAccessor{addr}, v] {
-    updateProxy.updateLocalValue(aa, v);
-  });
+  m_valueUpdates.enqueue({addr, v});
+
+  // A single batch is pending at any time
+  if(!m_valueUpdatesScheduled.exchange(true))
+  {
+    ossia::qt::run_async(this, [this] {
+      const int rate = std::max(1, context().app.applicationSettings.uiEventRate);
+      QTimer::singleShot(rate, this, [this] { processValueUpdates(); });
+    });
+  }
+}
+
+void DeviceDocumentPlugin::processValueUpdates()
+{
+  // Values received from now on go in the next batch
+  m_valueUpdatesScheduled = false;
+
+  score::hash_map<State::Address, ossia::value> values;
+  std::pair<State::Address, ossia::value> update;
+  while(m_valueUpdates.try_dequeue(update))
+    values.insert_or_assign(std::move(update.first), std::move(update.second));
+
+  updateProxy.updateLocalValues(values);
 }
 
 }
@@ -9,6 +9,7 @@
 #include <score/plugins/documentdelegate/plugin/DocumentPlugin.hpp>
 
 #include <ossia/detail/hash_map.hpp>
+#include <ossia/detail/lockfree_queue.hpp>
 
 #include <score_plugin_deviceexplorer_export.h>
 
@@ -84,6 +85,7 @@ public:
 private:
   void initDevice(Device::DeviceInterface&);
   void on_valueUpdated(const State::Address& addr, const ossia::value& v);
+  void processValueUpdates();
 
   Device::Node m_rootNode;
   Device::DeviceList m_list;
@@ -91,6 +93,11 @@ private:
   std::thread m_asioThread;
   ossia::net::network_context_ptr m_asioContext;
 
+  // Values received from the devices, on any thread. They are sent to the
+  // explorer at the UI rate, only the last value of each address being kept.
+  ossia::mpmc_queue<std::pair<State::Address, ossia::value>> m_valueUpdates;
+  std::atomic_bool m_valueUpdatesScheduled{};
+
   mutable std::unique_ptr<Explorer::ListeningHandler> m_listening;
   DeviceExplorerModel* m_explorer{};
   ossia::hash_map<Device::DeviceInterface*, std::vector<QMetaObject::Connection>>
@@ -3,6 +3,8 @@
 
 #include <Device/Node/DeviceNode.hpp>
 
+#include <score/tools/std/HashMap.hpp>
+
 #include <QString>
 
 #include <score_plugin_deviceexplorer_export.h>
@@ -90,6 +92,7 @@ public:
 
   void removeLocalNode(const State::Address&);
   void updateLocalValue(const State::AddressAccessor&, const ossia::value&);
+  void updateLocalValues(const score::hash_map<State::Address, ossia::value>&);
   void updateLocalSettings(
       const State::Address&, const Device::AddressSettings&,
       Device::DeviceInterface& newdev);
@@ -35,6 +35,7 @@
 #include <score/plugins/StringFactoryKey.hpp>
 #include <score/serialization/JSONVisitor.hpp>
 #include <score/serialization/MimeVisitor.hpp>
+#include <score/tools/std/HashMap.hpp>
 #include <score/widgets/MessageBox.hpp>
 
 #include <ossia/detail/ssize.hpp>
@@ -54,6 +55,7 @@
 
 #include <wobjectimpl.h>
 
+#include <algorithm>
 #include <iostream>
 #include <string>
 #include <vector>
@@ -227,6 +229,38 @@ void DeviceExplorerModel::updateValue(
   dataChanged(nodeIndex, nodeIndex);
 }
 
+void DeviceExplorerModel::updateValues(
+    const std::vector<std::pair<Device::Node*, ossia::value>>& values)
+{
+  score::hash_map<Device::Node*, std::vector<int>> rows;
+  for(const auto& [n, v] : values)
+  {
+    n->get<Device::AddressSettings>().value = v;
+
+    auto parent = n->parent();
+    rows[parent].push_back(parent->indexOfChild(n));
+  }
+
+  constexpr int col = (int)Column::Value;
+  for(auto& [parent, r] : rows)
+  {
+    std::sort(r.begin(), r.end());
+    r.erase(std::unique(r.begin(), r.end()), r.end());
+
+    const QModelIndex parentIndex = modelIndexFromNode(*parent, 0);
+    std::size_t first = 0;
+    for(std::size_t i = 1; i <= r.size(); i++)
+    {
+      if(i == r.size() || r[i] != r[i - 1] + 1)
+      {
+        dataChanged(
+            index(r[first], col, parentIndex), index(r[i - 1], col, parentIndex));
+        first = i;
+      }
+    }
+  }
+}
+
 bool DeviceExplorerModel::checkDeviceInstantiatable(
     const Device::DeviceSettings& n) const
 {
@@ -11,7 +11,9 @@
 #include <Scenario/Inspector/Interval/SpeedSlider.hpp>
 #include <Scenario/Settings/ScenarioSettingsModel.hpp>
 
+#include <Audio/Settings/Model.hpp>
 #include <Execution/DocumentPlugin.hpp>
+#include <Execution/OfflineBenchmark.hpp>
 #include <LocalTree/LocalTreeDocumentPlugin.hpp>
 
 #include <score/actions/ActionManager.hpp>
@@ -57,6 +59,14 @@ ApplicationPlugin::~ApplicationPlugin()
 
 bool ApplicationPlugin::handleStartup()
 {
+  if(!context.applicationSettings.benchmark.isEmpty())
+  {
+    QTimer::singleShot(
+        context.applicationSettings.waitAfterLoad * 1000, this,
+        [this] { runOfflineBenchmark(); });
+    return true;
+  }
+
   if(!context.documents.documents().empty())
   {
     if(context.applicationSettings.autoplay)
@@ -72,6 +82,34 @@ bool ApplicationPlugin::handleStartup()
   return false;
 }
 
+void ApplicationPlugin::runOfflineBenchmark()
+{
+  const auto& set = context.applicationSettings;
+  bool ok = false;
+  if(auto doc = currentDocument())
+  {
+    auto& audio = context.settings<Audio::Settings::Model>();
+    Execution::OfflineBenchmarkOptions opt;
+    opt.output = set.benchmark;
+    opt.bufferSize = set.benchmarkBufferSize;
+    opt.rate = set.benchmarkRate;
+    opt.inputs = audio.getDefaultIn();
+    opt.outputs = audio.getDefaultOut();
+    opt.duration = set.benchmarkDuration;
+
+    auto& plug = doc->context().plugin<Execution::DocumentPlugin>();
+    auto& root = score::IDocument::get<Scenario::ScenarioDocumentModel>(*doc);
+    ok = Execution::runOfflineBenchmark(plug, root.baseInterval(), opt);
+  }
+  else
+  {
+    qWarning() << "--benchmark: no document loaded";
+  }
+
+  // A failed benchmark must be visible to the scripts running it
+  score::GUIApplicationInterface::instance().forceExit(ok ? 0 : 1);
+}
+
 void ApplicationPlugin::initialize()
 {
   // Update the clock widget
@@ -241,7 +279,39 @@ void ApplicationPlugin::on_createdDocument(score::Document& doc)
     lt->init();
     initLocalTreeNodes(*lt);
   }
-  score::addDocumentPlugin<Execution::DocumentPlugin>(doc);
+  auto& exec = score::addDocumentPlugin<Execution::DocumentPlugin>(doc);
+  if(lt)
+    initTelemetryNodes(*lt, exec);
+}
+
+void ApplicationPlugin::initTelemetryNodes(
+    LocalTree::DocumentPlugin& lt, Execution::DocumentPlugin& exec)
+{
+  auto& root = *lt.device().get_root_node().create_child("telemetry");
+  auto make_param = [&root](std::string name, ossia::val_type t) {
+    auto p = root.create_child(std::move(name))->create_parameter(t);
+    p->set_access(ossia::access_mode::GET);
+    return p;
+  };
+
+  auto load = make_param("load", ossia::val_type::FLOAT);
+  auto tick_max = make_param("tick_max_us", ossia::val_type::FLOAT);
+  auto tick_mean = make_param("tick_mean_us", ossia::val_type::FLOAT);
+  auto commands = make_param("commands", ossia::val_type::INT);
+  auto xruns = make_param("xruns", ossia::val_type::INT);
+  auto dropped = make_param("dropped", ossia::val_type::INT);
+  auto gc_depth = make_param("gc_depth", ossia::val_type::INT);
+
+  connect(&exec, &Execution::DocumentPlugin::telemetryChanged, &lt, [=, &exec] {
+    const auto& t = exec.telemetry();
+    load->push_value(float(t.maxLoad));
+    tick_max->push_value(float(t.maxDuration_us));
+    tick_mean->push_value(float(t.meanDuration_us));
+    commands->push_value(int(t.commands));
+    xruns->push_value(int(t.totalXruns));
+    dropped->push_value(int(t.totalDropped));
+    gc_depth->push_value(int(t.gcQueueDepth));
+  });
 }
 
 void ApplicationPlugin::on_documentChanged(
@@ -22,6 +22,7 @@ class IntervalModel;
 namespace Execution
 {
 struct Context;
+class DocumentPlugin;
 class Clock;
 class BaseScenarioElement;
 }
@@ -60,10 +61,13 @@ public:
 
   QWidget* setupTimingWidget(QLabel*) const;
   void initLocalTreeNodes(LocalTree::DocumentPlugin&);
+  void initTelemetryNodes(LocalTree::DocumentPlugin&, Execution::DocumentPlugin&);
 
   Execution::ExecutionController& execution() { return m_execution; }
 
 private:
+  void runOfflineBenchmark();
+
   Execution::PlayContextMenu m_playActions;
   Execution::ExecutionController m_execution;
 
@@ -39,31 +39,11 @@ void Clock::play_impl(const TimeVal& t)
 
   m_default.play(t, *this->scenario);
 
-  auto tick = m_plug.settings.getTick();
-  auto commit = m_plug.settings.getCommit();
-
-  ossia::tick_setup_options opt;
-  if(tick == Execution::Settings::TickPolicies{}.Buffer)
-    opt.tick = ossia::tick_setup_options::Buffer;
-  else if(tick == Execution::Settings::TickPolicies{}.ScoreAccurate)
-    opt.tick = ossia::tick_setup_options::ScoreAccurate;
-  else if(tick == Execution::Settings::TickPolicies{}.Precise)
-    opt.tick = ossia::tick_setup_options::Precise;
-
-  if(commit == Execution::Settings::CommitPolicies{}.Default)
-    opt.commit = ossia::tick_setup_options::Default;
-  else if(commit == Execution::Settings::CommitPolicies{}.Ordered)
-    opt.commit = ossia::tick_setup_options::Ordered;
-  else if(commit == Execution::Settings::CommitPolicies{}.Priorized)
-    opt.commit = ossia::tick_setup_options::Priorized;
-  else if(commit == Execution::Settings::CommitPolicies{}.Merged)
-    opt.commit = ossia::tick_setup_options::Merged;
-  else if(commit == Execution::Settings::CommitPolicies{}.MergedThreaded)
-    opt.commit = ossia::tick_setup_options::MergedThreaded;
-  else if(commit == Execution::Settings::CommitPolicies{}.DirectThreaded)
-    opt.commit = ossia::tick_setup_options::DirectThreaded;
-
-  if(m_plug.settings.getBench() && m_plug.contextData()->bench)
+  const auto opt = Execution::tickOptions(m_plug.settings);
+
+  // The graph only has a bench_map when nodes have to be measured,
+  // see DocumentPlugin::makeGraph
+  if(m_plug.contextData()->bench)
   {
     m_play_tick = Execution::makeBenchmarkTick(opt, m_plug, this->scenario);
   }
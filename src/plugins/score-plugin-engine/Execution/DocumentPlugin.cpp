@@ -6,9 +6,12 @@
 
 #include <Explorer/DocumentPlugin/DeviceDocumentPlugin.hpp>
 
+#include <Process/Execution/ProcessComponent.hpp>
+
 #include <Scenario/Application/ScenarioActions.hpp>
 #include <Scenario/Document/BaseScenario/BaseScenario.hpp>
 #include <Scenario/Document/Interval/IntervalExecution.hpp>
+#include <Scenario/Document/Interval/IntervalModel.hpp>
 #include <Scenario/Document/ScenarioDocument/ScenarioDocumentModel.hpp>
 #include <Scenario/Document/State/StateExecution.hpp>
 #include <Scenario/Execution/score2OSSIA.hpp>
@@ -32,10 +35,12 @@
 #include <ossia/dataflow/execution_state.hpp>
 #include <ossia/dataflow/graph/graph_interface.hpp>
 #include <ossia/dataflow/graph_edge.hpp>
+#include <ossia/dataflow/graph_node.hpp>
 #include <ossia/dataflow/port.hpp>
 #include <ossia/detail/flicks.hpp>
 #include <ossia/detail/logger.hpp>
 #include <ossia/editor/scenario/time_interval.hpp>
+#include <ossia/editor/scenario/time_process.hpp>
 #include <ossia/network/common/path.hpp>
 
 #include <QCoreApplication>
@@ -135,6 +140,7 @@ void DocumentPlugin::on_finished()
   {
     killTimer(m_tid);
     m_tid = -1;
+    m_gc.stop();
 
     {
       ExecutionCommand cmd;
@@ -180,9 +186,48 @@ void DocumentPlugin::timerEvent(QTimerEvent* event)
   ExecutionCommand cmd;
   while(m_ctxData->m_editionQueue.try_dequeue(cmd))
     cmd();
-  GCCommand gc;
-  while(m_ctxData->m_gcQueue.try_dequeue(gc))
-    ;
+  if(!m_gc.running())
+  {
+    GCCommand gc;
+    while(m_ctxData->m_gcQueue.try_dequeue(gc))
+      ;
+  }
+
+  updateTelemetry();
+}
+
+void DocumentPlugin::updateTelemetry()
+{
+  auto& ring = m_ctxData->telemetry;
+  auto& stats = m_telemetry;
+  stats.ticks = 0;
+  stats.maxDuration_us = 0.;
+  stats.maxLoad = 0.;
+  stats.commands = 0;
+  stats.gc = 0;
+
+  double total_us = 0.;
+  TickTelemetry t;
+  while(ring.pop(t))
+  {
+    const double us = t.duration_ns / 1e3;
+    total_us += us;
+    stats.ticks++;
+    stats.maxDuration_us = std::max(stats.maxDuration_us, us);
+    if(t.budget_ns > 0)
+      stats.maxLoad = std::max(stats.maxLoad, double(t.duration_ns) / t.budget_ns);
+    stats.commands += t.commands;
+    stats.gc += t.gc;
+    stats.totalXruns += t.xrun;
+  }
+  stats.meanDuration_us = stats.ticks > 0 ? total_us / stats.ticks : 0.;
+  stats.totalTicks += stats.ticks;
+  stats.totalDropped += ring.takeDropped();
+  stats.gcQueueDepth = m_gc.takeMaxDepth();
+  stats.totalReclaimed += m_gc.takeReclaimed();
+
+  if(stats.ticks > 0)
+    telemetryChanged();
 }
 
 void DocumentPlugin::registerDevice(ossia::net::device_base* d)
@@ -247,7 +292,8 @@ void DocumentPlugin::makeGraph()
   opt.parallel_threads = settings.getThreads();
   if(settings.getLogging())
     opt.log = ossia::logger_ptr();
-  if(settings.getBench())
+  // Nodes are also measured to enforce the budget policy
+  if(settings.getBench() || settings.getBudget() != Settings::BudgetPolicies{}.Ignore)
   {
     bench = std::make_shared<bench_map>();
     opt.bench = bench;
@@ -317,12 +363,20 @@ void DocumentPlugin::reload(bool forcePlay, Scenario::IntervalModel& cst)
     }
   }
 
+  // The ring may still hold the records of the previous execution
+  m_ctxData->telemetry.clear();
+  m_telemetry = {};
+  m_budget.clear();
+  m_gc.start(m_ctxData->m_gcQueue);
   m_tid = startTimer(32);
   // runAllCommands();
 }
 
 void DocumentPlugin::clear()
 {
+  // The collector refers to the GC queue of the context we are about to reset
+  m_gc.stop();
+
   if(m_ctxData)
   {
     m_ctxData->setupContext.inlets.clear();
@@ -430,9 +484,20 @@ void DocumentPlugin::registerAction(ExecutionAction& act)
 
 void DocumentPlugin::slot_bench(ossia::bench_map b, int64_t ns)
 {
+  const bool display = settings.getBench();
+  const bool budget = settings.getBudget() != Settings::BudgetPolicies{}.Ignore;
+
+  // Duration of a tick, which is the deadline of the whole graph
+  double tick_ns = 0.;
+  if(auto& st = m_ctxData->execState; st && st->sampleRate > 0)
+    tick_ns = 1e9 * st->bufferSize / st->sampleRate;
+
   for(const auto& p : b)
   {
-    if(p.second)
+    if(!p.second)
+      continue;
+
+    if(display)
     {
       auto proc = m_ctxData->setupContext.proc_map.find(p.first);
       if(proc != m_ctxData->setupContext.proc_map.end())
@@ -444,6 +509,89 @@ void DocumentPlugin::slot_bench(ossia::bench_map b, int64_t ns)
         }
       }
     }
+
+    if(budget && tick_ns > 0.)
+      applyBudget(p.first, *p.second / tick_ns);
+  }
+
+  // Bypassed nodes are not measured: they are tried again after a while
+  retryBypassed();
+}
+
+//! ossia process of a process in an interval
+static std::shared_ptr<ossia::time_process>
+findOSSIAProcess(const BaseScenarioElement* base, const Process::ProcessModel& proc)
+{
+  auto itv = qobject_cast<Scenario::IntervalModel*>(proc.parent());
+  if(!itv)
+    return {};
+
+  const IntervalComponentBase* comp
+      = score::findComponent<Execution::IntervalComponent>(itv->components());
+  if(!comp && base && &base->baseInterval().scoreInterval() == itv)
+    comp = &base->baseInterval();
+  if(!comp)
+    return {};
+
+  if(auto it = comp->processes().find(proc.id()); it != comp->processes().end())
+    return it->second->OSSIAProcessPtr();
+  return {};
+}
+
+void DocumentPlugin::applyBudget(const ossia::graph_node* node, double load)
+{
+  auto& st = m_budget[node];
+  if(st.retry > 0)
+    return;
+
+  // Measurements are sparse (one tick every 50) and noisy:
+  // a single slow tick must not be enough to trigger the policy.
+  st.load = st.load == 0. ? load : 0.75 * st.load + 0.25 * load;
+  if(st.load < settings.getBudgetShare() / 100.)
+    return;
+
+  auto& setup = m_ctxData->setupContext;
+  const Process::ProcessModel* proc{};
+  if(auto it = setup.proc_map.find(node); it != setup.proc_map.end())
+    proc = it->second;
+
+  const QString name = proc ? proc->metadata().getName() : QStringLiteral("node");
+  if(!st.warned)
+  {
+    qWarning() << "Process" << name << "uses" << int(100. * st.load)
+               << "% of the audio buffer duration";
+    st.warned = true;
+    overBudget(proc, st.load);
+  }
+
+  if(settings.getBudget() == Settings::BudgetPolicies{}.Bypass && proc)
+  {
+    // A disabled process does not request its node to run,
+    // so the graph skips it instead of relying on the node to honour muted()
+    if(auto p = findOSSIAProcess(m_base.get(), *proc))
+    {
+      m_ctxData->m_execQueue.enqueue([p] { p->enable(false); });
+      qWarning() << "Process" << name << "has been bypassed";
+      st.bypassed = p;
+      st.backoff = std::min(std::max(8, 2 * st.backoff), 256);
+      st.retry = st.backoff;
+    }
+  }
+}
+
+void DocumentPlugin::retryBypassed()
+{
+  for(auto& [node, st] : m_budget)
+  {
+    if(st.retry == 0 || --st.retry > 0)
+      continue;
+
+    // Measured again from scratch: it is bypassed again, for twice as long,
+    // if it is still over budget
+    if(auto p = st.bypassed.lock())
+      m_ctxData->m_execQueue.enqueue([p] { p->enable(true); });
+    st.bypassed.reset();
+    st.load = 0.;
   }
 }
 
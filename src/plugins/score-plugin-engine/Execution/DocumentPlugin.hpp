@@ -1,10 +1,13 @@
 #pragma once
 #include "BaseScenarioComponent.hpp"
+#include "ExecutionTelemetry.hpp"
+#include "GarbageCollector.hpp"
 
 #include <Process/Dataflow/Port.hpp>
 #include <Process/ExecutionAction.hpp>
 #include <Process/ExecutionContext.hpp>
 #include <Process/ExecutionSetup.hpp>
+#include <Process/Process.hpp>
 
 #include <score/plugins/documentdelegate/plugin/DocumentPlugin.hpp>
 #include <score/tools/Metadata.hpp>
@@ -32,6 +35,7 @@ namespace ossia
 {
 class audio_protocol;
 struct bench_map;
+class time_process;
 }
 namespace Device
 {
@@ -67,6 +71,7 @@ public:
     ExecutionCommandQueue m_execQueue{1024};
     EditionCommandQueue m_editionQueue{1024};
     GCCommandQueue m_gcQueue{1024};
+    TelemetryRing telemetry;
     std::atomic_bool m_created{};
 
     std::shared_ptr<ossia::graph_interface> execGraph;
@@ -101,6 +106,9 @@ public:
   void registerAction(ExecutionAction& act);
   const std::vector<ExecutionAction*>& actions() const noexcept { return m_actions; }
 
+  //! Audio tick statistics, updated by the GUI timer while playing
+  const TelemetryStatistics& telemetry() const noexcept { return m_telemetry; }
+
   const Execution::Settings::Model& settings;
 
   QPointer<Dataflow::AudioDevice> audio_device{};
@@ -108,6 +116,11 @@ public:
 
 public:
   void finished() E_SIGNAL(SCORE_PLUGIN_ENGINE_EXPORT, finished)
+  void telemetryChanged() E_SIGNAL(SCORE_PLUGIN_ENGINE_EXPORT, telemetryChanged)
+
+  //! A process used more than its share of the tick, load being relative to the tick
+  void overBudget(const Process::ProcessModel* proc, double load)
+      E_SIGNAL(SCORE_PLUGIN_ENGINE_EXPORT, overBudget, proc, load)
 
   void slot_bench(ossia::bench_map, int64_t ns);
 
@@ -115,6 +128,8 @@ private:
   void on_deviceAdded(Device::DeviceInterface* device);
   void on_finished();
   void timerEvent(QTimerEvent* event) override;
+  void updateTelemetry();
+  void applyBudget(const ossia::graph_node* node, double load);
   void registerDevice(ossia::net::device_base*);
   void unregisterDevice(ossia::net::device_base*);
   void makeGraph();
@@ -124,6 +139,23 @@ private:
   std::shared_ptr<ContextData> m_ctxData;
   std::shared_ptr<BaseScenarioElement> m_base;
   std::vector<ExecutionAction*> m_actions;
+  TelemetryStatistics m_telemetry;
+  GarbageCollector m_gc;
+
+  //! Rolling cost of each node, as a share of the tick budget
+  struct NodeBudget
+  {
+    double load{};
+    bool warned{};
+
+    //! Process skipped while the node is over budget
+    std::weak_ptr<ossia::time_process> bypassed;
+    //! Measurements left before the node is tried again, and their next count
+    int retry{};
+    int backoff{};
+  };
+  void retryBypassed();
+  score::hash_map<const ossia::graph_node*, NodeBudget> m_budget;
 
   int m_tid{};
 };
@@ -0,0 +1,108 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cinttypes>
+#include <cstddef>
+
+namespace Execution
+{
+//! What happened during one audio tick
+struct TickTelemetry
+{
+  //! Wall-clock duration of the tick
+  int64_t duration_ns{};
+
+  //! Time available for the tick: frames / sample rate
+  int64_t budget_ns{};
+
+  //! ExecutionCommands dequeued and run at the beginning of the tick
+  int32_t commands{};
+
+  //! Items sent to the GC queue during the tick
+  int32_t gc{};
+
+  //! The tick took longer than its budget
+  bool xrun{};
+};
+
+/**
+ * @brief Fixed-size single-producer single-consumer ring of TickTelemetry.
+ *
+ * Written from the audio thread, read from the GUI thread.
+ * It never allocates: when the consumer does not keep up, new records are
+ * dropped and counted.
+ */
+class TelemetryRing
+{
+public:
+  static constexpr std::size_t capacity = 1024;
+  static_assert((capacity & (capacity - 1)) == 0);
+
+  bool push(const TickTelemetry& t) noexcept
+  {
+    const auto w = m_write.load(std::memory_order_relaxed);
+    if(w - m_read.load(std::memory_order_acquire) == capacity)
+    {
+      m_dropped.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+
+    m_data[w & (capacity - 1)] = t;
+    m_write.store(w + 1, std::memory_order_release);
+    return true;
+  }
+
+  bool pop(TickTelemetry& t) noexcept
+  {
+    const auto r = m_read.load(std::memory_order_relaxed);
+    if(r == m_write.load(std::memory_order_acquire))
+      return false;
+
+    t = m_data[r & (capacity - 1)];
+    m_read.store(r + 1, std::memory_order_release);
+    return true;
+  }
+
+  //! Number of records dropped since the last call
+  int64_t takeDropped() noexcept
+  {
+    return m_dropped.exchange(0, std::memory_order_relaxed);
+  }
+
+  //! Discards the pending records, from the consumer thread
+  void clear() noexcept
+  {
+    m_read.store(m_write.load(std::memory_order_acquire), std::memory_order_release);
+    m_dropped.store(0, std::memory_order_relaxed);
+  }
+
+private:
+  std::array<TickTelemetry, capacity> m_data{};
+  alignas(64) std::atomic<std::size_t> m_write{};
+  alignas(64) std::atomic<std::size_t> m_read{};
+  alignas(64) std::atomic<int64_t> m_dropped{};
+};
+
+//! Telemetry aggregated on the GUI side, see DocumentPlugin::telemetry
+struct TelemetryStatistics
+{
+  // Over the last drained window
+  int64_t ticks{};
+  double meanDuration_us{};
+  double maxDuration_us{};
+
+  //! Highest duration / budget ratio, 1. meaning that the deadline was reached
+  double maxLoad{};
+  int64_t commands{};
+  int64_t gc{};
+
+  //! Largest depth of the GC queue seen by the GarbageCollector
+  int64_t gcQueueDepth{};
+
+  // Since the start of the execution
+  int64_t totalTicks{};
+  int64_t totalXruns{};
+  int64_t totalDropped{};
+  int64_t totalReclaimed{};
+};
+}
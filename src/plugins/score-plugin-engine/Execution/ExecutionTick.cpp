@@ -6,8 +6,11 @@
 #include <Execution/BaseScenarioComponent.hpp>
 #include <Execution/DocumentPlugin.hpp>
 #include <Execution/ExecutionController.hpp>
+#include <Execution/OfflineBenchmark.hpp>
+#include <Execution/Settings/ExecutorModel.hpp>
 
 #include <ossia/audio/audio_protocol.hpp>
+#include <ossia/dataflow/bench_map.hpp>
 #include <ossia/dataflow/execution_state.hpp>
 #include <ossia/dataflow/graph/graph_interface.hpp>
 #include <ossia/dataflow/graph/tick_setup.hpp>
@@ -17,9 +20,41 @@
 
 #include <Transport/TransportInterface.hpp>
 
+#include <chrono>
+#include <memory>
+
 namespace Execution
 {
 
+ossia::tick_setup_options tickOptions(const Execution::Settings::Model& settings)
+{
+  const auto tick = settings.getTick();
+  const auto commit = settings.getCommit();
+
+  ossia::tick_setup_options opt;
+  if(tick == Execution::Settings::TickPolicies{}.Buffer)
+    opt.tick = ossia::tick_setup_options::Buffer;
+  else if(tick == Execution::Settings::TickPolicies{}.ScoreAccurate)
+    opt.tick = ossia::tick_setup_options::ScoreAccurate;
+  else if(tick == Execution::Settings::TickPolicies{}.Precise)
+    opt.tick = ossia::tick_setup_options::Precise;
+
+  if(commit == Execution::Settings::CommitPolicies{}.Default)
+    opt.commit = ossia::tick_setup_options::Default;
+  else if(commit == Execution::Settings::CommitPolicies{}.Ordered)
+    opt.commit = ossia::tick_setup_options::Ordered;
+  else if(commit == Execution::Settings::CommitPolicies{}.Priorized)
+    opt.commit = ossia::tick_setup_options::Priorized;
+  else if(commit == Execution::Settings::CommitPolicies{}.Merged)
+    opt.commit = ossia::tick_setup_options::Merged;
+  else if(commit == Execution::Settings::CommitPolicies{}.MergedThreaded)
+    opt.commit = ossia::tick_setup_options::MergedThreaded;
+  else if(commit == Execution::Settings::CommitPolicies{}.DirectThreaded)
+    opt.commit = ossia::tick_setup_options::DirectThreaded;
+
+  return opt;
+}
+
 namespace
 {
 struct AudioTickHelper
@@ -80,21 +115,53 @@ struct AudioTickHelper
     }
   }
 
-  void dequeueCommands() const
+  struct CommandCount
+  {
+    int32_t commands{};
+    int32_t gc{};
+  };
+
+  CommandCount dequeueCommands() const
   {
+    CommandCount count;
+
     // Run some commands if they have been submitted.
     Execution::ExecutionCommand c;
     while(m_context->m_execQueue.try_dequeue(c))
     {
+      count.commands++;
       try
       {
         c();
         m_context->m_gcQueue.enqueue(gc(std::move(c)));
+        count.gc++;
       }
       catch(...)
       {
       }
     }
+    return count;
+  }
+
+  void recordTelemetry(
+      const ossia::audio_tick_state& t, std::chrono::steady_clock::time_point t0,
+      CommandCount count) const noexcept
+  {
+    const auto t1 = std::chrono::steady_clock::now();
+    const int64_t duration
+        = std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count();
+    const int64_t budget
+        = m_context->execState->sampleRate > 0
+              ? int64_t(1e9 * t.frames / m_context->execState->sampleRate)
+              : 0;
+
+    TickTelemetry tt;
+    tt.duration_ns = duration;
+    tt.budget_ns = budget;
+    tt.commands = count.commands;
+    tt.gc = count.gc;
+    tt.xrun = budget > 0 && duration > budget;
+    m_context->telemetry.push(tt);
   }
 
   void main_tick(const ossia::audio_tick_state& t) const
@@ -191,9 +258,11 @@ Audio::tick_fun makeExecutionTick(
              const ossia::audio_tick_state& t) {
     Audio::execution_status.store(ossia::transport_status::playing);
 
+    const auto t0 = std::chrono::steady_clock::now();
     helper->clearBuffers(t);
-    helper->dequeueCommands();
+    const auto count = helper->dequeueCommands();
     helper->main(t);
+    helper->recordTelemetry(t, t0, count);
   };
 }
 
@@ -207,8 +276,9 @@ Audio::tick_fun makeBenchmarkTick(
           i](const ossia::audio_tick_state& t) mutable {
     Audio::execution_status.store(ossia::transport_status::playing);
 
+    const auto tick_start = std::chrono::steady_clock::now();
     helper->clearBuffers(t);
-    helper->dequeueCommands();
+    const auto count = helper->dequeueCommands();
 
     auto& bench = *helper->m_context->bench;
     if(i % 50 == 0)
@@ -220,13 +290,13 @@ Audio::tick_fun makeBenchmarkTick(
 
       auto t1 = std::chrono::steady_clock::now();
       auto total = std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count();
-#if !defined(_MSC_VER)
-      //FIXME: MSVC unordered_map isn't move noexcept so it does not work here in Debug
-      helper->m_context->m_editionQueue.enqueue([plugPtr, bench, total]() mutable {
+      // The map is moved through a pointer: MSVC's unordered_map is not
+      // nothrow-movable, which smallfun requires
+      helper->m_context->m_editionQueue.enqueue(
+          [plugPtr, b = std::make_unique<ossia::bench_map>(bench), total]() mutable {
         if(plugPtr)
-          plugPtr->slot_bench(std::move(bench), total);
+          plugPtr->slot_bench(std::move(*b), total);
       });
-#endif
 
       for(auto& p : bench)
       {
@@ -239,8 +309,42 @@ Audio::tick_fun makeBenchmarkTick(
 
       helper->main(t);
     }
+    helper->recordTelemetry(t, tick_start, count);
 
     i++;
   };
 }
+
+Audio::tick_fun makeOfflineBenchmarkTick(
+    ossia::tick_setup_options opt, Execution::DocumentPlugin& plug,
+    const std::shared_ptr<Execution::BaseScenarioElement>& scenar,
+    OfflineBenchmarkTimings& timings)
+{
+  return [helper = std::make_shared<AudioTickHelper>(opt, plug, scenar),
+          &timings](const ossia::audio_tick_state& t) {
+    Audio::execution_status.store(ossia::transport_status::playing);
+
+    const auto tick_start = std::chrono::steady_clock::now();
+    helper->clearBuffers(t);
+    const auto count = helper->dequeueCommands();
+
+    auto& bench = *helper->m_context->bench;
+    bench.measure = true;
+
+    auto t0 = std::chrono::steady_clock::now();
+    helper->main(t);
+    auto t1 = std::chrono::steady_clock::now();
+
+    timings.ticks.push_back(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count());
+
+    for(auto& p : bench)
+    {
+      if(p.second)
+        timings.nodes[p.first].push_back(*p.second);
+      p.second = {};
+    }
+    helper->recordTelemetry(t, tick_start, count);
+  };
+}
 }
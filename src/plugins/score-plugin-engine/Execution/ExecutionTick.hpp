@@ -2,16 +2,24 @@
 #include <Audio/AudioTick.hpp>
 
 #include <ossia/dataflow/graph/graph_interface.hpp>
+#include <ossia/dataflow/graph/tick_setup.hpp>
 
 namespace Execution
 {
 class DocumentPlugin;
 class BaseScenarioElement;
+struct OfflineBenchmarkTimings;
+namespace Settings
+{
+class Model;
+}
 }
 namespace Execution
 {
 using tick_fun = ossia::audio_engine::fun_type;
 
+ossia::tick_setup_options tickOptions(const Execution::Settings::Model& settings);
+
 tick_fun makeExecutionTick(
     ossia::tick_setup_options opt, Execution::DocumentPlugin& plug,
     const std::shared_ptr<Execution::BaseScenarioElement>& scenar);
@@ -19,4 +27,15 @@ tick_fun makeExecutionTick(
 tick_fun makeBenchmarkTick(
     ossia::tick_setup_options opt, Execution::DocumentPlugin& plug,
     const std::shared_ptr<Execution::BaseScenarioElement>& scenar);
+
+/**
+ * @brief Tick used for offline benchmarks
+ *
+ * Every tick is measured: the total duration and the duration of each node
+ * are appended to the given timings, which must outlive the tick function.
+ */
+tick_fun makeOfflineBenchmarkTick(
+    ossia::tick_setup_options opt, Execution::DocumentPlugin& plug,
+    const std::shared_ptr<Execution::BaseScenarioElement>& scenar,
+    OfflineBenchmarkTimings& timings);
 }
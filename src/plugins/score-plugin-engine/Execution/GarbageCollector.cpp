@@ -0,0 +1,64 @@
+#include "GarbageCollector.hpp"
+
+#include <ossia/detail/thread.hpp>
+
+#if defined(__linux__)
+#include <sys/resource.h>
+#endif
+
+namespace Execution
+{
+GarbageCollector::~GarbageCollector()
+{
+  stop();
+}
+
+void GarbageCollector::start(GCCommandQueue& queue)
+{
+  stop();
+
+  m_running = true;
+  m_thread = std::thread{[this, &queue] {
+    ossia::set_thread_name("ossia gc");
+#if defined(__linux__)
+    // On Linux the nice value is per-thread: this only lowers our priority.
+    ::setpriority(PRIO_PROCESS, 0, 10);
+#endif
+    run(queue);
+  }};
+}
+
+void GarbageCollector::stop()
+{
+  if(m_thread.joinable())
+  {
+    m_running = false;
+    m_thread.join();
+  }
+}
+
+void GarbageCollector::run(GCCommandQueue& queue)
+{
+  while(m_running.load(std::memory_order_relaxed))
+  {
+    const auto depth = int64_t(queue.size_approx());
+    auto prev = m_maxDepth.load(std::memory_order_relaxed);
+    while(prev < depth
+          && !m_maxDepth.compare_exchange_weak(prev, depth, std::memory_order_relaxed))
+      ;
+
+    int64_t n = 0;
+    for(;;)
+    {
+      GCCommand gc;
+      if(!queue.try_dequeue(gc))
+        break;
+      n++;
+    }
+    if(n > 0)
+      m_reclaimed.fetch_add(n, std::memory_order_relaxed);
+
+    std::this_thread::sleep_for(period);
+  }
+}
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include <Process/ExecutionContext.hpp>
+
+#include <score_plugin_engine_export.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+namespace Execution
+{
+/**
+ * @brief Low-priority thread which frees what the audio thread is done with.
+ *
+ * The audio thread moves every command it has run into the GC queue
+ * instead of destroying it, as this can free graph nodes, buffers, etc.
+ * This thread empties the queue at a fixed period, so that the reclamation
+ * latency does not depend on how busy the GUI thread is.
+ * Nodes which must be destroyed on the GUI thread are created with
+ * Execution::make_gui_thread_node.
+ */
+class SCORE_PLUGIN_ENGINE_EXPORT GarbageCollector
+{
+public:
+  //! Maximum delay between an enqueue and the matching destruction
+  static constexpr std::chrono::milliseconds period{10};
+
+  GarbageCollector() = default;
+  GarbageCollector(const GarbageCollector&) = delete;
+  GarbageCollector& operator=(const GarbageCollector&) = delete;
+  ~GarbageCollector();
+
+  //! The queue must outlive the collector or the next call to stop()
+  void start(GCCommandQueue& queue);
+
+  //! Joins the thread. Items enqueued afterwards are left in the queue.
+  void stop();
+
+  bool running() const noexcept { return m_thread.joinable(); }
+
+  //! Largest queue depth observed since the last call
+  int64_t takeMaxDepth() noexcept
+  {
+    return m_maxDepth.exchange(0, std::memory_order_relaxed);
+  }
+
+  //! Number of items destroyed since the last call
+  int64_t takeReclaimed() noexcept
+  {
+    return m_reclaimed.exchange(0, std::memory_order_relaxed);
+  }
+
+private:
+  void run(GCCommandQueue& queue);
+
+  std::thread m_thread;
+  std::atomic_bool m_running{};
+  std::atomic<int64_t> m_maxDepth{};
+  std::atomic<int64_t> m_reclaimed{};
+};
+}
@@ -0,0 +1,238 @@
+#include "OfflineBenchmark.hpp"
+
+#include <Process/ExecutionCommand.hpp>
+#include <Process/Process.hpp>
+
+#include <Scenario/Document/Interval/IntervalModel.hpp>
+
+#include <Audio/AudioApplicationPlugin.hpp>
+#include <Audio/AudioTick.hpp>
+#include <Execution/BaseScenarioComponent.hpp>
+#include <Execution/Clock/DefaultClock.hpp>
+#include <Execution/DocumentPlugin.hpp>
+#include <Execution/ExecutionTick.hpp>
+#include <Execution/Settings/ExecutorModel.hpp>
+
+#include <score/application/GUIApplicationContext.hpp>
+
+#include <ossia/audio/audio_engine.hpp>
+#include <ossia/dataflow/execution_state.hpp>
+#include <ossia/dataflow/graph_node.hpp>
+#include <ossia/detail/flicks.hpp>
+
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <numeric>
+
+namespace Execution
+{
+namespace
+{
+//! Statistics over a set of durations in nanoseconds, reported in microseconds
+QJsonObject latencyStatistics(std::vector<int64_t>& v, int64_t budget)
+{
+  QJsonObject obj;
+  obj["count"] = qint64(v.size());
+  if(v.empty())
+    return obj;
+
+  std::sort(v.begin(), v.end());
+  const auto percentile = [&v](double p) {
+    const auto idx = std::size_t(std::llround(p * double(v.size() - 1)));
+    return double(v[std::min(idx, v.size() - 1)]) / 1e3;
+  };
+
+  const double total = std::accumulate(v.begin(), v.end(), 0.);
+  obj["mean_us"] = total / double(v.size()) / 1e3;
+  obj["p50_us"] = percentile(0.50);
+  obj["p90_us"] = percentile(0.90);
+  obj["p99_us"] = percentile(0.99);
+  obj["max_us"] = double(v.back()) / 1e3;
+  obj["over_budget"] = qint64(v.end() - std::upper_bound(v.begin(), v.end(), budget));
+
+  // Power-of-two histogram: bucket k counts the durations in [2^(k-1), 2^k[ µs
+  QJsonArray histogram;
+  int64_t upper = 1000;
+  auto it = v.begin();
+  while(it != v.end())
+  {
+    auto next = std::lower_bound(it, v.end(), upper);
+    if(next != it)
+    {
+      histogram.push_back(QJsonObject{
+          {"lt_us", double(upper) / 1e3}, {"count", qint64(next - it)}});
+    }
+    it = next;
+    upper *= 2;
+  }
+  obj["histogram"] = histogram;
+  return obj;
+}
+
+QString nodeName(
+    const ossia::graph_node* node,
+    const score::hash_map<const ossia::graph_node*, const Process::ProcessModel*>&
+        procs)
+{
+  if(auto it = procs.find(node); it != procs.end() && it->second)
+  {
+    const auto& proc = *it->second;
+    return QStringLiteral("%1 (%2)").arg(proc.metadata().getName()).arg(proc.id_val());
+  }
+
+  auto label = QString::fromStdString(node->label());
+  if(label.isEmpty())
+    label = QStringLiteral("node");
+  return QStringLiteral("%1 (%2)").arg(label).arg(quintptr(node), 0, 16);
+}
+}
+
+bool runOfflineBenchmark(
+    DocumentPlugin& plug, Scenario::IntervalModel& itv,
+    const OfflineBenchmarkOptions& options)
+{
+  using namespace std::chrono;
+  auto& app = plug.context().doc.app;
+  auto& settings = app.settings<Execution::Settings::Model>();
+
+  // Per-node measurements require the graph to be created with a bench_map.
+  // The setting is restored afterwards, initBench does not save it.
+  const bool bench = settings.getBench();
+  settings.initBench(true);
+
+  // The benchmark drives the ticks itself:
+  // the running engine must not tick concurrently.
+  auto& audio = app.guiApplicationPlugin<Audio::ApplicationPlugin>();
+  if(audio.audio)
+    audio.audio->set_tick([](const ossia::audio_tick_state&) {});
+
+  plug.reload(true, itv);
+
+  const int bs = std::max(1, options.bufferSize);
+  const int rate = std::max(1, options.rate);
+  {
+    auto& st = *plug.context().execState;
+    st.bufferSize = bs;
+    st.sampleRate = rate;
+    st.modelToSamplesRatio = rate / ossia::flicks_per_second<double>;
+    st.samplesToModelRatio = ossia::flicks_per_second<double> / rate;
+  }
+
+  const double duration = options.duration > 0.
+                              ? options.duration
+                              : itv.duration.defaultDuration().msec() / 1000.;
+  const int64_t tick_count
+      = std::max(int64_t(1), int64_t(std::ceil(duration * rate / bs)));
+  const int64_t budget = int64_t(1e9 * bs / rate);
+
+  OfflineBenchmarkTimings timings;
+  timings.ticks.reserve(tick_count);
+
+  DefaultClock clock{plug.context()};
+  clock.play(TimeVal::zero(), *plug.baseScenario());
+
+  auto tick = makeOfflineBenchmarkTick(
+      tickOptions(settings), plug, plug.baseScenario(), timings);
+
+  std::vector<float> inputs(std::size_t(options.inputs) * bs);
+  std::vector<float> outputs(std::size_t(options.outputs) * bs);
+  std::vector<float*> input_ptrs, output_ptrs;
+  for(int i = 0; i < options.inputs; i++)
+    input_ptrs.push_back(inputs.data() + i * bs);
+  for(int i = 0; i < options.outputs; i++)
+    output_ptrs.push_back(outputs.data() + i * bs);
+
+  ossia::audio_tick_state t;
+  t.inputs = input_ptrs.data();
+  t.outputs = output_ptrs.data();
+  t.n_in = options.inputs;
+  t.n_out = options.outputs;
+  t.frames = bs;
+
+  auto& data = *plug.contextData();
+  TelemetryStatistics telemetry;
+  const auto t0 = steady_clock::now();
+  for(int64_t i = 0; i < tick_count; i++)
+  {
+    t.seconds = double(i * bs) / rate;
+    tick(t);
+
+    // What DocumentPlugin's timer would do if the event loop was running
+    ExecutionCommand cmd;
+    while(data.m_editionQueue.try_dequeue(cmd))
+      cmd();
+    GCCommand gc;
+    while(data.m_gcQueue.try_dequeue(gc))
+      ;
+
+    // The ring would drop the records of the next ticks once full
+    TickTelemetry tt;
+    while(data.telemetry.pop(tt))
+    {
+      telemetry.totalTicks++;
+      telemetry.totalXruns += tt.xrun;
+      telemetry.commands += tt.commands;
+      telemetry.gc += tt.gc;
+    }
+  }
+  const auto t1 = steady_clock::now();
+  telemetry.totalDropped = data.telemetry.takeDropped();
+  const double wall = duration_cast<nanoseconds>(t1 - t0).count() / 1e9;
+
+  QJsonObject nodes;
+  for(auto& [node, times] : timings.nodes)
+  {
+    nodes[nodeName(node, data.setupContext.proc_map)]
+        = latencyStatistics(times, budget);
+  }
+
+  clock.stop(*plug.baseScenario());
+  plug.finished();
+  settings.initBench(bench);
+
+  if(audio.audio)
+    audio.audio->set_tick(Audio::makePauseTick(app));
+
+  QJsonObject executor{
+      {"scheduling", settings.getScheduling()},
+      {"ordering", settings.getOrdering()},
+      {"merging", settings.getMerging()},
+      {"commit", settings.getCommit()},
+      {"tick", settings.getTick()},
+      {"parallel", settings.getParallel()},
+      {"threads", settings.getThreads()}};
+
+  QJsonObject root{
+      {"buffer_size", bs},
+      {"rate", rate},
+      {"duration_s", double(tick_count * bs) / rate},
+      {"wall_time_s", wall},
+      {"realtime_factor", wall > 0. ? double(tick_count * bs) / rate / wall : 0.},
+      {"budget_us", double(budget) / 1e3},
+      {"executor", executor},
+      {"ticks", latencyStatistics(timings.ticks, budget)},
+      {"telemetry",
+       QJsonObject{
+           {"ticks", qint64(telemetry.totalTicks)},
+           {"xruns", qint64(telemetry.totalXruns)},
+           {"commands", qint64(telemetry.commands)},
+           {"gc", qint64(telemetry.gc)},
+           {"dropped", qint64(telemetry.totalDropped)}}},
+      {"nodes", nodes}};
+
+  QFile f{options.output};
+  if(!f.open(QIODevice::WriteOnly))
+  {
+    qWarning() << "Cannot write benchmark results to" << options.output;
+    return false;
+  }
+  f.write(QJsonDocument{root}.toJson());
+  return true;
+}
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include <ossia/detail/hash_map.hpp>
+
+#include <QString>
+
+#include <score_plugin_engine_export.h>
+
+#include <cinttypes>
+#include <vector>
+
+namespace ossia
+{
+class graph_node;
+}
+namespace Scenario
+{
+class IntervalModel;
+}
+namespace Execution
+{
+class DocumentPlugin;
+
+//! Raw timings, in nanoseconds, gathered during an offline benchmark
+struct OfflineBenchmarkTimings
+{
+  std::vector<int64_t> ticks;
+  ossia::hash_map<const ossia::graph_node*, std::vector<int64_t>> nodes;
+};
+
+struct OfflineBenchmarkOptions
+{
+  //! JSON file in which the results are written
+  QString output;
+
+  int bufferSize{512};
+  int rate{48000};
+  int inputs{2};
+  int outputs{2};
+
+  //! Seconds of execution, 0 meaning the default duration of the interval
+  double duration{};
+};
+
+/**
+ * @brief Runs an interval faster than realtime and saves its timings.
+ *
+ * The interval is executed on the calling thread with silent inputs, one
+ * buffer after the other, without waiting for any sound card.
+ * The per-tick and per-node latencies (p50, p99, max, histogram) are then
+ * written as JSON along with the executor settings that were used,
+ * so that runs with different settings can be compared.
+ *
+ * @return false if the results could not be saved.
+ */
+SCORE_PLUGIN_ENGINE_EXPORT
+bool runOfflineBenchmark(
+    DocumentPlugin& plug, Scenario::IntervalModel& itv,
+    const OfflineBenchmarkOptions& options);
+}
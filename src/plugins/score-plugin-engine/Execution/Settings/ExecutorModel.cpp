@@ -35,6 +35,10 @@ SETTINGS_PARAMETER_IMPL(Commit){
     QStringLiteral("score_plugin_engine/Commit"), CommitPolicies{}.Merged};
 SETTINGS_PARAMETER_IMPL(Tick){
     QStringLiteral("score_plugin_engine/Tick"), TickPolicies{}.Buffer};
+SETTINGS_PARAMETER_IMPL(Budget){
+    QStringLiteral("score_plugin_engine/Budget"), BudgetPolicies{}.Ignore};
+SETTINGS_PARAMETER_IMPL(BudgetShare){
+    QStringLiteral("score_plugin_engine/BudgetShare"), 50};
 SETTINGS_PARAMETER_IMPL(Parallel){QStringLiteral("score_plugin_engine/Parallel"), false};
 SETTINGS_PARAMETER_IMPL(ExecutionListening){
     QStringLiteral("score_plugin_engine/ExecListening"), true};
@@ -50,9 +54,9 @@ SETTINGS_PARAMETER_IMPL(TransportValueCompilation){
 static auto list()
 {
   return std::tie(
-      Clock, Rate, Threads, Scheduling, Ordering, Merging, Commit, Tick, Parallel,
-      ExecutionListening, Logging, Bench, ScoreOrder, ValueCompilation,
-      TransportValueCompilation);
+      Clock, Rate, Threads, Scheduling, Ordering, Merging, Commit, Tick, Budget,
+      BudgetShare, Parallel, ExecutionListening, Logging, Bench, ScoreOrder,
+      ValueCompilation, TransportValueCompilation);
 }
 }
 
@@ -108,6 +112,8 @@ SCORE_SETTINGS_PARAMETER_CPP(QString, Model, Ordering)
 SCORE_SETTINGS_PARAMETER_CPP(QString, Model, Merging)
 SCORE_SETTINGS_PARAMETER_CPP(QString, Model, Commit)
 SCORE_SETTINGS_PARAMETER_CPP(QString, Model, Tick)
+SCORE_SETTINGS_PARAMETER_CPP(QString, Model, Budget)
+SCORE_SETTINGS_PARAMETER_CPP(int, Model, BudgetShare)
 SCORE_SETTINGS_PARAMETER_CPP(int, Model, Rate)
 SCORE_SETTINGS_PARAMETER_CPP(int, Model, Threads)
 SCORE_SETTINGS_PARAMETER_CPP(bool, Model, Parallel)
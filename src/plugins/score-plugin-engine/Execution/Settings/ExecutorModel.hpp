@@ -60,6 +60,14 @@ struct TickPolicies
   const QString Precise{"Precise"};
   operator QStringList() const { return {Buffer, ScoreAccurate, Precise}; }
 };
+//! What to do with a process which takes too much of the audio tick
+struct BudgetPolicies
+{
+  const QString Ignore{"Ignore"};
+  const QString Warn{"Warn"};
+  const QString Bypass{"Bypass"};
+  operator QStringList() const { return {Ignore, Warn, Bypass}; }
+};
 class SCORE_PLUGIN_ENGINE_EXPORT Model : public score::SettingsDelegateModel
 {
   W_OBJECT(Model)
@@ -70,6 +78,8 @@ class SCORE_PLUGIN_ENGINE_EXPORT Model : public score::SettingsDelegateModel
   QString m_Merging;
   QString m_Commit;
   QString m_Tick;
+  QString m_Budget;
+  int m_BudgetShare{};
   int m_Rate{};
   int m_Threads{};
   bool m_Parallel{};
@@ -101,6 +111,8 @@ public:
   SCORE_SETTINGS_PARAMETER_HPP(SCORE_PLUGIN_ENGINE_EXPORT, QString, Merging)
   SCORE_SETTINGS_PARAMETER_HPP(SCORE_PLUGIN_ENGINE_EXPORT, QString, Commit)
   SCORE_SETTINGS_PARAMETER_HPP(SCORE_PLUGIN_ENGINE_EXPORT, QString, Tick)
+  SCORE_SETTINGS_PARAMETER_HPP(SCORE_PLUGIN_ENGINE_EXPORT, QString, Budget)
+  SCORE_SETTINGS_PARAMETER_HPP(SCORE_PLUGIN_ENGINE_EXPORT, int, BudgetShare)
   SCORE_SETTINGS_PARAMETER_HPP(SCORE_PLUGIN_ENGINE_EXPORT, int, Rate)
   SCORE_SETTINGS_PARAMETER_HPP(SCORE_PLUGIN_ENGINE_EXPORT, int, Threads)
   SCORE_SETTINGS_PARAMETER_HPP(SCORE_PLUGIN_ENGINE_EXPORT, bool, Parallel)
@@ -119,6 +131,8 @@ SCORE_SETTINGS_PARAMETER(Model, Ordering)
 SCORE_SETTINGS_PARAMETER(Model, Merging)
 SCORE_SETTINGS_PARAMETER(Model, Commit)
 SCORE_SETTINGS_PARAMETER(Model, Tick)
+SCORE_SETTINGS_PARAMETER(Model, Budget)
+SCORE_SETTINGS_PARAMETER(Model, BudgetShare)
 SCORE_SETTINGS_PARAMETER(Model, Rate)
 SCORE_SETTINGS_PARAMETER(Model, Threads)
 SCORE_SETTINGS_PARAMETER(Model, Parallel)
@@ -34,6 +34,8 @@ Presenter::Presenter(Model& m, View& v, QObject* parent)
   SETTINGS_PRESENTER(Threads);
   SETTINGS_PRESENTER(Logging);
   SETTINGS_PRESENTER(Bench);
+  SETTINGS_PRESENTER(Budget);
+  SETTINGS_PRESENTER(BudgetShare);
   SETTINGS_PRESENTER(ExecutionListening);
   //SETTINGS_PRESENTER(ScoreOrder);
   SETTINGS_PRESENTER(ValueCompilation);
@@ -36,6 +36,12 @@ View::View()
       "Benchmark\nIf this is enabled, processes will show their relative resource usage "
       "at the top right.",
       Bench);
+  SETTINGS_UI_COMBOBOX_SETUP(
+      "Budget policy\nWhat to do with a process which uses more than its share of "
+      "the audio buffer duration.",
+      Budget, BudgetPolicies{});
+  SETTINGS_UI_SPINBOX_SETUP("Budget share (%)", BudgetShare);
+  m_BudgetShare->setRange(1, 100);
   //lay->addRow(group);
   //}
   // advanced settings
@@ -82,8 +88,10 @@ SETTINGS_UI_COMBOBOX_IMPL(Scheduling)
 SETTINGS_UI_COMBOBOX_IMPL(Ordering)
 SETTINGS_UI_COMBOBOX_IMPL(Merging)
 SETTINGS_UI_COMBOBOX_IMPL(Commit)
+SETTINGS_UI_COMBOBOX_IMPL(Budget)
 
 SETTINGS_UI_SPINBOX_IMPL(Threads)
+SETTINGS_UI_SPINBOX_IMPL(BudgetShare)
 
 SETTINGS_UI_TOGGLE_IMPL(ExecutionListening)
 SETTINGS_UI_TOGGLE_IMPL(ScoreOrder)
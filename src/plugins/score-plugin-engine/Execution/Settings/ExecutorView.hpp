@@ -25,6 +25,8 @@ public:
   SETTINGS_UI_COMBOBOX_HPP(Merging)
   SETTINGS_UI_COMBOBOX_HPP(Commit)
   SETTINGS_UI_COMBOBOX_HPP(Tick)
+  SETTINGS_UI_COMBOBOX_HPP(Budget)
+  SETTINGS_UI_SPINBOX_HPP(BudgetShare)
 
   SETTINGS_UI_TOGGLE_HPP(Logging)
   SETTINGS_UI_TOGGLE_HPP(Bench)
@@ -18,17 +18,24 @@
 #include <ossia/dataflow/execution_state.hpp>
 #include <ossia/dataflow/nodes/faust/faust_node.hpp>
 
+#include <QCryptographicHash>
+#include <QDateTime>
 #include <QDialog>
 #include <QDialogButtonBox>
+#include <QDir>
 #include <QDirIterator>
 #include <QFileInfo>
 #include <QPlainTextEdit>
+#include <QSaveFile>
+#include <QStandardPaths>
 #include <QTimer>
 #include <QVBoxLayout>
 
 #include <Faust/Commands.hpp>
 #include <Faust/Utils.hpp>
 
+#include <faust/dsp/libfaust.h>
+
 #include <wobjectimpl.h>
 
 #if __has_include(<sndfile.h>)
@@ -73,6 +80,103 @@ static std::vector<std::string> getLibpaths()
   return ret;
 }
 
+static QString factoryCachePath(
+    const std::string& sha_key, const std::string& target,
+    const std::vector<const char*>& argv)
+{
+  static const QString folder = [] {
+    const auto cache = QStandardPaths::standardLocations(
+        QStandardPaths::StandardLocation::CacheLocation);
+    if(cache.empty())
+      return QString{};
+
+    QDir::root().mkpath(cache.first());
+    QDir cache_dir{cache.first()};
+    cache_dir.mkdir("faust");
+    if(!cache_dir.cd("faust"))
+      return QString{};
+    return cache_dir.absolutePath();
+  }();
+
+  if(folder.isEmpty() || sha_key.empty())
+    return {};
+
+  // The machine code is only valid for a given libfaust / LLVM and CPU
+  QCryptographicHash h{QCryptographicHash::Sha256};
+  h.addData(QByteArray::fromStdString(sha_key));
+  h.addData(QByteArray::fromStdString(target));
+  h.addData(QByteArray{getCLibFaustVersion()});
+  for(const char* arg : argv)
+    h.addData(QByteArray{arg});
+
+  return folder + QChar('/') + QString::fromLatin1(h.result().toHex())
+         + QStringLiteral(".fmc");
+}
+
+// Removes the least recently used factories once the cache is too large
+static void trimFactoryCache(const QString& folder)
+{
+  static constexpr qint64 max_cache_size = 256 * 1024 * 1024;
+
+  QDir dir{folder};
+  const auto files
+      = dir.entryInfoList({QStringLiteral("*.fmc")}, QDir::Files, QDir::Time);
+  qint64 total = 0;
+  for(const QFileInfo& file : files)
+  {
+    total += file.size();
+    if(total > max_cache_size)
+      QFile::remove(file.absoluteFilePath());
+  }
+}
+
+/**
+ * Compiling a Faust program with LLVM takes a long time: the machine code of
+ * the factories is kept in the cache folder, keyed by the expanded program,
+ * which includes the content of the imported libraries, and the options.
+ */
+static llvm_dsp_factory* createCachedDSPFactory(
+    const std::string& str, std::vector<const char*>& argv, const char* triple,
+    std::string& err)
+{
+  std::string sha_key;
+  std::string expand_err;
+  expandDSPFromString("score", str, argv.size(), argv.data(), sha_key, expand_err);
+
+  const std::string target = triple[0] ? std::string(triple) : getDSPMachineTarget();
+  const auto path = factoryCachePath(sha_key, target, argv);
+  if(!path.isEmpty())
+  {
+    if(QFile f{path}; f.open(QIODevice::ReadWrite))
+    {
+      std::string read_err;
+      const auto code = f.readAll().toStdString();
+      if(auto fac = readDSPFactoryFromMachine(code, target, read_err))
+      {
+        // Most recently used first when trimming the cache
+        f.setFileTime(QDateTime::currentDateTime(), QFileDevice::FileModificationTime);
+        return fac;
+      }
+    }
+  }
+
+  auto fac = createDSPFactoryFromString(
+      "score", str, argv.size(), argv.data(), triple, err, -1);
+
+  if(fac && !path.isEmpty())
+  {
+    QSaveFile f{path};
+    if(f.open(QIODevice::WriteOnly))
+    {
+      const auto code = writeDSPFactoryToMachine(fac, target);
+      f.write(code.data(), code.size());
+      if(f.commit())
+        trimFactoryCache(QFileInfo{path}.absolutePath());
+    }
+  }
+  return fac;
+}
+
 FaustEffectModel::FaustEffectModel(
     TimeVal t, const QString& faustProgram, const Id<Process::ProcessModel>& id,
     QObject* parent)
@@ -260,8 +364,7 @@ Process::ScriptChangeResult FaustEffectModel::reload()
   err.resize(4097);
   llvm_dsp_factory* fac{};
 
-  fac = createDSPFactoryFromString(
-      "score", str, argv.size(), argv.data(), triple, err, -1);
+  fac = createCachedDSPFactory(str, argv, triple, err);
 
   if(err[0] != 0)
   {
@@ -284,11 +387,15 @@ Process::ScriptChangeResult FaustEffectModel::reload()
   if(faustIsMidi(*obj))
   {
     delete obj;
-    deleteDSPFactory(fac);
-    fac = nullptr;
     {
+      // The voices are compiled from the same program and options: libfaust
+      // gives back the cached factory, still alive, instead of compiling it.
+      // The polyphonic factory itself cannot be written to the cache.
       auto midi_fac = ossia::nodes::createCustomPolyDSPFactoryFromString(
           "score", str, argv.size(), argv.data(), triple, err, -1);
+      deleteDSPFactory(fac);
+      fac = nullptr;
+
       auto midi_obj = midi_fac->createPolyDSPInstance(4, true, true);
       {
         auto fac = midi_fac;
@@ -1,5 +1,9 @@
 #include "GfxApplicationPlugin.hpp"
 
+#include <Gfx/Filter/Process.hpp>
+#include <Gfx/Graph/ShaderCache.hpp>
+#include <Gfx/Settings/Model.hpp>
+
 #include <Execution/DocumentPlugin.hpp>
 
 #include <core/document/Document.hpp>
@@ -28,4 +32,49 @@ void ApplicationPlugin::on_createdDocument(score::Document& doc)
   doc.model().addPluginModel(new DocumentPlugin{doc.context(), &doc.model()});
 }
 
+void ApplicationPlugin::on_loadedDocument(score::Document& doc)
+{
+  // Compile the shaders of the document in the background, so that they
+  // are ready when the execution starts.
+  std::vector<std::pair<QByteArray, QShader::Stage>> shaders;
+  for(auto filter : doc.model().findChildren<Gfx::Filter::Model*>())
+  {
+    const auto& prog = filter->processedProgram();
+    if(prog.vertex.isEmpty() || prog.fragment.isEmpty())
+      continue;
+    shaders.emplace_back(prog.vertex.toUtf8(), QShader::VertexStage);
+    shaders.emplace_back(prog.fragment.toUtf8(), QShader::FragmentStage);
+  }
+  if(shaders.empty())
+    return;
+
+  using namespace score::gfx;
+  const auto api = context.settings<Gfx::Settings::Model>().graphicsApiEnum();
+
+  // Same versions as the ones chosen when creating the render state
+  QShaderVersion version;
+  switch(api)
+  {
+    case GraphicsApi::OpenGL: {
+      static const score::GLCapabilities caps;
+      version = caps.qShaderVersion;
+      break;
+    }
+    case GraphicsApi::Vulkan:
+      version = QShaderVersion(100);
+      break;
+    case GraphicsApi::D3D11:
+      version = QShaderVersion(50);
+      break;
+    case GraphicsApi::Metal:
+      version = QShaderVersion(12);
+      break;
+    default:
+      version = QShaderVersion(120);
+      break;
+  }
+
+  ShaderCache::prewarm(api, version, std::move(shaders));
+}
+
 }
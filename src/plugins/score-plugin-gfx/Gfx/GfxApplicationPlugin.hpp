@@ -26,5 +26,6 @@ public:
 
 protected:
   void on_createdDocument(score::Document& doc) override;
+  void on_loadedDocument(score::Document& doc) override;
 };
 }
@@ -2,43 +2,68 @@
 
 #include <Gfx/Graph/RenderState.hpp>
 
+#include <score/tools/ThreadPool.hpp>
+
 #include <ossia/detail/algorithms.hpp>
 #include <ossia/detail/mutex.hpp>
 
+#include <QCryptographicHash>
+#include <QDir>
+#include <QFile>
+#include <QSaveFile>
+#include <QStandardPaths>
+
 namespace score::gfx
 {
 
+ShaderCache& ShaderCache::instance() noexcept
+{
+  static ShaderCache self;
+  return self;
+}
+
+ShaderCache::Baker& ShaderCache::baker(GraphicsApi api, const QShaderVersion& version)
+{
+  auto ver_it = ossia::find_if(m_bakers, [&](const auto& p) {
+    return p->api == api && p->version == version;
+  });
+  if(ver_it != m_bakers.end())
+    return **ver_it;
+
+  m_bakers.push_back(std::make_unique<Baker>(api, version));
+  return *m_bakers.back();
+}
+
 const std::pair<QShader, QString>& ShaderCache::get(
     GraphicsApi api, const QShaderVersion& version, const QByteArray& shader,
     QShader::Stage stage)
 {
-  static std::mutex mut;
-  static ShaderCache self TS_GUARDED_BY(mut);
+  auto& self = instance();
+  std::lock_guard<std::mutex> m{self.m_mutex};
 
-  std::lock_guard<std::mutex> m{mut};
+  Baker& b = self.baker(api, version);
+  if(auto it = b.shaders.find(shader); it != b.shaders.end())
+    return *it->second;
 
-  auto ver_it = ossia::find_if(self.m_bakers, [&](const auto& p) {
-    return p->api == api && p->version == version;
-  });
-  Baker* bb{};
-  if(ver_it == self.m_bakers.end())
-  {
-    self.m_bakers.push_back(std::make_unique<Baker>(api, version));
-    bb = self.m_bakers.back().get();
-  }
-  else
+  const auto path = cachePath(api, version, shader, stage);
+  if(QShader cached = loadCached(path); cached.isValid())
   {
-    bb = ver_it->get();
+    auto res = b.shaders.insert(
+        {shader, std::make_unique<std::pair<QShader, QString>>(
+                     std::move(cached), QString{})});
+    return *res.first->second;
   }
 
-  Baker& b = *bb;
-  if(auto it = b.shaders.find(shader); it != b.shaders.end())
-    return it->second;
-
   b.baker.setSourceString(shader, stage);
   QShader baked = b.baker.bake();
-  auto res = b.shaders.insert({shader, {std::move(baked), b.baker.errorMessage()}});
-  return res.first->second;
+  QString err = b.baker.errorMessage();
+  if(err.isEmpty())
+    saveCached(path, baked);
+
+  auto res = b.shaders.insert(
+      {shader, std::make_unique<std::pair<QShader, QString>>(
+                   std::move(baked), std::move(err))});
+  return *res.first->second;
 }
 
 const std::pair<QShader, QString>&
@@ -47,11 +72,120 @@ ShaderCache::get(const RenderState& v, const QByteArray& shader, QShader::Stage
   return ShaderCache::get(v.api, v.version, shader, stage);
 }
 
+void ShaderCache::prewarm(
+    GraphicsApi api, const QShaderVersion& version,
+    std::vector<std::pair<QByteArray, QShader::Stage>> shaders)
+{
+  if(shaders.empty())
+    return;
+
+  auto ptr = std::make_shared<std::vector<std::pair<QByteArray, QShader::Stage>>>(
+      std::move(shaders));
+  score::TaskPool::instance().post([api, version, ptr] {
+    auto& self = instance();
+
+    // The baking is done outside of the lock so that get() is not blocked
+    // for the whole duration of the prewarm
+    QShaderBaker baker;
+    setupBaker(baker, api, version);
+    for(auto& [shader, stage] : *ptr)
+    {
+      {
+        std::lock_guard<std::mutex> m{self.m_mutex};
+        auto& shaders = self.baker(api, version).shaders;
+        if(shaders.find(shader) != shaders.end())
+          continue;
+      }
+
+      const auto path = cachePath(api, version, shader, stage);
+      QShader res = loadCached(path);
+      if(!res.isValid())
+      {
+        baker.setSourceString(shader, stage);
+        res = baker.bake();
+        if(!baker.errorMessage().isEmpty())
+          continue;
+        saveCached(path, res);
+      }
+
+      std::lock_guard<std::mutex> m{self.m_mutex};
+      self.baker(api, version)
+          .shaders.insert(
+              {shader, std::make_unique<std::pair<QShader, QString>>(
+                           std::move(res), QString{})});
+    }
+  });
+}
+
+QString ShaderCache::cachePath(
+    GraphicsApi api, const QShaderVersion& version, const QByteArray& shader,
+    QShader::Stage stage)
+{
+  static const QString folder = [] {
+    const auto cache = QStandardPaths::standardLocations(
+        QStandardPaths::StandardLocation::CacheLocation);
+    if(cache.empty())
+      return QString{};
+
+    QDir::root().mkpath(cache.first());
+    QDir cache_dir{cache.first()};
+    cache_dir.mkdir("shaders");
+    if(!cache_dir.cd("shaders"))
+      return QString{};
+    return cache_dir.absolutePath();
+  }();
+
+  if(folder.isEmpty())
+    return {};
+
+  // The serialization format of QShader may change across Qt versions
+  QCryptographicHash h{QCryptographicHash::Sha256};
+  h.addData(shader);
+  h.addData(QByteArray::number(int(stage)));
+  h.addData(QByteArray::number(int(api)));
+  h.addData(QByteArray::number(version.version()));
+  h.addData(QByteArray::number(int(version.flags())));
+  h.addData(QByteArrayLiteral(QT_VERSION_STR));
+
+  return folder + QChar('/') + QString::fromLatin1(h.result().toHex())
+         + QStringLiteral(".qsb");
+}
+
+QShader ShaderCache::loadCached(const QString& path)
+{
+  if(path.isEmpty())
+    return {};
+
+  QFile f{path};
+  if(!f.open(QIODevice::ReadOnly))
+    return {};
+
+  return QShader::fromSerialized(f.readAll());
+}
+
+void ShaderCache::saveCached(const QString& path, const QShader& shader)
+{
+  if(path.isEmpty() || !shader.isValid())
+    return;
+
+  QSaveFile f{path};
+  if(!f.open(QIODevice::WriteOnly))
+    return;
+  f.write(shader.serialized());
+  f.commit();
+}
+
 ShaderCache::ShaderCache() { }
 
 ShaderCache::Baker::Baker(GraphicsApi api, const QShaderVersion& version)
     : api{api}
     , version{version}
+{
+  setupBaker(baker, api, version);
+}
+
+void ShaderCache::setupBaker(
+    QShaderBaker& baker, GraphicsApi api, const QShaderVersion& version)
 {
   switch(api)
   {
@@ -6,6 +6,10 @@
 
 #include <ossia/detail/hash_map.hpp>
 
+#include <score_plugin_gfx_export.h>
+
+#include <mutex>
+
 #if __has_include(<QtShaderTools/rhi/qshaderbaker.h>)
 #include <QtShaderTools/rhi/qshaderbaker.h>
 #else
@@ -16,8 +20,12 @@ namespace score::gfx
 {
 /**
  * @brief Cache of baked QShader instances
+ *
+ * Successfully baked shaders are also saved in the cache folder, keyed by
+ * a hash of their source, stage, graphics API and shader version, so that
+ * they do not have to be compiled again in the next sessions.
  */
-struct ShaderCache
+struct SCORE_PLUGIN_GFX_EXPORT ShaderCache
 {
 public:
   /**
@@ -31,9 +39,17 @@ public:
   get(GraphicsApi api, const QShaderVersion& v, const QByteArray& shader,
       QShader::Stage stage);
 
-private:
-  ShaderCache();
+  /**
+   * @brief Bakes shaders in the background, before they are first requested.
+   *
+   * Errors are ignored here: they are reported when the shader is requested
+   * through get().
+   */
+  static void
+  prewarm(GraphicsApi api, const QShaderVersion& v,
+          std::vector<std::pair<QByteArray, QShader::Stage>> shaders);
 
+private:
   struct Baker
   {
     explicit Baker(GraphicsApi api, const QShaderVersion& v);
@@ -41,9 +57,24 @@ private:
     GraphicsApi api;
     QShaderVersion version;
     QShaderBaker baker;
-    ossia::hash_map<QByteArray, std::pair<QShader, QString>> shaders;
+
+    // Stored by pointer: get() returns references which must stay valid
+    // when prewarm() inserts from another thread
+    ossia::hash_map<QByteArray, std::unique_ptr<std::pair<QShader, QString>>> shaders;
   };
 
+  ShaderCache();
+  static ShaderCache& instance() noexcept;
+  Baker& baker(GraphicsApi api, const QShaderVersion& v);
+
+  static void setupBaker(QShaderBaker& baker, GraphicsApi api, const QShaderVersion& v);
+  static QString cachePath(
+      GraphicsApi api, const QShaderVersion& v, const QByteArray& shader,
+      QShader::Stage stage);
+  static QShader loadCached(const QString& path);
+  static void saveCached(const QString& path, const QShader& shader);
+
+  std::mutex m_mutex;
   std::vector<std::unique_ptr<Baker>> m_bakers;
 };
 }
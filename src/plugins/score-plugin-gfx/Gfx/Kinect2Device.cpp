@@ -281,7 +281,7 @@ void kinect2_camera::processColor(libfreenect2::Frame* colorFrame)
       auto f = rgbFrames.newFrame();
       const auto bytes = frame->width * frame->height * frame->bytes_per_pixel;
 
-      const auto storage = Video::initFrameBuffer(*f, bytes);
+      const auto storage = rgbFrames.initFrameBuffer(*f, bytes);
       memcpy(storage, frame->data, bytes);
       f->linesize[0] = frame->width * frame->bytes_per_pixel;
       f->format = AVPixelFormat::AV_PIX_FMT_BGR0;
@@ -302,7 +302,7 @@ void kinect2_camera::processIR(libfreenect2::Frame* irFrame)
       auto f = irFrames.newFrame();
       const auto bytes = frame->width * frame->height * frame->bytes_per_pixel;
 
-      const auto storage = Video::initFrameBuffer(*f, bytes);
+      const auto storage = irFrames.initFrameBuffer(*f, bytes);
       memcpy(storage, frame->data, bytes);
       f->linesize[0] = frame->width * frame->bytes_per_pixel;
       f->format = AVPixelFormat::AV_PIX_FMT_GRAYF32LE;
@@ -324,7 +324,7 @@ void kinect2_camera::processDepth(libfreenect2::Frame* depthFrame)
       auto f = depthFrames.newFrame();
       const auto bytes = frame->width * frame->height * frame->bytes_per_pixel;
 
-      const auto storage = Video::initFrameBuffer(*f, bytes);
+      const auto storage = depthFrames.initFrameBuffer(*f, bytes);
       memcpy(storage, frame->data, bytes);
       f->linesize[0] = frame->width * frame->bytes_per_pixel;
       f->format = AVPixelFormat::AV_PIX_FMT_GRAYF32LE;
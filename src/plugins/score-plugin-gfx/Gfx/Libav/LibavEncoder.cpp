@@ -5,6 +5,8 @@ extern "C" {
 #include <libswresample/swresample.h>
 }
 
+#include <ossia/detail/thread.hpp>
+
 #include <QDebug>
 
 #if SCORE_HAS_LIBAV
@@ -23,6 +25,7 @@ LibavEncoder::LibavEncoder(const LibavOutputSettings& set)
 
 LibavEncoder::~LibavEncoder()
 {
+  stop();
   av_dict_free(&opt);
 }
 
@@ -104,15 +107,44 @@ int LibavEncoder::start()
     m_formatContext = nullptr;
     return 1;
   }
+
+  // Color conversion and encoding of the video, and the muxing of all the
+  // packets, happen on the encoder thread: the render thread only has to
+  // read the frames back, and the audio thread never waits for the disk.
+  m_freeFrames.clear();
+  m_queuedFrames.clear();
+  for(auto& frame : m_videoFrames)
+    m_freeFrames.push_back(&frame);
+  m_stopping = false;
+  m_videoPts = 0;
+  m_droppedFrames = 0;
+
+  // The audio thread never allocates: it takes its packets from this pool
+  for(int i = 0; i < audio_queue_size; i++)
+    m_freePackets.enqueue(av_packet_alloc());
+  m_droppedPackets = 0;
+
+  m_thread = std::thread{[this] {
+    ossia::set_thread_name("ossia libav");
+    run_thread();
+  }};
+  m_audioOpen = true;
   return 0;
 }
 
 int LibavEncoder::add_frame(tcb::span<ossia::float_vector> vec)
 {
-#if LIBAVUTIL_VERSION_INT >= AV_VERSION_INT(57, 24, 100)
-  if(!m_formatContext)
-    return 1;
+  // Both are sequentially consistent: either stop() sees that the audio
+  // thread is here and waits, or the audio thread sees that it is closed.
+  m_audioWriters.fetch_add(1);
+  const int ret = m_audioOpen.load() ? encode_audio_frame(vec) : 1;
+  m_audioWriters.fetch_sub(1);
+  return ret;
+}
 
+int LibavEncoder::encode_audio_frame(tcb::span<ossia::float_vector> vec)
+{
+#if LIBAVUTIL_VERSION_INT >= AV_VERSION_INT(57, 24, 100)
   const int channels = vec.size();
   if(channels == 0) // Write silence?
     return 1;
@@ -123,7 +155,6 @@ int LibavEncoder::add_frame(tcb::span<ossia::float_vector> vec)
   next_frame->sample_rate = stream.enc->sample_rate;
   next_frame->format = stream.enc->sample_fmt;
   next_frame->nb_samples = stream.enc->frame_size;
-  qDebug() << vec[0].size() << next_frame->nb_samples;
   next_frame->ch_layout.nb_channels = channels;
   next_frame->ch_layout.order = AV_CHANNEL_ORDER_UNSPEC;
 
@@ -152,39 +183,128 @@ int LibavEncoder::add_frame(tcb::span<ossia::float_vector> vec)
 
     stream.encoder->add_frame(*next_frame, resample_outf);
   }
-  return stream.write_audio_frame(m_formatContext, next_frame);
+  return stream.write_audio_frame(next_frame, [this](AVPacket* pkt) {
+    push_audio_packet(pkt);
+    return 0;
+  });
 #endif
   return 1;
 }
 
-int LibavEncoder::add_frame(
-    const unsigned char* data, AVPixelFormat fmt, int width, int height)
+LibavVideoFrame* LibavEncoder::acquire_video_frame(std::chrono::microseconds timeout)
 {
-  if(!m_formatContext)
-    return 1;
+  std::unique_lock lock{m_mutex};
+  m_frameFreed.wait_for(
+      lock, timeout, [this] { return m_stopping || !m_freeFrames.empty(); });
+  if(m_stopping)
+    return nullptr;
 
-  auto& stream = streams[video_stream_index];
-  auto next_frame = stream.get_video_frame();
-  next_frame->format = fmt;
-  next_frame->width = width;
-  next_frame->height = height;
-  next_frame->data[0] = (unsigned char*)data;
-  /*
-  auto out = next_frame->data[0];
-  for(int y = 0; y < height; y++)
-  {
-    for(int x = 0; x < width; x++)
+  if(m_freeFrames.empty())
+  {
+    // The encoder cannot keep up: the frame is dropped but keeps its place
+    // in the timeline of the stream.
+    m_videoPts++;
+    m_droppedFrames++;
+    return nullptr;
+  }
+
+  auto frame = m_freeFrames.front();
+  m_freeFrames.pop_front();
+  frame->pts = m_videoPts++;
+  return frame;
+}
+
+void LibavEncoder::push_video_frame(LibavVideoFrame* frame)
+{
+  {
+    std::lock_guard lock{m_mutex};
+    m_queuedFrames.push_back(frame);
+  }
+  m_workQueued.signal();
+}
+
+void LibavEncoder::push_audio_packet(AVPacket* pkt)
+{
+  AVPacket* queued{};
+  if(!m_freePackets.try_dequeue(queued))
+  {
+    // The encoder thread cannot keep up
+    av_packet_unref(pkt);
+    m_droppedPackets++;
+    return;
+  }
+
+  // Only the reference to the data is moved.
+  // There is always room: the queue can hold every packet of the pool.
+  av_packet_move_ref(queued, pkt);
+  m_queuedPackets.try_enqueue(queued);
+  m_workQueued.signal();
+}
+
+int LibavEncoder::write_packet(AVPacket* pkt)
+{
+  return av_interleaved_write_frame(m_formatContext, pkt);
+}
+
+void LibavEncoder::run_thread()
+{
+  for(;;)
+  {
+    m_workQueued.wait();
+
+    // What is still queued when stopping is written before the trailer
+    if(AVPacket* packet{}; m_queuedPackets.try_dequeue(packet))
+    {
+      // Leaves the packet blank
+      if(int ret = write_packet(packet); ret < 0)
+      {
+        qDebug() << "Error while writing output packet: " << av_to_string(ret);
+        exit(1);
+      }
+
+      m_freePackets.try_enqueue(packet);
+      continue;
+    }
+
+    LibavVideoFrame* frame{};
+    {
+      std::lock_guard lock{m_mutex};
+      if(!m_queuedFrames.empty())
+      {
+        frame = m_queuedFrames.front();
+        m_queuedFrames.pop_front();
+      }
+      else if(m_stopping)
+      {
+        return;
+      }
+    }
+
+    if(frame)
     {
-      out[0] = data[0];
-      out[1] = data[1];
-      out[2] = data[2];
+      encode_video_frame(*frame);
 
-      out += 4;
-      data += 4;
+      {
+        std::lock_guard lock{m_mutex};
+        m_freeFrames.push_back(frame);
+      }
+      m_frameFreed.notify_one();
     }
   }
-*/
-  return streams[video_stream_index].write_video_frame(m_formatContext, next_frame);
+}
+
+int LibavEncoder::encode_video_frame(const LibavVideoFrame& frame)
+{
+  auto& stream = streams[video_stream_index];
+  auto next_frame = stream.get_video_frame();
+  next_frame->format = frame.format;
+  next_frame->width = frame.width;
+  next_frame->height = frame.height;
+  next_frame->data[0] = (unsigned char*)frame.data.constData();
+  next_frame->pts = frame.pts;
+
+  return stream.write_video_frame(
+      next_frame, [this](AVPacket* pkt) { return write_packet(pkt); });
 }
 
 int LibavEncoder::stop()
@@ -192,6 +312,33 @@ int LibavEncoder::stop()
   if(!m_formatContext)
     return 0;
 
+  // No packet can be pushed after this, and the audio thread does not use the
+  // streams anymore
+  m_audioOpen = false;
+  while(m_audioWriters.load() > 0)
+    std::this_thread::yield();
+
+  if(m_thread.joinable())
+  {
+    {
+      std::lock_guard lock{m_mutex};
+      m_stopping = true;
+    }
+    m_workQueued.signal();
+    m_frameFreed.notify_all();
+    m_thread.join();
+
+    if(m_droppedFrames > 0)
+      qDebug() << "Libav encoder: dropped" << m_droppedFrames << "video frames";
+    if(m_droppedPackets > 0)
+      qDebug() << "Libav encoder: dropped" << m_droppedPackets.load() << "audio packets";
+  }
+
+  for(AVPacket* pkt{}; m_queuedPackets.try_dequeue(pkt);)
+    av_packet_free(&pkt);
+  for(AVPacket* pkt{}; m_freePackets.try_dequeue(pkt);)
+    av_packet_free(&pkt);
+
   const AVOutputFormat* fmt = m_formatContext->oformat;
   av_write_trailer(m_formatContext);
 
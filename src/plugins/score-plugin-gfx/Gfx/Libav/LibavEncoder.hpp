@@ -4,9 +4,22 @@
 #if SCORE_HAS_LIBAV
 #include <Gfx/Libav/LibavOutputSettings.hpp>
 
+#include <ossia/detail/lockfree_queue.hpp>
 #include <ossia/detail/pod_vector.hpp>
 
 #include <tcb/span.hpp>
+
+#include <QByteArray>
+
+#include <lightweightsemaphore.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
 extern "C" {
 #include <libavcodec/avcodec.h>
 #include <libavdevice/avdevice.h>
@@ -18,17 +31,46 @@ namespace Gfx
 {
 
 struct OutputStream;
+
+//! A video frame read back from the GPU, waiting to be encoded
+struct LibavVideoFrame
+{
+  QByteArray data;
+  AVPixelFormat format{AV_PIX_FMT_RGBA};
+  int width{};
+  int height{};
+  int64_t pts{};
+};
+
 struct LibavEncoder
 {
+  //! Number of video frames which can wait for the encoder thread
+  static constexpr int video_queue_size = 3;
+
+  //! Number of audio packets which can wait for the encoder thread
+  static constexpr int audio_queue_size = 256;
+
   explicit LibavEncoder(const LibavOutputSettings& set);
   ~LibavEncoder();
   void enumerate();
 
   int start();
   int add_frame(tcb::span<ossia::float_vector>);
-  int add_frame(const unsigned char* data, AVPixelFormat fmt, int width, int height);
   int stop();
 
+  /**
+   * Called by the render thread to get a frame to fill.
+   *
+   * If the encoder thread is still busy with all the frames, waits at most
+   * for timeout, then gives up: the frame is dropped and nullptr is returned.
+   * The data of the frame is the buffer of a previous frame, which can be
+   * swapped with a readback buffer to reuse its memory.
+   */
+  LibavVideoFrame* acquire_video_frame(std::chrono::microseconds timeout);
+
+  //! Sends a frame obtained with acquire_video_frame to the encoder thread
+  void push_video_frame(LibavVideoFrame* frame);
+
   bool available() const noexcept { return m_formatContext; }
 
   LibavOutputSettings m_set;
@@ -39,6 +81,42 @@ struct LibavEncoder
 
   int audio_stream_index = 0;
   int video_stream_index = 0;
+
+private:
+  void run_thread();
+  int encode_audio_frame(tcb::span<ossia::float_vector>);
+  int encode_video_frame(const LibavVideoFrame& frame);
+
+  //! Called by the audio thread: the packet is muxed by the encoder thread
+  void push_audio_packet(AVPacket* pkt);
+  int write_packet(AVPacket* pkt);
+
+  // Only the encoder thread writes to m_formatContext once started
+  LibavVideoFrame m_videoFrames[video_queue_size];
+  std::deque<LibavVideoFrame*> m_freeFrames;
+  std::deque<LibavVideoFrame*> m_queuedFrames;
+  std::mutex m_mutex;
+  std::condition_variable m_frameFreed;
+  std::thread m_thread;
+  bool m_stopping{true};
+
+  // The audio packets are allocated in start(), then go back and forth
+  // between the audio thread and the encoder thread through these queues,
+  // which each have a single producer and a single consumer.
+  moodycamel::ReaderWriterQueue<AVPacket*> m_queuedPackets{audio_queue_size};
+  moodycamel::ReaderWriterQueue<AVPacket*> m_freePackets{audio_queue_size};
+
+  // Signaled once per queued packet or frame, and once to stop
+  moodycamel::LightweightSemaphore m_workQueued;
+
+  // stop() closes the audio input, then waits until the audio thread is out
+  // of add_frame before closing the streams
+  std::atomic_bool m_audioOpen{};
+  std::atomic_int m_audioWriters{};
+
+  int64_t m_videoPts{};
+  int64_t m_droppedFrames{};
+  std::atomic<int64_t> m_droppedPackets{};
 };
 
 }
@@ -53,9 +53,21 @@ void LibavEncoderNode::render()
     int bytes = m_readback.data.size();
     if(bytes > 0 && bytes >= sz)
     {
-      encoder.add_frame(
-          (const unsigned char*)m_readback.data.constData(), AV_PIX_FMT_RGBA,
-          m_readback.pixelSize.width(), m_readback.pixelSize.height());
+      // Short hiccups of the encoder are absorbed by waiting a bit, but if it is
+      // too slow for the frame rate the frame is dropped instead of slowing down
+      // the rendering.
+      const std::chrono::microseconds timeout{
+          m_settings.rate > 0 ? int64_t(0.5e6 / m_settings.rate) : 0};
+      if(auto frame = encoder.acquire_video_frame(timeout))
+      {
+        // The encoder thread takes the readback buffer, and the next readback
+        // goes into the memory of a frame which was already encoded.
+        std::swap(frame->data, m_readback.data);
+        frame->format = AV_PIX_FMT_RGBA;
+        frame->width = m_readback.pixelSize.width();
+        frame->height = m_readback.pixelSize.height();
+        encoder.push_video_frame(frame);
+      }
     }
   }
 }
@@ -460,7 +460,9 @@ struct OutputStream
     return this->cache_input_frame;
   }
 
-  int write_video_frame(AVFormatContext* fmt_ctx, AVFrame* input_frame)
+  //! write_packet(AVPacket*) passes each encoded packet to the muxer
+  template <typename F>
+  int write_video_frame(AVFrame* input_frame, F&& write_packet)
   {
 #if LIBSWSCALE_VERSION_INT >= AV_VERSION_INT(7, 5, 100)
     // scale the frame
@@ -473,7 +475,7 @@ struct OutputStream
 
     tmp_frame->quality = FF_LAMBDA_MAX; //c->global_quality;
     tmp_frame->pict_type = AV_PICTURE_TYPE_I;
-    tmp_frame->pts++;
+    tmp_frame->pts = input_frame->pts;
 
     // send the frame to the encoder
     ret = avcodec_send_frame(enc, tmp_frame);
@@ -499,7 +501,7 @@ struct OutputStream
       tmp_pkt->stream_index = st->index;
       tmp_pkt->flags |= AV_PKT_FLAG_KEY;
 
-      ret = av_interleaved_write_frame(fmt_ctx, tmp_pkt);
+      ret = write_packet(tmp_pkt);
       if(ret < 0)
       {
         qDebug() << "Error while writing output packet: " << av_to_string(ret);
@@ -529,7 +531,8 @@ struct OutputStream
   //     return av_rescale_rnd(in, DST_RATE, d, AV_ROUND_NEAR_INF);
   //   }
 
-  int write_audio_frame(AVFormatContext* fmt_ctx, AVFrame* input_frame)
+  template <typename F>
+  int write_audio_frame(AVFrame* input_frame, F&& write_packet)
   {
     // send the frame to the encoder
     int ret = avcodec_send_frame(enc, input_frame);
@@ -554,7 +557,7 @@ struct OutputStream
       av_packet_rescale_ts(tmp_pkt, enc->time_base, st->time_base);
       tmp_pkt->stream_index = st->index;
 
-      ret = av_interleaved_write_frame(fmt_ctx, tmp_pkt);
+      ret = write_packet(tmp_pkt);
       if(ret < 0)
       {
         qDebug() << "Error while writing output packet: " << av_to_string(ret);
@@ -14,196 +14,370 @@
 #include <QQmlContext>
 #include <QQmlEngine>
 
+#include <algorithm>
+
 namespace JS
 {
 
-js_node::js_node(ossia::execution_state& st)
-    : m_st{st}
+namespace
+{
+struct js_engine_holder
 {
-  m_not_threadable = true;
+  std::shared_ptr<js_engine> engine;
+  ~js_engine_holder()
+  {
+    if(engine)
+      engine->close();
+  }
+};
+thread_local js_engine_holder g_engine;
 }
 
-js_node::~js_node()
+js_engine::js_engine()
+    : m_engine{new QQmlEngine}
+{
+}
+
+js_engine::~js_engine()
 {
   delete m_engine;
 }
 
-void js_node::setupComponent()
+const std::shared_ptr<js_engine>& js_engine::current()
 {
-  SCORE_ASSERT(m_object);
-  m_object->setParent(m_engine);
+  if(!g_engine.engine)
+    g_engine.engine = std::make_shared<js_engine>();
+  return g_engine.engine;
+}
+
+void js_engine::retire(std::unique_ptr<js_instance> inst)
+{
+  {
+    std::lock_guard l{m_mutex};
+    if(!m_closed)
+    {
+      m_retired.push_back(std::move(inst));
+      m_hasRetired.store(true, std::memory_order_release);
+      return;
+    }
+  }
+
+  // The thread has exited and deleted the objects of the instance
+  inst.reset();
+}
+
+void js_engine::collect()
+{
+  if(!m_hasRetired.load(std::memory_order_acquire))
+    return;
+
+  std::vector<std::unique_ptr<js_instance>> retired;
+  {
+    // Never wait for the GUI thread here, the next tick will do
+    std::unique_lock l{m_mutex, std::try_to_lock};
+    if(!l.owns_lock())
+      return;
+    retired.swap(m_retired);
+    m_hasRetired.store(false, std::memory_order_relaxed);
+  }
+}
+
+void js_engine::close()
+{
+  std::lock_guard l{m_mutex};
+  m_closed = true;
+  m_retired.clear();
+
+  // Also deletes the objects of the instances still held by nodes
+  delete m_engine;
+  m_engine = nullptr;
+}
+
+js_instance::js_instance(
+    js_node& node, std::shared_ptr<js_engine> e, const QString& script, int generation)
+    : node{node}
+    , engine{std::move(e)}
+    , generation{generation}
+{
+  auto& qml = engine->engine();
+  context = new QQmlContext{qml.rootContext(), &qml};
+
+  // Written through the state of the tick like the outputs of the other
+  // nodes: writes outside of a tick are dropped
+  execFuncs = new ExecStateWrapper{
+      node.m_st.exec_devices(),
+      [this](ossia::net::parameter_base& param, const ossia::value_port& port) {
+    if(tickState)
+      tickState->insert(param, port);
+  }, context};
+  context->setContextProperty("Device", execFuncs);
+
+  QObject::connect(
+      execFuncs, &ExecStateWrapper::system, qApp,
+      [](const QString& code) {
+    std::thread{[code] { ::system(code.toStdString().c_str()); }}.detach();
+      },
+      Qt::QueuedConnection);
+
+  if(auto* js_panel = score::GUIAppContext().findPanel<JS::PanelDelegate>())
+  {
+    QObject::connect(
+        execFuncs, &ExecStateWrapper::exec, js_panel, &JS::PanelDelegate::evaluate,
+        Qt::QueuedConnection);
+    QObject::connect(
+        execFuncs, &ExecStateWrapper::compute, execFuncs,
+        [this, js_panel](const QString& code, const QString& cbname) {
+      // Exec thread
+
+      // Callback ran in UI thread
+      auto cb = [this, cbname](QVariant v) {
+        // Go back to the thread of this instance,
+        // we have to go through the normal engine exec ctx
+        ossia::qt::run_async(execFuncs, [this, v, cbname] {
+          if(!object)
+            return;
+          auto mo = object->metaObject();
+          for(int i = 0; i < mo->methodCount(); i++)
+          {
+            if(mo->method(i).name() == cbname)
+            {
+              mo->method(i).invoke(
+                  object, Qt::DirectConnection, QGenericReturnArgument(),
+                  QArgument<QVariant>{"v", v});
+            }
+          }
+        });
+      };
+
+      // Go to ui thread
+      ossia::qt::run_async(js_panel, [js_panel, code, cb]() {
+        js_panel->compute(code, cb); // This invokes cb
+      });
+        },
+        Qt::DirectConnection);
+  }
+
+  if((object = createJSObject(script, &qml, context)))
+    setupComponent();
+}
+
+js_instance::~js_instance()
+{
+  delete object;
+  delete context;
+}
+
+void js_instance::setupComponent()
+{
+  SCORE_ASSERT(object);
+  object->setParent(context);
   int input_i = 0;
   int output_i = 0;
+  auto& inlets = node.root_inputs();
+  auto& outlets = node.root_outputs();
 
-  for(auto n : m_object->children())
+  for(auto n : object->children())
   {
     if(auto imp_in = qobject_cast<Impulse*>(n))
     {
-      m_jsInlets.push_back(imp_in);
-      m_impulseInlets.push_back({imp_in, m_inlets[input_i++]});
+      jsInlets.push_back(imp_in);
+      impulseInlets.push_back({imp_in, inlets[input_i++]});
     }
     else if(auto ctrl_in = qobject_cast<ControlInlet*>(n))
     {
-      m_jsInlets.push_back(ctrl_in);
-      m_ctrlInlets.push_back({ctrl_in, m_inlets[input_i++]});
+      jsInlets.push_back(ctrl_in);
+      ctrlInlets.push_back({ctrl_in, inlets[input_i++]});
     }
     else if(auto val_in = qobject_cast<ValueInlet*>(n))
     {
-      m_jsInlets.push_back(val_in);
-      m_valInlets.push_back({val_in, m_inlets[input_i++]});
+      jsInlets.push_back(val_in);
+      valInlets.push_back({val_in, inlets[input_i++]});
     }
     else if(auto aud_in = qobject_cast<AudioInlet*>(n))
     {
-      m_jsInlets.push_back(aud_in);
-      m_audInlets.push_back({aud_in, m_inlets[input_i++]});
+      jsInlets.push_back(aud_in);
+      audInlets.push_back({aud_in, inlets[input_i++]});
     }
     else if(auto mid_in = qobject_cast<MidiInlet*>(n))
     {
-      m_jsInlets.push_back(mid_in);
-      m_midInlets.push_back({mid_in, m_inlets[input_i++]});
+      jsInlets.push_back(mid_in);
+      midInlets.push_back({mid_in, inlets[input_i++]});
     }
     else if(auto val_out = qobject_cast<ValueOutlet*>(n))
     {
-      m_valOutlets.push_back({val_out, m_outlets[output_i++]});
+      valOutlets.push_back({val_out, outlets[output_i++]});
     }
     else if(auto aud_out = qobject_cast<AudioOutlet*>(n))
     {
-      m_audOutlets.push_back({aud_out, m_outlets[output_i++]});
+      audOutlets.push_back({aud_out, outlets[output_i++]});
     }
     else if(auto mid_out = qobject_cast<MidiOutlet*>(n))
     {
-      m_midOutlets.push_back({mid_out, m_outlets[output_i++]});
+      midOutlets.push_back({mid_out, outlets[output_i++]});
     }
   }
 }
 
-void js_node::setScript(const QString& val)
+void js_instance::setControl(std::size_t index, const QVariant& val)
+{
+  if(index >= jsInlets.size())
+    return;
+  if(auto v = qobject_cast<ValueInlet*>(jsInlets[index]))
+    v->setValue(val);
+  else if(auto v = qobject_cast<ControlInlet*>(jsInlets[index]))
+    v->setValue(val);
+}
+
+void js_instance::impulse(std::size_t index)
+{
+  if(index >= jsInlets.size())
+    return;
+  if(auto v = qobject_cast<Impulse*>(jsInlets[index]))
+    v->impulse();
+}
+
+js_node::js_node(ossia::execution_state& st)
+    : m_st{st}
+{
+}
+
+js_node::~js_node()
+{
+  // Each instance is deleted on the thread of its engine
+  for(auto& inst : m_instances)
+  {
+    auto engine = inst->engine;
+    engine->retire(std::move(inst));
+  }
+}
+
+void js_node::setScript(QString script)
 {
-  if(!m_engine)
+  m_script = std::move(script);
+  m_generation++;
+}
+
+void js_node::setControl(std::size_t index, const QVariant& val)
+{
+  if(index >= m_controls.size())
   {
-    m_engine = new QQmlEngine;
-    m_execFuncs = new ExecStateWrapper{
-        m_st.exec_devices(), [&]<typename... Args>(Args&&... args) {
-      m_st.insert(std::forward<Args>(args)...);
-    }, m_engine};
-    m_engine->rootContext()->setContextProperty("Device", m_execFuncs);
+    m_controls.resize(index + 1);
+    m_controlStamps.resize(index + 1);
+  }
+  m_controls[index] = val;
+  m_controlStamps[index] = ++m_controlStamp;
+}
 
-    QObject::connect(
-        m_execFuncs, &ExecStateWrapper::system, qApp,
-        [](const QString& code) {
-      std::thread{[code] { ::system(code.toStdString().c_str()); }}.detach();
-        },
-        Qt::QueuedConnection);
+void js_node::impulse(std::size_t index)
+{
+  m_pendingImpulses.push_back(index);
+}
 
-    if(auto* js_panel = score::GUIAppContext().findPanel<JS::PanelDelegate>())
-    {
-      QObject::connect(
-          m_execFuncs, &ExecStateWrapper::exec, js_panel, &JS::PanelDelegate::evaluate,
-          Qt::QueuedConnection);
-      QObject::connect(
-          m_execFuncs, &ExecStateWrapper::compute, m_execFuncs,
-          [this, js_panel](const QString& code, const QString& cbname) {
-        // Exec thread
-
-        // Callback ran in UI thread
-        auto cb = [this, cbname](QVariant v) {
-          // Go back to exec thread, we have to go through the normal engine exec ctx
-          ossia::qt::run_async(m_execFuncs, [this, v, cbname] {
-            auto mo = m_object->metaObject();
-            for(int i = 0; i < mo->methodCount(); i++)
-            {
-              if(mo->method(i).name() == cbname)
-              {
-                mo->method(i).invoke(
-                    m_object, Qt::DirectConnection, QGenericReturnArgument(),
-                    QArgument<QVariant>{"v", v});
-              }
-            }
-          });
-        };
+void js_node::run(
+    const ossia::token_request& tk, ossia::exec_state_facade estate) noexcept
+{
+  const auto& engine = js_engine::current();
+  engine->collect();
 
-        // Go to ui thread
-        ossia::qt::run_async(js_panel, [js_panel, code, cb]() {
-          js_panel->compute(code, cb); // This invokes cb
-        });
-          },
-          Qt::DirectConnection);
+  auto it = std::find_if(m_instances.begin(), m_instances.end(), [&](auto& inst) {
+    return inst->engine == engine;
+  });
+  if(it != m_instances.end() && (*it)->generation != m_generation)
+  {
+    // Made for the previous ports: we are on the thread of its engine
+    m_instances.erase(it);
+    it = m_instances.end();
+  }
+
+  if(it == m_instances.end())
+  {
+    if(m_script.isEmpty())
+      return;
+
+    // First tick of this script on this thread
+    m_instances.push_back(
+        std::make_unique<js_instance>(*this, engine, m_script, m_generation));
+    it = std::prev(m_instances.end());
+  }
+
+  auto& inst = **it;
+  if(!inst.object)
+    return;
+
+  inst.controlStamps.resize(m_controlStamps.size());
+  for(std::size_t i = 0; i < m_controlStamps.size(); i++)
+  {
+    if(inst.controlStamps[i] != m_controlStamps[i])
+    {
+      inst.setControl(i, *m_controls[i]);
+      inst.controlStamps[i] = m_controlStamps[i];
     }
   }
+  for(auto index : m_pendingImpulses)
+    inst.impulse(index);
+  m_pendingImpulses.clear();
 
-  m_jsInlets.clear();
-  m_ctrlInlets.clear();
-  m_impulseInlets.clear();
-  m_valInlets.clear();
-  m_audInlets.clear();
-  m_midInlets.clear();
-  m_valOutlets.clear();
-  m_audOutlets.clear();
-  m_midOutlets.clear();
-
-  delete m_object;
-  if((m_object = createJSObject(val, m_engine)))
-    setupComponent();
+  inst.run(tk, estate);
 }
 
-void js_node::run(
+void js_instance::run(
     const ossia::token_request& tk, ossia::exec_state_facade estate) noexcept
 {
-  if(!m_engine || !m_object)
+  if(!object)
     return;
 
-  auto& tick = m_object->tick();
+  auto& tick = object->tick();
   if(!tick.isCallable())
     return;
   // if (t.date == ossia::Zero)
   //   return;
 
   QEventLoop e;
-  if(std::exchange(triggerStart, false))
+  if(std::exchange(node.triggerStart, false))
   {
-    if(m_object->start().isCallable())
-      m_object->start().call();
+    if(object->start().isCallable())
+      object->start().call();
   }
-  if(std::exchange(triggerPause, false))
+  if(std::exchange(node.triggerPause, false))
   {
-    if(m_object->pause().isCallable())
-      m_object->pause().call();
+    if(object->pause().isCallable())
+      object->pause().call();
   }
-  if(std::exchange(triggerResume, false))
+  if(std::exchange(node.triggerResume, false))
   {
-    if(m_object->resume().isCallable())
-      m_object->resume().call();
+    if(object->resume().isCallable())
+      object->resume().call();
   }
-
-  // Copy audio
-  for(std::size_t inl_i = 0; inl_i < m_audInlets.size(); inl_i++)
+  if(auto t = std::exchange(node.triggerTransport, std::nullopt))
+  {
+    QMetaObject::invokeMethod(
+        object, "transport", Qt::DirectConnection, Q_ARG(QVariant, *t));
+  }
+  if(auto t = std::exchange(node.triggerOffset, std::nullopt))
   {
-    auto& dat = m_audInlets[inl_i].second->target<ossia::audio_port>()->get();
+    QMetaObject::invokeMethod(
+        object, "offset", Qt::DirectConnection, Q_ARG(QVariant, *t));
+  }
 
-    const int dat_size = std::ssize(dat);
-    QVector<QVector<double>> audio(dat_size);
-    for(int i = 0; i < dat_size; i++)
-    {
-      const int dat_i_size = dat[i].size();
-      audio[i].resize(dat_i_size);
-      for(int j = 0; j < dat_i_size; j++)
-        audio[i][j] = dat[i][j];
-    }
-    m_audInlets[inl_i].first->setAudio(audio);
+  // Audio is only copied when the script asks for it, see AudioInlet::buffer
+  for(std::size_t inl_i = 0; inl_i < audInlets.size(); inl_i++)
+  {
+    auto& dat = audInlets[inl_i].second->target<ossia::audio_port>()->get();
+    audInlets[inl_i].first->setSource(&dat);
   }
 
   // Copy values
-  for(std::size_t i = 0; i < m_valInlets.size(); i++)
+  for(std::size_t i = 0; i < valInlets.size(); i++)
   {
-    auto& vp = *m_valInlets[i].second->target<ossia::value_port>();
+    auto& vp = *valInlets[i].second->target<ossia::value_port>();
     auto& dat = vp.get_data();
 
-    m_valInlets[i].first->clear();
+    valInlets[i].first->clear();
     if(dat.empty())
     {
       if(vp.is_event)
       {
-        m_valInlets[i].first->setValue(QVariant{});
+        valInlets[i].first->setValue(QVariant{});
       }
       else
       {
@@ -216,8 +390,8 @@ void js_node::run(
       {
         // TODO why not js_value_outbound_visitor ? it makes more sense.
         auto qvar = val.value.apply(ossia::qt::ossia_to_qvariant{});
-        m_valInlets[i].first->setValue(qvar);
-        m_valInlets[i].first->addValue(
+        valInlets[i].first->setValue(qvar);
+        valInlets[i].first->addValue(
             QVariant::fromValue(InValueMessage{(double)val.timestamp, std::move(qvar)}));
       }
     }
@@ -225,55 +399,63 @@ void js_node::run(
 
   // Impulses are handed separately
 
-  for(std::size_t i = 0; i < m_impulseInlets.size(); i++)
+  for(std::size_t i = 0; i < impulseInlets.size(); i++)
   {
-    auto& vp = *m_impulseInlets[i].second->target<ossia::value_port>();
+    auto& vp = *impulseInlets[i].second->target<ossia::value_port>();
     auto& dat = vp.get_data();
 
     for(int k = 0; k < dat.size(); k++)
     {
-      m_impulseInlets[i].first->impulse();
+      impulseInlets[i].first->impulse();
     }
   }
 
   // Copy controls
-  for(std::size_t i = 0; i < m_ctrlInlets.size(); i++)
+  for(std::size_t i = 0; i < ctrlInlets.size(); i++)
   {
-    auto& vp = *m_ctrlInlets[i].second->target<ossia::value_port>();
+    auto& vp = *ctrlInlets[i].second->target<ossia::value_port>();
     auto& dat = vp.get_data();
 
     if(!dat.empty())
     {
       auto var = dat.back().value.apply(ossia::qt::ossia_to_qvariant{});
-      m_ctrlInlets[i].first->setValue(std::move(var));
+      ctrlInlets[i].first->setValue(std::move(var));
     }
   }
 
   // Copy midi
-  for(std::size_t i = 0; i < m_midInlets.size(); i++)
+  for(std::size_t i = 0; i < midInlets.size(); i++)
   {
-    auto& dat = m_midInlets[i].second->target<ossia::midi_port>()->messages;
-    m_midInlets[i].first->setMidi(dat);
+    auto& dat = midInlets[i].second->target<ossia::midi_port>()->messages;
+    midInlets[i].first->setMidi(dat);
   }
 
-  if(m_tickCall.empty())
-    m_tickCall = {{}, {}};
+  const auto [tick_start, d] = estate.timings(tk);
+  for(auto& [js_port, ossia_port] : audOutlets)
+    js_port->setFrames(d);
+
+  if(tickCall.empty())
+    tickCall = {{}, {}};
 
-  m_tickCall[0] = m_engine->toScriptValue(TokenRequestValueType{tk});
-  m_tickCall[1] = m_engine->toScriptValue(ExecutionStateValueType{estate});
+  auto& qml = engine->engine();
+  tickCall[0] = qml.toScriptValue(TokenRequestValueType{tk});
+  tickCall[1] = qml.toScriptValue(ExecutionStateValueType{estate});
+  tickState = &estate;
 
-  auto res = tick.call(m_tickCall);
+  auto res = tick.call(tickCall);
   if(res.isError())
   {
     qDebug() << "JS Error at " << res.property("lineNumber").toInt() << ": "
              << res.toString();
   }
 
-  const auto [tick_start, d] = estate.timings(tk);
-  for(std::size_t i = 0; i < m_valOutlets.size(); i++)
+  for(auto& [js_port, ossia_port] : audInlets)
+    js_port->setSource(nullptr);
+
+  for(std::size_t i = 0; i < valOutlets.size(); i++)
   {
-    auto& ossia_port = *m_valOutlets[i].second->target<ossia::value_port>();
-    auto& js_port = *m_valOutlets[i].first;
+    auto& ossia_port = *valOutlets[i].second->target<ossia::value_port>();
+    auto& js_port = *valOutlets[i].first;
 
     const QJSValue& v = js_port.value();
     if(!v.isNull() && !v.isError() && !v.isUndefined())
@@ -284,13 +466,19 @@ void js_node::run(
     {
       ossia_port.write_value(ossia::qt::value_from_js(std::move(v.value)), v.timestamp);
     }
+    if(const auto buf = js_port.bufferValues(); !buf.empty())
+    {
+      const double step = double(d) / buf.size();
+      for(std::size_t k = 0; k < buf.size(); k++)
+        ossia_port.write_value(float(buf[k]), tick_start + int64_t(k * step));
+    }
     js_port.clear();
   }
 
-  for(std::size_t i = 0; i < m_midOutlets.size(); i++)
+  for(std::size_t i = 0; i < midOutlets.size(); i++)
   {
-    auto& dat = *m_midOutlets[i].second->target<ossia::midi_port>();
-    for(const auto& mess : m_midOutlets[i].first->midi())
+    auto& dat = *midOutlets[i].second->target<ossia::midi_port>();
+    for(const auto& mess : midOutlets[i].first->midi())
     {
       libremidi::message m;
       m.bytes.resize(mess.size());
@@ -300,13 +488,13 @@ void js_node::run(
       }
       dat.messages.push_back(std::move(m));
     }
-    m_midOutlets[i].first->clear();
+    midOutlets[i].first->clear();
   }
 
-  for(std::size_t out = 0; out < m_audOutlets.size(); out++)
+  for(std::size_t out = 0; out < audOutlets.size(); out++)
   {
-    auto& src = m_audOutlets[out].first->audio();
-    auto& snk = m_audOutlets[out].second->target<ossia::audio_port>()->get();
+    auto& src = audOutlets[out].first->audio();
+    auto& snk = audOutlets[out].second->target<ossia::audio_port>()->get();
     snk.resize(src.size());
     for(int chan = 0; chan < src.size(); chan++)
     {
@@ -315,15 +503,18 @@ void js_node::run(
       for(int j = 0; j < src[chan].size(); j++)
         snk[chan][j + tick_start] = src[chan][j];
     }
+    audOutlets[out].first->writeBuffers(snk, tick_start);
   }
 
-  if(std::exchange(triggerStop, false))
+  if(std::exchange(node.triggerStop, false))
   {
-    if(m_object->stop().isCallable())
-      m_object->stop().call();
+    if(object->stop().isCallable())
+      object->stop().call();
   }
   e.processEvents();
-  if(m_gcIndex++ % 64 == 0)
-    m_engine->collectGarbage();
+  tickState = nullptr;
+
+  if(engine->gcIndex++ % 64 == 0)
+    qml.collectGarbage();
 }
 }
@@ -22,9 +22,113 @@
 #include <ossia-qt/time.hpp>
 #include <ossia-qt/token_request.hpp>
 
+#include <QPointer>
+#include <QQmlContext>
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+
 namespace JS
 {
+class js_node;
+struct js_instance;
+
+/**
+ * @brief QQmlEngine of an executor thread.
+ *
+ * A QQmlEngine can only be used from the thread which created it. Each
+ * thread creates one the first time it runs a JS node, and the node keeps
+ * an instance of its script in the engine of each thread which runs it.
+ */
+class js_engine
+{
+public:
+  js_engine();
+  ~js_engine();
+  js_engine(const js_engine&) = delete;
+  js_engine& operator=(const js_engine&) = delete;
+
+  //! Engine of the current thread, created on the first call
+  static const std::shared_ptr<js_engine>& current();
+
+  QQmlEngine& engine() const noexcept { return *m_engine; }
+
+  //! Deletes the instance on the thread of the engine, the next time it runs
+  void retire(std::unique_ptr<js_instance> inst);
+
+  //! Deletes the retired instances, on the thread of the engine
+  void collect();
+
+  //! Deletes the engine when its thread exits
+  void close();
+
+  std::size_t gcIndex{};
+
+private:
+  QQmlEngine* m_engine{};
+
+  std::mutex m_mutex;
+  std::vector<std::unique_ptr<js_instance>> m_retired;
+  std::atomic_bool m_hasRetired{};
+  bool m_closed{};
+};
+
+//! Instance of the script of a js_node, only used on the thread of its engine
+struct js_instance
+{
+  js_instance(
+      js_node& node, std::shared_ptr<js_engine> engine, const QString& script,
+      int generation);
+  ~js_instance();
+  js_instance(const js_instance&) = delete;
+  js_instance& operator=(const js_instance&) = delete;
 
+  void run(const ossia::token_request& t, ossia::exec_state_facade) noexcept;
+  void setupComponent();
+
+  void setControl(std::size_t index, const QVariant& val);
+  void impulse(std::size_t index);
+
+  js_node& node;
+  std::shared_ptr<js_engine> engine;
+  int generation{};
+
+  // Null once the engine is deleted
+  QPointer<QQmlContext> context;
+  QPointer<JS::Script> object;
+  ExecStateWrapper* execFuncs{};
+
+  // Set during the tick, for the device writes of the script
+  ossia::exec_state_facade* tickState{};
+
+  // Version of each control of the node last applied to this instance
+  std::vector<uint64_t> controlStamps;
+
+  std::vector<Inlet*> jsInlets;
+  std::vector<std::pair<ControlInlet*, ossia::inlet_ptr>> ctrlInlets;
+  std::vector<std::pair<Impulse*, ossia::inlet_ptr>> impulseInlets;
+  std::vector<std::pair<ValueInlet*, ossia::inlet_ptr>> valInlets;
+  std::vector<std::pair<ValueOutlet*, ossia::outlet_ptr>> valOutlets;
+  std::vector<std::pair<AudioInlet*, ossia::inlet_ptr>> audInlets;
+  std::vector<std::pair<AudioOutlet*, ossia::outlet_ptr>> audOutlets;
+  std::vector<std::pair<MidiInlet*, ossia::inlet_ptr>> midInlets;
+  std::vector<std::pair<MidiOutlet*, ossia::outlet_ptr>> midOutlets;
+  QJSValueList tickCall;
+};
+
+/**
+ * @brief Node running a JavaScript process.
+ *
+ * The node runs inline on the executor thread which picks it, with the
+ * instance of its script in the engine of that thread. Each thread has
+ * its own instance, so variables set by the script are per thread.
+ * Controls are applied to every instance; impulses and transport events
+ * go to the instance which runs next.
+ * The members below are set by execution commands, between two ticks.
+ */
 class js_node final : public ossia::graph_node
 {
 public:
@@ -32,47 +136,34 @@ public:
   ~js_node();
 
   void run(const ossia::token_request& t, ossia::exec_state_facade) noexcept override;
-  void setupComponent();
-  void setScript(const QString& val);
+
+  //! Script run from the next tick: the ports must match it
+  void setScript(QString script);
+
+  void setControl(std::size_t index, const QVariant& val);
+  void impulse(std::size_t index);
 
   ossia::execution_state& m_st;
 
-  QQmlEngine* m_engine{};
-  std::vector<Inlet*> m_jsInlets;
-  std::vector<std::pair<ControlInlet*, ossia::inlet_ptr>> m_ctrlInlets;
-  std::vector<std::pair<Impulse*, ossia::inlet_ptr>> m_impulseInlets;
-  std::vector<std::pair<ValueInlet*, ossia::inlet_ptr>> m_valInlets;
-  std::vector<std::pair<ValueOutlet*, ossia::outlet_ptr>> m_valOutlets;
-  std::vector<std::pair<AudioInlet*, ossia::inlet_ptr>> m_audInlets;
-  std::vector<std::pair<AudioOutlet*, ossia::outlet_ptr>> m_audOutlets;
-  std::vector<std::pair<MidiInlet*, ossia::inlet_ptr>> m_midInlets;
-  std::vector<std::pair<MidiOutlet*, ossia::outlet_ptr>> m_midOutlets;
-  JS::Script* m_object{};
-  ExecStateWrapper* m_execFuncs{};
-  QJSValueList m_tickCall;
-  std::size_t m_gcIndex{};
+  // Last value of each control, and the version of that value
+  std::vector<std::optional<QVariant>> m_controls;
+  std::vector<uint64_t> m_controlStamps;
+  std::vector<std::size_t> m_pendingImpulses;
 
   bool triggerStart{};
   bool triggerStop{};
   bool triggerPause{};
   bool triggerResume{};
+  std::optional<double> triggerTransport;
+  std::optional<double> triggerOffset;
 
-  void setControl(std::size_t index, const QVariant& val)
-  {
-    if(index > m_jsInlets.size())
-      return;
-    if(auto v = qobject_cast<ValueInlet*>(m_jsInlets[index]))
-      v->setValue(val);
-    else if(auto v = qobject_cast<ControlInlet*>(m_jsInlets[index]))
-      v->setValue(val);
-  }
-  void impulse(std::size_t index)
-  {
-    if(index > m_jsInlets.size())
-      return;
-    if(auto v = qobject_cast<Impulse*>(m_jsInlets[index]))
-      v->impulse();
-  }
+private:
+  QString m_script;
+  int m_generation{};
+  uint64_t m_controlStamp{};
+
+  // Executor threads
+  std::vector<std::unique_ptr<js_instance>> m_instances;
 };
 
 struct js_process final : public ossia::node_process
@@ -85,15 +176,11 @@ struct js_process final : public ossia::node_process
   void resume() override { js().triggerResume = true; }
   void transport_impl(ossia::time_value date) override
   {
-    QMetaObject::invokeMethod(
-        js().m_object, "transport", Qt::DirectConnection,
-        Q_ARG(QVariant, double(date.impl)));
+    js().triggerTransport = double(date.impl);
   }
   void offset_impl(ossia::time_value date) override
   {
-    QMetaObject::invokeMethod(
-        js().m_object, "offset", Qt::DirectConnection,
-        Q_ARG(QVariant, double(date.impl)));
+    js().triggerOffset = double(date.impl);
   }
 };
 
@@ -8,6 +8,8 @@
 
 #include <Scenario/Execution/score2OSSIA.hpp>
 
+#include <Process/Execution/GUIThreadNode.hpp>
+
 #include <Execution/DocumentPlugin.hpp>
 #include <JS/JSProcessModel.hpp>
 
@@ -32,8 +34,9 @@ Component::Component(
 
   if(!isGpu)
   {
+    // The script instances are handed back to their engines from the GUI thread
     std::shared_ptr<js_node> node
-        = ossia::make_node<js_node>(*ctx.execState, *ctx.execState);
+        = Execution::make_gui_thread_node<js_node>(*ctx.execState, *ctx.execState);
     this->node = node;
     auto proc = std::make_shared<js_process>(node);
     m_ossia_process = proc;
@@ -432,6 +435,7 @@ Component::on_cpuScriptChange(const QString& script, Execution::Transaction& com
     // process and entirely recreate a new node, + call update node.
     (*recable)();
 
+    // Compiled by each executor thread the next time it runs the node
     node->setScript(std::move(script));
   });
 
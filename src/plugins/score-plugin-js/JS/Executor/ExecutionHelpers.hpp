@@ -11,7 +11,8 @@
 
 namespace JS
 {
-inline JS::Script* createJSObject(const QString& val, QQmlEngine* m_engine)
+inline JS::Script* createJSObject(
+    const QString& val, QQmlEngine* m_engine, QQmlContext* context = nullptr)
 {
   if(val.trimmed().startsWith("import"))
   {
@@ -33,7 +34,7 @@ inline JS::Script* createJSObject(const QString& val, QQmlEngine* m_engine)
     }
     else
     {
-      auto object = c.create();
+      auto object = c.create(context);
       auto obj = qobject_cast<JS::Script*>(object);
       if(obj)
         return obj;
@@ -54,7 +55,7 @@ inline JS::Script* createJSObject(const QString& val, QQmlEngine* m_engine)
     }
     else
     {
-      auto object = c.create();
+      auto object = c.create(context);
       auto obj = qobject_cast<JS::Script*>(object);
       if(obj)
         return obj;
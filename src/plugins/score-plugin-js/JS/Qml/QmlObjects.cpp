@@ -4,10 +4,14 @@
 
 #include <ossia/math/safe_math.hpp>
 
+#include <QDebug>
 #include <QVector2D>
 #include <QVector3D>
 #include <QVector4D>
 
+#include <algorithm>
+#include <utility>
+
 #include <wobjectimpl.h>
 W_OBJECT_IMPL(JS::Inlet)
 W_OBJECT_IMPL(JS::Outlet)
@@ -167,6 +171,109 @@ void ControlInlet::setValue(QVariant value)
   valueChanged(m_value);
 }
 
+namespace
+{
+// Whether an ArrayBuffer made from QByteArray::fromRawData uses the raw
+// memory, both ways, instead of a copy
+bool arrayBufferSharesMemory(QJSEngine& engine)
+{
+  double value = 0.;
+  auto bytes
+      = QByteArray::fromRawData(reinterpret_cast<const char*>(&value), sizeof(double));
+  auto view = engine.globalObject().property("Float64Array").callAsConstructor(
+      {engine.toScriptValue(bytes)});
+
+  value = 1.;
+  if(view.property(0).toNumber() != 1.)
+    return false;
+
+  view.setProperty(0, 2.);
+  return value == 2.;
+}
+
+bool sharedArrayBuffers(QJSEngine& engine)
+{
+  static const bool shared = [&] {
+    const bool res = arrayBufferSharesMemory(engine);
+    if(!res)
+      qDebug() << "JS: ArrayBuffer does not share memory, copying the buffers";
+    return res;
+  }();
+  return shared;
+}
+}
+
+QJSValue SharedArray::view(QJSEngine& engine, qsizetype count)
+{
+  count = std::max(count, qsizetype(0));
+  if(!sharedArrayBuffers(engine))
+    return copy(engine, nullptr, count);
+
+  if(std::ssize(m_storage) < count)
+  {
+    // The script may still hold views over the previous memory
+    if(!m_storage.empty())
+      m_retired.push_back(std::move(m_storage));
+    m_storage = std::vector<double>(count);
+  }
+  std::fill_n(m_storage.data(), count, 0.);
+  return wrap(engine, m_storage.data(), count);
+}
+
+QJSValue SharedArray::wrap(QJSEngine& engine, const double* data, qsizetype count)
+{
+  count = std::max(count, qsizetype(0));
+  if(!sharedArrayBuffers(engine))
+    return copy(engine, data, count);
+
+  m_shared = true;
+  if(m_view.isUndefined() || data != m_data || count != m_count)
+  {
+    const auto bytes = QByteArray::fromRawData(
+        reinterpret_cast<const char*>(data), count * qsizetype(sizeof(double)));
+    m_view = engine.globalObject().property("Float64Array").callAsConstructor(
+        {engine.toScriptValue(bytes)});
+    m_data = data;
+    m_count = count;
+  }
+  return m_view;
+}
+
+QJSValue SharedArray::copy(QJSEngine& engine, const double* data, qsizetype count)
+{
+  // A new ArrayBuffer, copied from the data, for every call
+  const qsizetype bytes = count * qsizetype(sizeof(double));
+  m_shared = false;
+  m_copy = data ? QByteArray(reinterpret_cast<const char*>(data), bytes)
+                : QByteArray(bytes, 0);
+  m_data = nullptr;
+  m_count = count;
+
+  m_buffer = engine.toScriptValue(m_copy);
+  m_view = engine.globalObject().property("Float64Array").callAsConstructor(
+      {m_buffer});
+  return m_view;
+}
+
+void SharedArray::read()
+{
+  // Copy of what the script wrote in the ArrayBuffer it was given
+  if(m_shared || m_buffer.isUndefined())
+    return;
+
+  m_copy = qjsvalue_cast<QByteArray>(m_buffer);
+  const qsizetype bytes = m_count * qsizetype(sizeof(double));
+  if(m_copy.size() < bytes)
+    m_copy.append(QByteArray(bytes - m_copy.size(), 0));
+}
+
+const double* SharedArray::data() const noexcept
+{
+  if(m_shared)
+    return m_data;
+  return reinterpret_cast<const double*>(m_copy.constData());
+}
+
 ValueOutlet::ValueOutlet(QObject* parent)
     : Outlet{parent}
 {
@@ -189,6 +296,17 @@ void ValueOutlet::addValue(qreal timestamp, QJSValue t)
   values.push_back({timestamp, std::move(t)});
 }
 
+QJSValue ValueOutlet::buffer(int count)
+{
+  auto engine = qjsEngine(this);
+  if(!engine)
+    return {};
+
+  auto v = m_buffer.view(*engine, count);
+  m_bufferUsed = true;
+  return v;
+}
+
 AudioInlet::AudioInlet(QObject* parent)
     : Inlet{parent}
 {
@@ -198,12 +316,69 @@ AudioInlet::~AudioInlet() { }
 
 const QVector<QVector<double>>& AudioInlet::audio() const
 {
+  if(!m_audioValid)
+  {
+    // Only scripts still using channel() pay for the conversion
+    const int channels = m_source->size();
+    m_audio.resize(channels);
+    for(int i = 0; i < channels; i++)
+    {
+      const auto& src = (*m_source)[i];
+      m_audio[i].resize(src.size());
+      std::copy(src.begin(), src.end(), m_audio[i].begin());
+    }
+    m_audioValid = true;
+  }
   return m_audio;
 }
 
 void AudioInlet::setAudio(const QVector<QVector<double>>& audio)
 {
   m_audio = audio;
+  m_source = nullptr;
+  m_audioValid = true;
+}
+
+void AudioInlet::setSource(const ossia::audio_vector* source) noexcept
+{
+  m_source = source;
+  m_audioValid = !source;
+}
+
+tcb::span<const double> AudioInlet::sourceChannel(int i) const noexcept
+{
+  if(i < 0)
+    return {};
+
+  if(m_source)
+  {
+    if(i < std::ssize(*m_source))
+      return {(*m_source)[i].data(), (*m_source)[i].size()};
+  }
+  else if(i < m_audio.size())
+  {
+    return {m_audio[i].data(), std::size_t(m_audio[i].size())};
+  }
+  return {};
+}
+
+int AudioInlet::channels() const noexcept
+{
+  return m_source ? std::ssize(*m_source) : m_audio.size();
+}
+
+QJSValue AudioInlet::buffer(int i)
+{
+  auto engine = qjsEngine(this);
+  if(!engine || i < 0)
+    return {};
+
+  if(i >= std::ssize(m_buffers))
+    m_buffers.resize(i + 1);
+
+  // A view over the memory of the port, without copying the samples
+  const auto src = sourceChannel(i);
+  return m_buffers[i].wrap(*engine, src.data(), src.size());
 }
 
 AudioOutlet::AudioOutlet(QObject* parent)
@@ -218,6 +393,46 @@ const QVector<QVector<double>>& AudioOutlet::audio() const
   return m_audio;
 }
 
+QJSValue AudioOutlet::buffer(int i)
+{
+  auto engine = qjsEngine(this);
+  if(!engine || i < 0)
+    return {};
+
+  if(i >= std::ssize(m_buffers))
+    m_buffers.resize(i + 1);
+
+  auto& buf = m_buffers[i];
+  auto v = buf.array.view(*engine, m_frames);
+  buf.used = true;
+  return v;
+}
+
+void AudioOutlet::writeBuffers(ossia::audio_vector& out, int64_t offset)
+{
+  for(int i = 0; i < std::ssize(m_buffers); i++)
+  {
+    auto& buf = m_buffers[i];
+    if(!std::exchange(buf.used, false))
+      continue;
+
+    if(i >= std::ssize(out))
+      out.resize(i + 1);
+
+    buf.array.read();
+    const double* data = buf.array.data();
+    const int64_t n = buf.array.size();
+    auto& chan = out[i];
+    if(std::ssize(chan) < offset + n)
+      chan.resize(offset + n);
+    for(int64_t s = 0; s < n; s++)
+    {
+      const double v = data[s];
+      chan[offset + s] = (ossia::safe_isinf(v) || ossia::safe_isnan(v)) ? 0. : v;
+    }
+  }
+}
+
 #if defined(SCORE_HAS_GPU_JS)
 TextureOutlet::TextureOutlet(QObject* parent)
     : Outlet{parent}
@@ -14,10 +14,13 @@
 
 #include <score/tools/Debug.hpp>
 
+#include <ossia/dataflow/audio_port.hpp>
 #include <ossia/detail/math.hpp>
+#include <ossia/detail/span.hpp>
 #include <ossia/detail/ssize.hpp>
 #include <ossia/network/domain/domain.hpp>
 
+#include <QJSEngine>
 #include <QJSValue>
 #include <QObject>
 #include <QQmlListProperty>
@@ -375,11 +378,54 @@ public:
   W_INLINE_PROPERTY_CREF(QString, text, {}, text, setText, textChanged)
 };
 
+/**
+ * @brief Float64Array whose memory is shared between C++ and a script.
+ *
+ * The ArrayBuffer seen by the script is made with QByteArray::fromRawData
+ * over memory owned by C++: either a buffer of this object, or the memory
+ * of an ossia port. Nothing is copied between the port and the script.
+ *
+ * That the ArrayBuffer then uses that memory is not documented: it is
+ * checked the first time an array is created. Otherwise, the array is
+ * copied once in each direction.
+ */
+class SharedArray
+{
+public:
+  //! Float64Array over count elements owned by this object, set to 0
+  QJSValue view(QJSEngine& engine, qsizetype count);
+
+  //! Float64Array over memory which must stay valid while the script uses it
+  QJSValue wrap(QJSEngine& engine, const double* data, qsizetype count);
+
+  //! Makes what the script wrote in the view available through data()
+  void read();
+
+  const double* data() const noexcept;
+  qsizetype size() const noexcept { return m_count; }
+
+private:
+  QJSValue copy(QJSEngine& engine, const double* data, qsizetype count);
+
+  std::vector<double> m_storage;
+  std::vector<std::vector<double>> m_retired;
+  const double* m_data{};
+  QJSValue m_view;
+  qsizetype m_count{};
+
+  // Used when the ArrayBuffers do not share memory
+  QByteArray m_copy;
+  QJSValue m_buffer;
+  bool m_shared{true};
+};
+
 class ValueOutlet : public Outlet
 {
   W_OBJECT(ValueOutlet)
 
   QJSValue m_value;
+  SharedArray m_buffer;
+  bool m_bufferUsed{};
 
 public:
   std::vector<OutValueMessage> values;
@@ -391,6 +437,16 @@ public:
   {
     m_value = QJSValue{};
     values.clear();
+    m_bufferUsed = false;
+  }
+
+  //! Numbers written by the script through buffer() during the tick
+  tcb::span<const double> bufferValues() noexcept
+  {
+    if(!m_bufferUsed)
+      return {};
+    m_buffer.read();
+    return {m_buffer.data(), std::size_t(m_buffer.size())};
   }
   Process::Outlet* make(Id<Process::Port>&& id, QObject* parent) override
   {
@@ -403,6 +459,10 @@ public:
   void addValue(qreal timestamp, QJSValue t);
   W_SLOT(addValue);
 
+  //! Float64Array of count numbers, output evenly spread over the tick
+  QJSValue buffer(int count);
+  W_INVOKABLE(buffer);
+
   W_PROPERTY(QJSValue, value READ value WRITE setValue)
 };
 
@@ -416,21 +476,37 @@ public:
   const QVector<QVector<double>>& audio() const;
   void setAudio(const QVector<QVector<double>>& audio);
 
+  //! Memory of the ossia port for the current tick, converted on demand
+  void setSource(const ossia::audio_vector* source) noexcept;
+
   QVector<double> channel(int i) const
   {
-    if(m_audio.size() > i)
-      return m_audio[i];
+    const auto& audio = this->audio();
+    if(audio.size() > i)
+      return audio[i];
     return {};
   }
   W_INVOKABLE(channel);
 
+  int channels() const noexcept;
+  W_INVOKABLE(channels);
+
+  //! Float64Array over the channel of the port, valid during the tick
+  QJSValue buffer(int i);
+  W_INVOKABLE(buffer);
+
   Process::Inlet* make(Id<Process::Port>&& id, QObject* parent) override
   {
     return new Process::AudioInlet(id, parent);
   }
 
 private:
-  QVector<QVector<double>> m_audio;
+  tcb::span<const double> sourceChannel(int i) const noexcept;
+
+  const ossia::audio_vector* m_source{};
+  mutable QVector<QVector<double>> m_audio;
+  mutable bool m_audioValid{true};
+  std::vector<SharedArray> m_buffers;
 };
 
 class AudioOutlet : public Outlet
@@ -452,8 +528,27 @@ public:
 
   void setChannel(int i, const QJSValue& v);
   W_INVOKABLE(setChannel)
+
+  //! Float64Array of the frames of the current tick, to be filled by the script
+  QJSValue buffer(int i);
+  W_INVOKABLE(buffer);
+
+  //! Frames to write for the current tick, set by the node
+  void setFrames(int64_t frames) noexcept { m_frames = frames; }
+
+  //! Copies the channels written through buffer() in the ossia port
+  void writeBuffers(ossia::audio_vector& out, int64_t offset);
+
 private:
+  struct Buffer
+  {
+    SharedArray array;
+    bool used{};
+  };
+
   QVector<QVector<double>> m_audio;
+  std::vector<Buffer> m_buffers;
+  int64_t m_frames{};
 };
 
 class MidiMessage
@@ -0,0 +1,339 @@
+#include "LibraryIndex.hpp"
+
+#include <score/tools/RecursiveWatch.hpp>
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDir>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QTimer>
+
+#include <algorithm>
+#include <iterator>
+
+#include <wobjectimpl.h>
+W_OBJECT_IMPL(Library::LibraryIndex)
+
+namespace Library
+{
+namespace
+{
+constexpr quint32 cache_magic = 0x58494c53; // SLIX
+constexpr qint32 cache_version = 1;
+
+uint64_t trigram(const QString& str, int i) noexcept
+{
+  return (uint64_t(str[i].unicode()) << 32) | (uint64_t(str[i + 1].unicode()) << 16)
+         | uint64_t(str[i + 2].unicode());
+}
+
+QString cacheFile(const QString& root)
+{
+  const auto hash = QCryptographicHash::hash(root.toUtf8(), QCryptographicHash::Sha1);
+  return QStandardPaths::writableLocation(QStandardPaths::CacheLocation)
+         + "/library/" + hash.toHex() + ".index";
+}
+
+IndexedFiles loadCache(const QString& root)
+{
+  IndexedFiles files;
+  QFile f{cacheFile(root)};
+  if(!f.open(QIODevice::ReadOnly))
+    return files;
+
+  QDataStream s{&f};
+  quint32 magic{};
+  qint32 version{};
+  QString cachedRoot;
+  s >> magic >> version;
+  if(magic != cache_magic || version != cache_version)
+    return files;
+
+  s >> cachedRoot;
+  if(cachedRoot != root)
+    return files;
+
+  qint32 count{};
+  s >> count;
+  for(qint32 i = 0; i < count && s.status() == QDataStream::Ok; i++)
+  {
+    QString path;
+    s >> path;
+    files.add(path);
+  }
+  return files;
+}
+
+void saveCache(const QString& root, const IndexedFiles& files)
+{
+  const auto path = cacheFile(root);
+  QDir{}.mkpath(QFileInfo{path}.absolutePath());
+
+  QSaveFile f{path};
+  if(!f.open(QIODevice::WriteOnly))
+    return;
+
+  QDataStream s{&f};
+  s << cache_magic << cache_version << root;
+  s << qint32(files.ids.size());
+  for(const auto& path : files.paths)
+    if(!path.isEmpty())
+      s << path;
+  f.commit();
+}
+
+IndexedFiles scanFolder(const QString& root)
+{
+  IndexedFiles files;
+  const auto prefix = root.size() + 1;
+  score::for_all_files(root.toStdString(), [&](std::string_view path) {
+    const auto abs = QString::fromUtf8(path.data(), path.size());
+    if(abs.size() > prefix)
+      files.add(abs.mid(prefix));
+  });
+  return files;
+}
+}
+
+bool IndexedFiles::add(const QString& path)
+{
+  // The folders are indexed too, as they can also be searched for
+  for(int slash = path.indexOf('/'); slash > 0; slash = path.indexOf('/', slash + 1))
+    addOne(path.left(slash));
+  return addOne(path);
+}
+
+bool IndexedFiles::addOne(const QString& path)
+{
+  if(path.isEmpty() || ids.find(path) != ids.end())
+    return false;
+
+  const int id = paths.size();
+  auto name = path.mid(path.lastIndexOf('/') + 1).toLower();
+  for(int i = 0; i + 2 < name.size(); i++)
+  {
+    auto& list = trigrams[trigram(name, i)];
+    if(list.empty() || list.back() != id)
+      list.push_back(id);
+  }
+
+  // The parent folders have been added before by add()
+  if(const int slash = path.lastIndexOf('/'); slash > 0)
+    if(auto parent = ids.find(path.left(slash)); parent != ids.end())
+      children[parent->second].push_back(id);
+
+  paths.push_back(path);
+  names.push_back(std::move(name));
+  children.emplace_back();
+  ids[path] = id;
+  return true;
+}
+
+bool IndexedFiles::remove(const QString& path)
+{
+  auto it = ids.find(path);
+  if(it == ids.end())
+    return false;
+
+  // The trigrams and the parent folder still refer to the removed entries:
+  // as their path is empty, they are ignored. They go away with the next scan.
+  std::vector<int> removed{it->second};
+  while(!removed.empty())
+  {
+    const int id = removed.back();
+    removed.pop_back();
+    if(paths[id].isEmpty())
+      continue;
+
+    ids.erase(paths[id]);
+    paths[id].clear();
+    names[id].clear();
+    removed.insert(removed.end(), children[id].begin(), children[id].end());
+    children[id].clear();
+  }
+  return true;
+}
+
+bool LibraryIndex::Matches::accepts(const QString& path) const
+{
+  if(matches.find(path) != matches.end() || parents.find(path) != parents.end())
+    return true;
+
+  for(int slash = path.lastIndexOf('/'); slash > 0;
+      slash = path.lastIndexOf('/', slash - 1))
+  {
+    if(matches.find(path.left(slash)) != matches.end())
+      return true;
+  }
+  return false;
+}
+
+LibraryIndex::LibraryIndex(QObject* parent)
+    : QObject{parent}
+{
+}
+
+LibraryIndex::~LibraryIndex()
+{
+  m_scan.cancel();
+}
+
+void LibraryIndex::setRoot(const QString& root)
+{
+  auto path = QDir::cleanPath(root);
+  if(path == m_root)
+    return;
+
+  m_scan.cancel();
+  m_scan = {};
+  m_root = path;
+  m_files = {};
+  m_ready = false;
+  updated();
+
+  if(m_root.isEmpty())
+    return;
+
+  // The cached index is loaded first, then the folder is scanned again.
+  score::TaskPool::instance().post(
+      this, [root = m_root] { return loadCache(root); },
+      [this, token = m_scan](IndexedFiles files) {
+    if(token.cancelled())
+      return;
+    if(!files.paths.empty())
+      setFiles(std::move(files));
+    scan();
+  });
+}
+
+void LibraryIndex::rescan()
+{
+  if(m_root.isEmpty())
+    return;
+
+  m_scan.cancel();
+  m_scan = {};
+  scan();
+}
+
+void LibraryIndex::scan()
+{
+  score::TaskPool::instance().post(
+      this,
+      [root = m_root, token = m_scan] {
+    IndexedFiles files;
+    if(token.cancelled())
+      return files;
+
+    files = scanFolder(root);
+    saveCache(root, files);
+    return files;
+  },
+      [this, token = m_scan](IndexedFiles files) {
+    if(!token.cancelled())
+      setFiles(std::move(files));
+  });
+}
+
+void LibraryIndex::setFiles(IndexedFiles files)
+{
+  m_files = std::move(files);
+  m_ready = true;
+  updated();
+}
+
+QString LibraryIndex::relativePath(const QString& path) const
+{
+  if(path.size() > m_root.size() + 1 && path.startsWith(m_root)
+     && path[m_root.size()] == '/')
+    return path.mid(m_root.size() + 1);
+  return {};
+}
+
+LibraryIndex::Matches LibraryIndex::search(const QString& pattern) const
+{
+  Matches res;
+  const auto p = pattern.toLower();
+  if(p.isEmpty())
+    return res;
+
+  auto check = [&](int id) {
+    if(!m_files.names[id].contains(p))
+      return;
+
+    const auto& path = m_files.paths[id];
+    res.matches.insert(path);
+    for(int slash = path.lastIndexOf('/'); slash > 0;
+        slash = path.lastIndexOf('/', slash - 1))
+    {
+      if(!res.parents.insert(path.left(slash)).second)
+        break;
+    }
+  };
+
+  if(p.size() < 3)
+  {
+    for(std::size_t id = 0; id < m_files.names.size(); id++)
+      check(id);
+    return res;
+  }
+
+  // The candidates are the entries which have all the trigrams of the pattern
+  std::vector<const std::vector<int>*> lists;
+  for(int i = 0; i + 2 < p.size(); i++)
+  {
+    auto it = m_files.trigrams.find(trigram(p, i));
+    if(it == m_files.trigrams.end())
+      return res;
+    lists.push_back(&it->second);
+  }
+  std::sort(lists.begin(), lists.end(), [](auto lhs, auto rhs) {
+    return lhs->size() < rhs->size();
+  });
+
+  std::vector<int> candidates = *lists.front();
+  std::vector<int> next;
+  for(std::size_t i = 1; i < lists.size() && !candidates.empty(); i++)
+  {
+    next.clear();
+    std::set_intersection(
+        candidates.begin(), candidates.end(), lists[i]->begin(), lists[i]->end(),
+        std::back_inserter(next));
+    candidates.swap(next);
+  }
+
+  for(int id : candidates)
+    check(id);
+  return res;
+}
+
+void LibraryIndex::addPath(const QString& path)
+{
+  if(!m_ready)
+    return;
+  if(auto rel = relativePath(path); !rel.isEmpty() && m_files.add(rel))
+    scheduleUpdated();
+}
+
+void LibraryIndex::removePath(const QString& path)
+{
+  if(!m_ready)
+    return;
+  if(auto rel = relativePath(path); !rel.isEmpty() && m_files.remove(rel))
+    scheduleUpdated();
+}
+
+void LibraryIndex::scheduleUpdated()
+{
+  // The changes come from the signals of the file system model:
+  // the proxy model must not be invalidated while they are being processed.
+  if(m_updateScheduled)
+    return;
+  m_updateScheduled = true;
+  QTimer::singleShot(0, this, [this] {
+    m_updateScheduled = false;
+    updated();
+  });
+}
+}
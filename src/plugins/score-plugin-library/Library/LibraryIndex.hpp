@@ -0,0 +1,99 @@
+#pragma once
+#include <score/tools/ThreadPool.hpp>
+
+#include <ossia/detail/hash_map.hpp>
+
+#include <QObject>
+#include <QString>
+
+#include <verdigris>
+
+#include <vector>
+
+namespace Library
+{
+//! Files of a library folder, indexed by the trigrams of their names
+struct IndexedFiles
+{
+  //! Paths relative to the root of the library, empty once removed
+  std::vector<QString> paths;
+  //! Lower-case file names
+  std::vector<QString> names;
+  //! Entries directly inside each folder, which may have been removed since
+  std::vector<std::vector<int>> children;
+
+  ossia::hash_map<uint64_t, std::vector<int>> trigrams;
+  ossia::hash_map<QString, int> ids;
+
+  //! Adds a file and the folders containing it, returns false if already there
+  bool add(const QString& path);
+  //! Removes a file, or a folder and everything inside it
+  bool remove(const QString& path);
+
+private:
+  bool addOne(const QString& path);
+};
+
+/**
+ * @brief Index of the files of a library folder, used to search it quickly.
+ *
+ * Searching the file system model means walking all of its rows for every
+ * keystroke. Here, a search only checks the names which contain all the
+ * trigrams of the pattern.
+ *
+ * The folder is scanned in the background. The list of its files is kept in
+ * the cache folder, so that the index is available right after startup,
+ * while the folder gets scanned again.
+ */
+class LibraryIndex final : public QObject
+{
+  W_OBJECT(LibraryIndex)
+public:
+  //! Result of a search, with paths relative to the root of the index
+  struct Matches
+  {
+    //! Files and folders whose name contains the pattern
+    ossia::hash_set<QString> matches;
+    //! Folders containing a match
+    ossia::hash_set<QString> parents;
+
+    //! True if the path matches, contains a match or is in a matching folder
+    bool accepts(const QString& path) const;
+  };
+
+  explicit LibraryIndex(QObject* parent);
+  ~LibraryIndex();
+
+  //! Indexes another folder: does nothing if it is already the indexed one
+  void setRoot(const QString& root);
+  const QString& root() const noexcept { return m_root; }
+
+  //! Scans the folder again, the current index stays usable meanwhile
+  void rescan();
+
+  //! False until the files of the folder are known, from the cache or a scan
+  bool ready() const noexcept { return m_ready; }
+
+  //! Path relative to the root, or an empty string if not inside it
+  QString relativePath(const QString& absolutePath) const;
+
+  Matches search(const QString& pattern) const;
+
+  //! Incremental updates, e.g. from a file system watcher. The paths are absolute.
+  void addPath(const QString& path);
+  void removePath(const QString& path);
+
+  void updated() W_SIGNAL(updated);
+
+private:
+  void scan();
+  void setFiles(IndexedFiles files);
+  void scheduleUpdated();
+
+  QString m_root;
+  IndexedFiles m_files;
+  score::CancellationToken m_scan;
+  bool m_ready{};
+  bool m_updateScheduled{};
+};
+}
@@ -1,4 +1,6 @@
 #pragma once
+#include <Library/LibraryIndex.hpp>
+
 #include <score/tools/Debug.hpp>
 
 #include <QFileSystemModel>
@@ -12,14 +14,11 @@ public:
   using QSortFilterProxyModel::QSortFilterProxyModel;
 
   const QString& pattern() const noexcept { return m_textPattern; }
-  void setPattern(const QString& p)
+  virtual void setPattern(const QString& p)
   {
-    beginResetModel();
-    auto old = m_textPattern;
+    // Only the filtering changes: the views keep their state
     m_textPattern = p;
-    endResetModel();
-    // if(!p.contains(old))
-    //  invalidateFilter();
+    invalidateFilter();
   }
 
 protected:
@@ -83,7 +82,30 @@ public:
 
   QModelIndex fixedRootIndex{};
 
+  //! When the index is ready, searches use it instead of walking the model
+  void setIndex(LibraryIndex* index)
+  {
+    m_index = index;
+    connect(index, &LibraryIndex::updated, this, [this] {
+      if(!m_textPattern.isEmpty())
+      {
+        m_matches = m_index->search(m_textPattern);
+        invalidateFilter();
+      }
+    });
+  }
+
+  void setPattern(const QString& p) override
+  {
+    if(m_index)
+      m_matches = m_index->search(p);
+    RecursiveFilterProxy::setPattern(p);
+  }
+
 private:
+  LibraryIndex* m_index{};
+  LibraryIndex::Matches m_matches;
+
   bool isChildOfRoot(const QModelIndex& m) const noexcept
   {
     if(!m.isValid())
@@ -114,6 +136,14 @@ private:
       return false;
     }
 
+    if(m_index && m_index->ready() && !m_textPattern.isEmpty())
+    {
+      const auto path = m_index->relativePath(sourceModel()->filePath(index));
+      if(path.isEmpty())
+        return !m_matches.matches.empty();
+      return m_matches.accepts(path);
+    }
+
     if(filterAcceptsRowItself(srcRow, srcParent))
     {
       return true;
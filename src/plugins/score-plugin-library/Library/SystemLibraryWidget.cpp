@@ -2,6 +2,7 @@
 
 #include <Library/FileSystemModel.hpp>
 #include <Library/ItemModelFilterLineEdit.hpp>
+#include <Library/LibraryIndex.hpp>
 #include <Library/LibrarySettings.hpp>
 #include <Library/LibraryWidget.hpp>
 #include <Library/RecursiveFilterProxy.hpp>
@@ -25,9 +26,31 @@ SystemLibraryWidget::SystemLibraryWidget(
     : QWidget{parent}
     , m_model{new FileSystemModel{ctx, this}}
     , m_proxy{new FileSystemRecursiveFilterProxy{this}}
+    , m_index{new LibraryIndex{this}}
     , m_preview{this}
 {
   m_proxy->setRecursiveFilteringEnabled(true);
+  m_proxy->setIndex(m_index);
+
+  // Keep the index up to date with the changes seen by the model
+  connect(
+      m_model, &QFileSystemModel::rowsInserted, this,
+      [this](const QModelIndex& parent, int first, int last) {
+    for(int i = first; i <= last; i++)
+      m_index->addPath(m_model->filePath(m_model->index(i, 0, parent)));
+      });
+  connect(
+      m_model, &QFileSystemModel::rowsAboutToBeRemoved, this,
+      [this](const QModelIndex& parent, int first, int last) {
+    for(int i = first; i <= last; i++)
+      m_index->removePath(m_model->filePath(m_model->index(i, 0, parent)));
+      });
+  connect(
+      m_model, &QFileSystemModel::fileRenamed, this,
+      [this](const QString& path, const QString& oldName, const QString& newName) {
+    m_index->removePath(path + '/' + oldName);
+    m_index->addPath(path + '/' + newName);
+      });
 
   setStatusTip(
       QObject::tr("This panel shows the system library.\n"
@@ -104,6 +127,9 @@ SystemLibraryWidget::SystemLibraryWidget(
     il->reset();
     con(settings, &Library::Settings::Model::RootPathChanged, this, il->reset);
     con(settings, &Library::Settings::Model::rescanLibrary, this, il->reset);
+    con(settings, &Library::Settings::Model::rescanLibrary, this, [this] {
+      m_index->rescan();
+    });
   });
 }
 
@@ -111,6 +137,7 @@ SystemLibraryWidget::~SystemLibraryWidget() { }
 
 void SystemLibraryWidget::setRoot(QString path)
 {
+  m_index->setRoot(path);
   auto idx = m_model->setRootPath(path);
   ((FileSystemRecursiveFilterProxy*)m_proxy)->fixedRootIndex = idx;
   if(idx.isValid())
@@ -12,6 +12,7 @@ namespace Library
 {
 class FileSystemModel;
 class FileSystemRecursiveFilterProxy;
+class LibraryIndex;
 class SystemLibraryWidget : public QWidget
 {
 public:
@@ -23,6 +24,7 @@ public:
 private:
   FileSystemModel* m_model{};
   FileSystemRecursiveFilterProxy* m_proxy{};
+  LibraryIndex* m_index{};
   QTreeView m_tv;
   QWidget m_preview;
   QWidget* m_previewChild{};
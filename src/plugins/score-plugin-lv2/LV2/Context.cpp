@@ -134,8 +134,7 @@ do_worker(LV2_Worker_Schedule_Handle ptr, uint32_t s, const void* data)
       std::vector<char> cp = c.host.acquire_worker_data((const char*)data, s);
 
       // 2. Move that buffer to the thread pool
-      auto& tq = score::TaskPool::instance();
-      tq.post(worker{.host = &c.host, .fx = cur, .dat = std::move(cp)});
+      cur->worker_strand.post(worker{.host = &c.host, .fx = cur, .dat = std::move(cp)});
 
       return LV2_WORKER_SUCCESS;
     }
@@ -23,6 +23,8 @@
 #include <lv2/lv2plug.in/ns/ext/worker/worker.h>
 #include <lv2/lv2plug.in/ns/extensions/ui/ui.h>
 
+#include <score/tools/ThreadPool.hpp>
+
 #include <ossia/detail/hash_map.hpp>
 #include <ossia/detail/lockfree_queue.hpp>
 #include <ossia/detail/small_vector.hpp>
@@ -142,6 +144,9 @@ struct EffectContext
   SuilInstance* ui_instance{};
 
   ossia::mpmc_queue<std::vector<char>> worker_datas;
+
+  //! The work requests of an instance run one at a time, in order
+  score::TaskStrand worker_strand;
 };
 
 struct GlobalContext
@@ -3,6 +3,7 @@
 #include "lv2_atom_helpers.hpp"
 
 #include <Process/Dataflow/WidgetInlets.hpp>
+#include <Process/Execution/GUIThreadNode.hpp>
 
 #include <Audio/Settings/Model.hpp>
 #include <Execution/DocumentPlugin.hpp>
@@ -754,7 +755,8 @@ void LV2EffectComponent::lazy_init()
   os.self = std::dynamic_pointer_cast<LV2EffectComponent>(shared_from_this());
   of.self = os.self;
 
-  auto node = ossia::make_node<LV2::lv2_node_t>(
+  // The instance is deactivated in the destructor, which must not run on the GC thread
+  auto node = Execution::make_gui_thread_node<LV2::lv2_node_t>(
       *ctx.execState, LV2::LV2Data{host.lv2_host_context, proc.effectContext},
       ctx.execState->sampleRate, os, of);
 
@@ -1,5 +1,6 @@
 #include "AudioDecoder.hpp"
 
+#include <Media/DecodeScheduler.hpp>
 #include <Media/Libav.hpp>
 #include <Media/Sound/SoundModel.hpp>
 
@@ -372,16 +373,11 @@ namespace Media
 AudioDecoder::AudioDecoder(int rate)
     : convertedSampleRate{rate}
 {
-  connect(
-      this, &AudioDecoder::startDecode, this, &AudioDecoder::on_startDecode,
-      Qt::QueuedConnection);
 }
 
 AudioDecoder::~AudioDecoder()
 {
-  m_decodeThread.exit();
-  while(m_decodeThread.isRunning())
-    ;
+  DecodeScheduler::instance().cancel(*this);
 }
 
 struct AVCodecContext_Free
@@ -562,9 +558,7 @@ void AudioDecoder::decode(const QString& path, int trackToUse, audio_handle hdl)
   if(data.size() == 0)
     return;
 
-  this->moveToThread(&m_decodeThread);
-  m_decodeThread.start();
-  startDecode(path, hdl);
+  DecodeScheduler::instance().enqueue(*this, path, std::move(hdl));
 #endif
 }
 
@@ -865,7 +859,6 @@ void AudioDecoder::on_startDecode(QString path, audio_handle hdl)
   }
 
   finishedDecoding(hdl);
-  m_decodeThread.quit();
 
 #endif
   return;
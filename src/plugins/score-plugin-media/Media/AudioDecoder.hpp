@@ -6,6 +6,7 @@
 #include <ossia/detail/flicks.hpp>
 #include <ossia/detail/optional.hpp>
 
+#include <QHash>
 #include <QThread>
 
 #include <score_plugin_media_export.h>
@@ -58,18 +59,13 @@ public:
   void newData() W_SIGNAL(newData);
   void finishedDecoding(audio_handle hdl) W_SIGNAL(finishedDecoding, hdl);
 
-  void startDecode(QString str, audio_handle hdl) W_SIGNAL(startDecode, str, hdl);
-
 public:
+  //! Decodes the whole file on the calling thread, see DecodeScheduler
   void on_startDecode(QString, audio_handle hdl);
-  W_SLOT(on_startDecode);
 
 private:
   static double read_length(const QString& path);
 
-  QThread* m_baseThread{};
-  QThread m_decodeThread;
-
   template <typename Decoder>
   void decodeFrame(Decoder dec, audio_array& data, AVFrame& frame);
 
@@ -0,0 +1,100 @@
+#include "AudioPrefetcher.hpp"
+
+#include <ossia/detail/thread.hpp>
+
+#include <QFile>
+
+#include <algorithm>
+
+namespace Media
+{
+AudioPrefetcher::AudioPrefetcher()
+    : m_thread{[this] {
+      ossia::set_thread_name("ossia prefetch");
+      run();
+    }}
+{
+}
+
+AudioPrefetcher::~AudioPrefetcher()
+{
+  {
+    std::lock_guard l{m_mutex};
+    m_running = false;
+    m_requests.clear();
+  }
+  m_cv.notify_one();
+  m_thread.join();
+}
+
+AudioPrefetcher& AudioPrefetcher::instance() noexcept
+{
+  static AudioPrefetcher p;
+  return p;
+}
+
+void AudioPrefetcher::prefetch(const QString& path, double position, int64_t priority)
+{
+  {
+    std::lock_guard l{m_mutex};
+    auto it = std::find_if(m_requests.begin(), m_requests.end(), [&](const Request& r) {
+      return r.path == path;
+    });
+
+    // A file used several times is read where it is needed first
+    if(it == m_requests.end())
+      m_requests.push_back({path, position, priority});
+    else if(priority < it->priority)
+      *it = {path, position, priority};
+  }
+  m_cv.notify_one();
+}
+
+void AudioPrefetcher::clear()
+{
+  std::lock_guard l{m_mutex};
+  m_requests.clear();
+}
+
+void AudioPrefetcher::run()
+{
+  std::vector<char> buffer(256 * 1024);
+  for(;;)
+  {
+    Request req;
+    {
+      std::unique_lock l{m_mutex};
+      m_cv.wait(l, [this] { return !m_running || !m_requests.empty(); });
+      if(!m_running)
+        return;
+
+      auto it = std::min_element(
+          m_requests.begin(), m_requests.end(),
+          [](const Request& lhs, const Request& rhs) {
+        return lhs.priority < rhs.priority;
+          });
+      req = std::move(*it);
+      m_requests.erase(it);
+    }
+
+    QFile f{req.path};
+    if(!f.open(QIODevice::ReadOnly))
+      continue;
+
+    // The data is discarded: reading it is enough for the OS to cache it.
+    const int64_t size = f.size();
+    const int64_t start = std::clamp(int64_t(req.position * size), int64_t(0), size);
+    if(!f.seek(start))
+      continue;
+
+    int64_t remaining = std::min(window, size - start);
+    while(remaining > 0)
+    {
+      const auto n = f.read(buffer.data(), std::min(remaining, int64_t(buffer.size())));
+      if(n <= 0)
+        break;
+      remaining -= n;
+    }
+  }
+}
+}
@@ -0,0 +1,60 @@
+#pragma once
+#include <QString>
+
+#include <score_plugin_media_export.h>
+
+#include <condition_variable>
+#include <cinttypes>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Media
+{
+/**
+ * @brief Reads ahead the parts of streamed audio files that are about to be played.
+ *
+ * Files which do not fit in the decoding budget are decoded from the disk
+ * during playback, see AudioFile::load.
+ * For each of them a background thread reads a bounded window of the file
+ * from the position at which it will start playing, the earliest intervals
+ * first, so that the audio thread finds the data in the system file cache
+ * instead of waiting on the disk.
+ */
+class SCORE_PLUGIN_MEDIA_EXPORT AudioPrefetcher
+{
+public:
+  //! Bytes read ahead for each file
+  static constexpr int64_t window = 8 * 1024 * 1024;
+
+  static AudioPrefetcher& instance() noexcept;
+  ~AudioPrefetcher();
+
+  /**
+   * @param position Fraction of the file, between 0 and 1, at which playback starts
+   * @param priority Requests with the lowest priority are read first,
+   *                 e.g. the date at which the file starts playing.
+   */
+  void prefetch(const QString& path, double position, int64_t priority);
+
+  //! Drops the pending requests
+  void clear();
+
+private:
+  AudioPrefetcher();
+  void run();
+
+  struct Request
+  {
+    QString path;
+    double position{};
+    int64_t priority{};
+  };
+
+  std::mutex m_mutex;
+  std::condition_variable m_cv;
+  std::vector<Request> m_requests;
+  bool m_running{true};
+  std::thread m_thread;
+};
+}
@@ -0,0 +1,123 @@
+#include "DecodeScheduler.hpp"
+
+#include <Media/AudioDecoder.hpp>
+#include <Media/Effect/Settings/Model.hpp>
+
+#include <score/application/ApplicationContext.hpp>
+
+#include <ossia/detail/algorithms.hpp>
+#include <ossia/detail/thread.hpp>
+
+#include <algorithm>
+#include <string>
+
+#include <wobjectimpl.h>
+W_OBJECT_IMPL(Media::DecodeScheduler)
+namespace Media
+{
+DecodeScheduler::DecodeScheduler()
+{
+  int n = score::AppContext().settings<Media::Settings::Model>().getDecodeThreads();
+  if(n <= 0)
+    n = std::max(1, int(std::thread::hardware_concurrency()) / 2);
+
+  for(int i = 0; i < n; i++)
+  {
+    m_threads.emplace_back([this, i] {
+      ossia::set_thread_name("ossia decode " + std::to_string(i));
+      run();
+    });
+  }
+}
+
+DecodeScheduler::~DecodeScheduler()
+{
+  {
+    std::lock_guard l{m_mutex};
+    m_stop = true;
+    m_jobs.clear();
+  }
+  m_cv.notify_all();
+
+  for(auto& t : m_threads)
+    t.join();
+}
+
+DecodeScheduler& DecodeScheduler::instance() noexcept
+{
+  static DecodeScheduler s;
+  return s;
+}
+
+void DecodeScheduler::enqueue(
+    AudioDecoder& decoder, const QString& path, audio_handle hdl)
+{
+  int finished{}, total{};
+  {
+    std::lock_guard l{m_mutex};
+    m_jobs.push_back({&decoder, path, std::move(hdl), unknown});
+    finished = m_finished;
+    total = ++m_total;
+  }
+  m_cv.notify_one();
+  progress(finished, total);
+}
+
+void DecodeScheduler::cancel(AudioDecoder& decoder)
+{
+  std::unique_lock l{m_mutex};
+  const auto count = m_jobs.size();
+  ossia::remove_erase_if(
+      m_jobs, [&decoder](const Job& job) { return job.decoder == &decoder; });
+  m_total -= int(count - m_jobs.size());
+
+  m_doneCv.wait(l, [this, &decoder] {
+    return !ossia::contains(m_running, &decoder);
+  });
+}
+
+void DecodeScheduler::prioritize(const QString& path, int64_t priority)
+{
+  // Called on every paint: nothing is kept for the files which are not queued
+  std::lock_guard l{m_mutex};
+  for(auto& job : m_jobs)
+    if(job.path == path)
+      job.priority = std::min(job.priority, priority);
+}
+
+void DecodeScheduler::run()
+{
+  for(;;)
+  {
+    Job job;
+    {
+      std::unique_lock l{m_mutex};
+      m_cv.wait(l, [this] { return m_stop || !m_jobs.empty(); });
+      if(m_stop)
+        return;
+
+      // Jobs with the same priority are decoded in the order they were queued
+      auto it = std::min_element(
+          m_jobs.begin(), m_jobs.end(),
+          [](const Job& lhs, const Job& rhs) { return lhs.priority < rhs.priority; });
+      job = std::move(*it);
+      m_jobs.erase(it);
+      m_running.push_back(job.decoder);
+    }
+
+    job.decoder->on_startDecode(job.path, std::move(job.handle));
+
+    int finished{}, total{};
+    {
+      std::lock_guard l{m_mutex};
+      ossia::remove_erase(m_running, job.decoder);
+      finished = ++m_finished;
+      total = m_total;
+      if(m_jobs.empty() && m_running.empty())
+        m_finished = m_total = 0;
+    }
+    m_doneCv.notify_all();
+    progress(finished, total);
+  }
+}
+}
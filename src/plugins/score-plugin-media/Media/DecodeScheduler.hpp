@@ -0,0 +1,82 @@
+#pragma once
+#include <Media/AudioArray.hpp>
+
+#include <QObject>
+#include <QString>
+
+#include <score_plugin_media_export.h>
+
+#include <condition_variable>
+#include <limits>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <verdigris>
+
+namespace Media
+{
+class AudioDecoder;
+
+/**
+ * @brief Decodes audio files on a bounded pool of worker threads.
+ *
+ * Every AudioDecoder hands its work to this scheduler instead of running
+ * on its own thread. Pending files are decoded by increasing priority:
+ * files visible on screen first, then by the date at which they start
+ * playing, then the files nothing is known about.
+ *
+ * The number of workers comes from the DecodeThreads setting and is read
+ * when the scheduler is first used.
+ */
+class SCORE_PLUGIN_MEDIA_EXPORT DecodeScheduler final : public QObject
+{
+  W_OBJECT(DecodeScheduler)
+public:
+  //! Priority of the files that are shown on screen
+  static constexpr int64_t visible = std::numeric_limits<int64_t>::min();
+
+  //! Priority of the files for which no priority was given
+  static constexpr int64_t unknown = std::numeric_limits<int64_t>::max();
+
+  static DecodeScheduler& instance() noexcept;
+  ~DecodeScheduler();
+
+  void enqueue(AudioDecoder& decoder, const QString& path, audio_handle hdl);
+
+  //! Removes the pending work of a decoder, and waits if it is being decoded
+  void cancel(AudioDecoder& decoder);
+
+  //! Decodes a queued file earlier if the priority is lower than its current one
+  void prioritize(const QString& path, int64_t priority);
+
+  int threads() const noexcept { return m_threads.size(); }
+
+  //! Files decoded since the queue was last empty, out of the files queued since then
+  void progress(int finished, int total) W_SIGNAL(progress, finished, total);
+
+private:
+  DecodeScheduler();
+  void run();
+
+  struct Job
+  {
+    AudioDecoder* decoder{};
+    QString path;
+    audio_handle handle;
+    int64_t priority{unknown};
+  };
+
+  std::mutex m_mutex;
+  std::condition_variable m_cv;
+  std::condition_variable m_doneCv;
+
+  std::vector<Job> m_jobs;
+  std::vector<AudioDecoder*> m_running;
+
+  int m_finished{};
+  int m_total{};
+  bool m_stop{};
+
+  std::vector<std::thread> m_threads;
+};
+}
@@ -0,0 +1,71 @@
+#include <Media/Effect/Settings/DecodingSettings.hpp>
+
+#include <score/widgets/SignalUtils.hpp>
+
+#include <QFormLayout>
+#include <QSpinBox>
+#include <QWidget>
+
+#include <wobjectimpl.h>
+
+W_OBJECT_IMPL(Media::Settings::DecodingSettings)
+namespace Media::Settings
+{
+DecodingSettings::DecodingSettings() { }
+
+void DecodingSettings::setDecodeBudget(int val)
+{
+  if(m_DecodeBudget->value() != val)
+    m_DecodeBudget->setValue(val);
+}
+
+void DecodingSettings::setDecodeThreads(int val)
+{
+  if(m_DecodeThreads->value() != val)
+    m_DecodeThreads->setValue(val);
+}
+
+QString DecodingSettings::name() const noexcept
+{
+  return tr("Audio files");
+}
+
+QWidget* DecodingSettings::make(const score::ApplicationContext& ctx)
+{
+  m_model = &ctx.settings<Media::Settings::Model>();
+  auto& m = *m_model;
+  auto& v = *this;
+
+  auto widg = new QWidget;
+  auto lay = new QFormLayout{widg};
+
+  m_DecodeBudget = new QSpinBox{widg};
+  m_DecodeBudget->setRange(0, 1024 * 1024);
+  m_DecodeBudget->setSuffix(tr(" MB"));
+  m_DecodeBudget->setToolTip(
+      tr("Decoded audio kept in RAM. The files past it are streamed from the disk."));
+  lay->addRow(tr("Decoding budget"), m_DecodeBudget);
+  connect(
+      m_DecodeBudget, SignalUtils::QSpinBox_valueChanged_int(), this,
+      &DecodingSettings::DecodeBudgetChanged);
+
+  m_DecodeThreads = new QSpinBox{widg};
+  m_DecodeThreads->setRange(0, 128);
+  m_DecodeThreads->setSpecialValueText(tr("Half of the cores"));
+  m_DecodeThreads->setToolTip(tr("Used the next time score is started."));
+  lay->addRow(tr("Decoding threads"), m_DecodeThreads);
+  connect(
+      m_DecodeThreads, SignalUtils::QSpinBox_valueChanged_int(), this,
+      &DecodingSettings::DecodeThreadsChanged);
+
+  SETTINGS_PRESENTER(DecodeBudget);
+  SETTINGS_PRESENTER(DecodeThreads);
+
+  return widg;
+}
+
+DecodingSettings::Model& DecodingSettings::model(DecodingSettings* self)
+{
+  return *m_model;
+}
+}
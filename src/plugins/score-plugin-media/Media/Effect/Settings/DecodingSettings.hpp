@@ -0,0 +1,42 @@
+#pragma once
+#include <Media/Effect/Settings/Model.hpp>
+#include <Media/Effect/Settings/View.hpp>
+
+#include <score/plugins/settingsdelegate/SettingsDelegatePresenter.hpp>
+
+#include <verdigris>
+
+class QSpinBox;
+
+namespace Media::Settings
+{
+//! Settings tab of the decoding of audio files
+class DecodingSettings : public PluginSettingsTab
+{
+  W_OBJECT(DecodingSettings)
+  SCORE_CONCRETE("5b5b3b3e-73a8-4c53-9a7e-3f6f0b9f6f2d")
+public:
+  using View = DecodingSettings;
+  using Model = Media::Settings::Model;
+
+  DecodingSettings();
+
+  void setDecodeBudget(int val);
+  void setDecodeThreads(int val);
+
+  QString name() const noexcept override;
+  QWidget* make(const score::ApplicationContext& ctx) override;
+
+public:
+  void DecodeBudgetChanged(int arg_1) W_SIGNAL(DecodeBudgetChanged, arg_1);
+  void DecodeThreadsChanged(int arg_1) W_SIGNAL(DecodeThreadsChanged, arg_1);
+
+private:
+  Model* m_model{};
+  QSpinBox* m_DecodeBudget{};
+  QSpinBox* m_DecodeThreads{};
+
+  score::SettingsCommandDispatcher m_disp;
+  Model& model(DecodingSettings* self);
+};
+}
@@ -25,9 +25,13 @@ SETTINGS_PARAMETER_IMPL(VstPaths)
 
 SETTINGS_PARAMETER_IMPL(VstAlwaysOnTop){
     QStringLiteral("score_plugin_engine/VstAlwaysOnTop"), true};
+SETTINGS_PARAMETER_IMPL(VstSandbox){
+    QStringLiteral("score_plugin_engine/VstSandbox"), false};
+SETTINGS_PARAMETER_IMPL(DecodeBudget){QStringLiteral("Media/DecodeBudget"), 4096};
+SETTINGS_PARAMETER_IMPL(DecodeThreads){QStringLiteral("Media/DecodeThreads"), 0};
 static auto list()
 {
-  return std::tie(VstPaths, VstAlwaysOnTop);
+  return std::tie(VstPaths, VstAlwaysOnTop, VstSandbox, DecodeBudget, DecodeThreads);
 }
 }
 
@@ -38,4 +42,7 @@ Model::Model(QSettings& set, const score::ApplicationContext& ctx)
 
 SCORE_SETTINGS_PARAMETER_CPP(QStringList, Model, VstPaths)
 SCORE_SETTINGS_PARAMETER_CPP(bool, Model, VstAlwaysOnTop)
+SCORE_SETTINGS_PARAMETER_CPP(bool, Model, VstSandbox)
+SCORE_SETTINGS_PARAMETER_CPP(int, Model, DecodeBudget)
+SCORE_SETTINGS_PARAMETER_CPP(int, Model, DecodeThreads)
 }
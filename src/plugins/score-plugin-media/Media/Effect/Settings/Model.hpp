@@ -13,13 +13,28 @@ class SCORE_PLUGIN_MEDIA_EXPORT Model : public score::SettingsDelegateModel
 
   QStringList m_VstPaths;
   bool m_VstAlwaysOnTop{};
+  bool m_VstSandbox{};
+  int m_DecodeBudget{};
+  int m_DecodeThreads{};
 
 public:
   Model(QSettings& set, const score::ApplicationContext& ctx);
 
   SCORE_SETTINGS_PARAMETER_HPP(SCORE_PLUGIN_MEDIA_EXPORT, QStringList, VstPaths)
   SCORE_SETTINGS_PARAMETER_HPP(SCORE_PLUGIN_MEDIA_EXPORT, bool, VstAlwaysOnTop)
+
+  //! Process the VST plug-ins in a separate process, so that crashes do not reach score
+  SCORE_SETTINGS_PARAMETER_HPP(SCORE_PLUGIN_MEDIA_EXPORT, bool, VstSandbox)
+
+  //! Megabytes of decoded audio kept in RAM, files past it are streamed from the disk
+  SCORE_SETTINGS_PARAMETER_HPP(SCORE_PLUGIN_MEDIA_EXPORT, int, DecodeBudget)
+
+  //! Threads decoding audio files, 0 meaning half of the cores
+  SCORE_SETTINGS_PARAMETER_HPP(SCORE_PLUGIN_MEDIA_EXPORT, int, DecodeThreads)
 };
 
 SCORE_SETTINGS_PARAMETER(Model, VstPaths)
+SCORE_SETTINGS_PARAMETER(Model, VstSandbox)
+SCORE_SETTINGS_PARAMETER(Model, DecodeBudget)
+SCORE_SETTINGS_PARAMETER(Model, DecodeThreads)
 }
@@ -2,6 +2,8 @@
 
 #include <Audio/Settings/Model.hpp>
 #include <Media/AudioDecoder.hpp>
+#include <Media/DecodeScheduler.hpp>
+#include <Media/Effect/Settings/Model.hpp>
 #include <Media/RMSData.hpp>
 
 #include <score/application/GUIApplicationContext.hpp>
@@ -21,8 +23,12 @@
 #include <QFileInfo>
 #include <QRegularExpression>
 
+#include <atomic>
+
 namespace Media
 {
+static std::atomic<int64_t> g_residentMemory{};
+
 
 // TODO if it's smaller than e.g. 1 megabyte, it would be worth
 // loading it in memory entirely..
@@ -56,6 +62,20 @@ static DecodingMethod needsDecoding(const QString& path, int rate)
   }
 }
 
+// Size of the file once decoded in RAM by the given method
+static int64_t decodedSize(const QString& path, DecodingMethod method, int rate)
+{
+  const auto& info = probe(path);
+  if(!info || info->fileRate <= 0)
+    return 0;
+
+  // Only libav resamples the file to the engine's rate
+  double frames = info->fileLength;
+  if(method != DecodingMethod::Sndfile)
+    frames = frames * rate / info->fileRate;
+  return int64_t(frames) * info->channels * int64_t(sizeof(ossia::audio_sample));
+}
+
 AudioFile::AudioFile()
 {
   m_impl = Handle{};
@@ -65,6 +85,7 @@ AudioFile::AudioFile()
 AudioFile::~AudioFile()
 {
   delete m_rms;
+  AudioFileManager::releaseMemory(m_reservedMemory);
 }
 
 void AudioFile::load(DecodingSetup opt)
@@ -81,6 +102,34 @@ void AudioFile::load(DecodingSetup opt)
   else if(opt.method == DecodingMethod::Invalid)
     opt.method = needsDecoding(m_file, rate);
 
+  // Files decoded in RAM are streamed from the disk instead when they would
+  // not fit in what remains of the decoding budget
+  AudioFileManager::releaseMemory(m_reservedMemory);
+  m_reservedMemory = 0;
+  switch(opt.method)
+  {
+    case DecodingMethod::Libav:
+    case DecodingMethod::Sndfile:
+    case DecodingMethod::LibavStream: {
+      const auto ram_method = opt.method == DecodingMethod::LibavStream
+                                  ? DecodingMethod::Libav
+                                  : opt.method;
+      const auto bytes = decodedSize(m_file, ram_method, rate);
+      if(AudioFileManager::reserveMemory(bytes))
+      {
+        m_reservedMemory = bytes;
+        opt.method = ram_method;
+      }
+      else
+      {
+        opt.method = DecodingMethod::LibavStream;
+      }
+      break;
+    }
+    default:
+      break;
+  }
+
   switch(opt.method)
   {
     case DecodingMethod::Libav:
@@ -188,6 +237,10 @@ std::optional<double> AudioFile::knownTempo() const noexcept
 
 AudioFileManager::AudioFileManager() noexcept
 {
+  // The files cancel their decoding when they are destroyed:
+  // constructing the scheduler first ensures that it is destroyed last.
+  DecodeScheduler::instance();
+
   auto& audioSettings = score::GUIAppContext().settings<Audio::Settings::Model>();
   con(audioSettings, &Audio::Settings::Model::RateChanged, this,
       [this](auto newRate) { m_handles.clear(); });
@@ -195,6 +248,26 @@ AudioFileManager::AudioFileManager() noexcept
 
 AudioFileManager::~AudioFileManager() noexcept { }
 
+bool AudioFileManager::reserveMemory(int64_t bytes) noexcept
+{
+  const auto& settings = score::GUIAppContext().settings<Media::Settings::Model>();
+  const int64_t budget = int64_t(settings.getDecodeBudget()) * 1024 * 1024;
+
+  auto cur = g_residentMemory.load(std::memory_order_relaxed);
+  do
+  {
+    if(cur + bytes > budget)
+      return false;
+  } while(!g_residentMemory.compare_exchange_weak(
+      cur, cur + bytes, std::memory_order_relaxed));
+  return true;
+}
+
+void AudioFileManager::releaseMemory(int64_t bytes) noexcept
+{
+  g_residentMemory.fetch_sub(bytes, std::memory_order_relaxed);
+}
+
 AudioFileManager& AudioFileManager::instance() noexcept
 {
   static AudioFileManager m;
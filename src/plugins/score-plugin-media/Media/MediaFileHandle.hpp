@@ -242,6 +242,7 @@ private:
   int m_track{-1};
 
   RMSData* m_rms{};
+  int64_t m_reservedMemory{};
   int m_sampleRate{};
   bool m_fullyDecoded{};
 
@@ -260,6 +261,15 @@ public:
 
   std::shared_ptr<AudioFile> get(const QString& absolutePath, int stream);
 
+  /**
+   * @brief Accounts for audio decoded in RAM
+   *
+   * @return false if the bytes would not fit in the decoding budget set in
+   * Media::Settings::Model, in which case nothing is reserved.
+   */
+  static bool reserveMemory(int64_t bytes) noexcept;
+  static void releaseMemory(int64_t bytes) noexcept;
+
 private:
   struct StreamInfo
   {
@@ -28,7 +28,7 @@ void AudioFile::load_libav(int rate)
 
     m_rms->load(m_file, info->channels, rate, info->duration());
 
-    // TODO remove comment when rms works again if(!m_rms->exists())
+    // The waveform pyramid is built in decodeLast unless it was already cached
     {
       connect(
           &r.decoder, &AudioDecoder::newData, this,
@@ -1,9 +1,6 @@
-#include <Audio/Settings/Model.hpp>
 #include <Media/MediaFileHandle.hpp>
 #include <Media/RMSData.hpp>
 
-#include <score/application/GUIApplicationContext.hpp>
-
 #include <ossia/detail/libav.hpp>
 
 #include <QFileInfo>
@@ -23,20 +20,6 @@ void AudioFile::load_libav_stream()
     {
       r.channels = av.channels();
       r.samples = av.totalPCMFrameCount();
-      int64_t raw_megabytes = r.channels * r.samples * 4 / (1024 * 1024.);
-
-      // Less than 100M: we load in ram instead
-      if(raw_megabytes < 100)
-      {
-        av.cleanup();
-
-        const auto& audioSettings
-            = score::GUIAppContext().settings<Audio::Settings::Model>();
-        const auto rate = audioSettings.getRate();
-        load_libav(rate);
-        return;
-      }
-
       m_sampleRate = av.rate();
     }
     else
@@ -22,19 +22,16 @@ void AudioFile::load_sndfile()
       m_file, r.decoder.channels, r.decoder.fileSampleRate,
       TimeVal::fromMsecs(1000. * r.decoder.decoded / r.decoder.fileSampleRate));
 
+  std::vector<tcb::span<const audio_sample>> samples;
   for(auto& channel : r.handle->data)
   {
     r.data.push_back(channel.data());
+    samples.emplace_back(
+        channel.data(), tcb::span<ossia::audio_sample>::size_type(r.decoder.decoded));
   }
 
   m_rms->newData();
-  m_rms->finishedDecoding();
-  /* FIXME
-  if (!m_rms->exists())
-  {
-    m_rms->decode(r.wav);
-  }
-  */
+  m_rms->decodeLast(samples);
 
   QFileInfo fi{m_file};
   m_fileName = fi.fileName();
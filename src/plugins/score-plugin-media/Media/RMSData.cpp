@@ -3,298 +3,581 @@
 #include <Media/MediaFileHandle.hpp>
 #include <Media/RMSData.hpp>
 
+#include <score/tools/ThreadPool.hpp>
+#include <score/tools/std/Invoke.hpp>
+
+#include <ossia/audio/drwav_handle.hpp>
 #include <ossia/detail/math.hpp>
 #include <ossia/detail/ssize.hpp>
 
 #include <QCryptographicHash>
 #include <QDir>
+#include <QFileInfo>
+#include <QSaveFile>
 #include <QStandardPaths>
 
 #include <wobjectimpl.h>
+
+#include <cmath>
 W_OBJECT_IMPL(Media::RMSData)
 namespace Media
 {
 static const constexpr auto rms_buffer_size = 64;
-RMSData::RMSData() { }
+static const constexpr uint32_t rms_magic = 0x50465753; // "SWFP"
+static const constexpr uint32_t rms_version = 1;
 
-void RMSData::load(QString abspath, int channels, int rate, TimeVal duration)
-{ /*
-  this->header = nullptr;
-  this->data = nullptr;
-  this->m_exists = false;
-  if (m_file.isOpen())
-    m_file.close();
+// Frames read from the source at once when building the first level
+static const constexpr int64_t rms_chunk_size = rms_buffer_size * 1024;
 
-  const auto cache = QStandardPaths::standardLocations(
-      QStandardPaths::StandardLocation::CacheLocation);
-  if (cache.empty())
-    throw std::runtime_error("No cache folder");
-
-  QCryptographicHash h{QCryptographicHash::Sha1};
-  h.addData(abspath.toUtf8());
-  auto hash = h.result();
-
-  QDir::root().mkpath(cache.first());
-  QDir cache_dir{cache.first()};
-  cache_dir.mkdir("waveforms");
-  cache_dir.cd("waveforms");
+namespace
+{
+constexpr float rms_factor = std::numeric_limits<rms_sample_t>::max();
 
-  m_file.setFileName(cache_dir.absoluteFilePath(
-      hash.toBase64(QByteArray::Base64UrlEncoding)));
+rms_sample_t toRMSSample(float v) noexcept
+{
+  return rms_sample_t(ossia::clamp(v, -1.f, 1.f) * rms_factor);
+}
 
-  if (m_file.exists())
+/**
+ * Minimum, maximum and sum of squares of a block.
+ *
+ * The values are accumulated in independent lanes and only reduced at the
+ * end: the loop has no dependency between iterations that would prevent
+ * the compiler from turning it into SIMD min / max / fma instructions,
+ * even without -ffast-math.
+ */
+rms_peak_t blockPeak(const float* in, int64_t n) noexcept
+{
+  constexpr int lanes = 8;
+  float l_min[lanes], l_max[lanes], l_sq[lanes];
+  for(int k = 0; k < lanes; k++)
   {
-    m_file.open(QIODevice::ReadOnly);
-    m_exists = true;
+    l_min[k] = in[0];
+    l_max[k] = in[0];
+    l_sq[k] = 0.f;
+  }
 
-    void* data = m_file.map(0, m_file.size());
-    assert(data);
-    this->header = reinterpret_cast<Header*>(data);
-    this->data
-        = reinterpret_cast<rms_sample_t*>(((char*)data) + sizeof(Header));
+  int64_t i = 0;
+  for(; i + lanes <= n; i += lanes)
+  {
+    for(int k = 0; k < lanes; k++)
+    {
+      const float v = in[i + k];
+      l_min[k] = v < l_min[k] ? v : l_min[k];
+      l_max[k] = v > l_max[k] ? v : l_max[k];
+      l_sq[k] += v * v;
+    }
+  }
 
-    frames_count = (m_file.size() - sizeof(Header)) / sizeof(rms_sample_t);
-    samples_count = frames_count * header->channels;
+  float mn = l_min[0], mx = l_max[0], sq = l_sq[0];
+  for(int k = 1; k < lanes; k++)
+  {
+    mn = std::min(mn, l_min[k]);
+    mx = std::max(mx, l_max[k]);
+    sq += l_sq[k];
   }
-  else
+
+  for(; i < n; i++)
   {
-    m_ramData.reserve(
-        duration.msec() * 0.001 * rate * channels * sizeof(rms_sample_t)
-        + 1000);
-    m_ramBuffer.setBuffer(&m_ramData);
-    m_ramBuffer.open(QIODevice::ReadWrite);
-    Header h;
-    h.channels = channels;
-    h.sampleRate = rate;
-    h.bufferSize = rms_buffer_size;
-    m_ramBuffer.write((const char*)&h, sizeof(h));
-
-    this->header = reinterpret_cast<Header*>(m_ramData.data());
-    this->data = reinterpret_cast<rms_sample_t*>(
-        ((char*)m_ramData.data()) + sizeof(Header));
-  }*/
+    const float v = in[i];
+    mn = std::min(mn, v);
+    mx = std::max(mx, v);
+    sq += v * v;
+  }
+
+  return {toRMSSample(mn), toRMSSample(mx), toRMSSample(std::sqrt(sq / n))};
 }
 
-bool RMSData::exists() const
+//! Merges two consecutive entries into one entry of the next level
+rms_peak_t mergePeaks(rms_peak_t a, rms_peak_t b) noexcept
 {
-  return m_exists;
+  const float ra = a.rms, rb = b.rms;
+  return {
+      std::min(a.min, b.min), std::max(a.max, b.max),
+      rms_sample_t(std::sqrt((ra * ra + rb * rb) * 0.5f))};
 }
 
-void RMSData::decode(const std::vector<tcb::span<const ossia::audio_sample>>& audio)
+int64_t levelCount(int64_t blocks) noexcept
 {
-  computeRMS(audio, rms_buffer_size);
+  int64_t levels = 1;
+  while(blocks > 1)
+  {
+    blocks = (blocks + 1) / 2;
+    levels++;
+  }
+  return levels;
 }
 
-void RMSData::decodeLast(const std::vector<tcb::span<const ossia::audio_sample>>& audio)
+int64_t pyramidEntries(int64_t blocks) noexcept
 {
-  computeLastRMS(audio, rms_buffer_size);
-  /*
-  m_file.open(QIODevice::WriteOnly);
-  m_file.write(m_ramData);
-  m_file.flush();
-  m_file.close();*/
-  finishedDecoding();
+  int64_t entries = blocks;
+  while(blocks > 1)
+  {
+    blocks = (blocks + 1) / 2;
+    entries += blocks;
+  }
+  return entries;
+}
 }
 
-void RMSData::decode(ossia::drwav_handle& audio)
-{ /*
-  // store the data in interleaved format, it's much easier...
-  const int64_t channels = audio.channels();
-  if (channels > 0)
-  {
-    const int64_t max_frames = audio.totalPCMFrameCount();
-    constexpr const auto buffer_size = rms_buffer_size;
+RMSData::RMSData() { }
 
-    const int64_t len = sizeof(rms_sample_t) * channels;
-    rms_sample_t* bytes = reinterpret_cast<rms_sample_t*>(alloca(len));
+RMSData::~RMSData()
+{
+  cancel();
+}
 
-    int64_t start_idx = 0;
-    while (start_idx < max_frames)
-    {
-      computeChannelRMS(audio, bytes, buffer_size);
-      m_ramBuffer.write(reinterpret_cast<const char*>(bytes), len);
-      start_idx += buffer_size;
-      frames_count++;
-      samples_count += channels;
-    }
+void RMSData::cancel()
+{
+  // The task reads the audio data owned by the AudioFile which owns us:
+  // once this returns, it does not touch it anymore. This waits at most
+  // for the chunk being read.
+  if(auto build = std::exchange(m_build, {}))
+  {
+    std::lock_guard lock{build->mutex};
+    build->cancelled.store(true, std::memory_order_release);
   }
-*/
-  newData();
-  /*
-  m_file.open(QIODevice::WriteOnly);
-  m_file.write(m_ramData);
-  m_file.flush();
-  m_file.close();*/
-  finishedDecoding();
 }
 
-double RMSData::sampleRateRatio(double expectedRate) const noexcept
+std::shared_ptr<const RMSData::Pyramid> RMSData::pyramid() const noexcept
 {
-  return header->sampleRate / expectedRate;
+  std::lock_guard lock{m_pyramidMutex};
+  return m_pyramid;
 }
 
-ossia::small_vector<float, 8>
-RMSData::frame(int64_t start_frame, int64_t end_frame) const noexcept
+void RMSData::publish(std::shared_ptr<const Pyramid> p) noexcept
 {
-  ossia::small_vector<float, 8> sum;
-  sum.resize(header->channels);
+  // The previous pyramid is released outside of the lock, and only
+  // freed once the readers which copied it are done with it
+  {
+    std::lock_guard lock{m_pyramidMutex};
+    std::swap(m_pyramid, p);
+  }
+}
 
-  assert(start_frame >= 0);
-  assert(end_frame >= 0);
-  const auto channels = header->channels;
-  const auto start_idx = (start_frame / rms_buffer_size);
-  auto end_idx = (end_frame / rms_buffer_size);
+void RMSData::load(QString abspath, int channels, int rate, TimeVal duration)
+{
+  cancel();
+  publish({});
 
-  if(start_idx >= samples_count)
+  m_path = abspath;
+  m_channels = channels;
+  m_rate = rate;
+  m_cachePath.clear();
+
+  m_progress = {};
+  if(channels > 0 && rate > 0)
   {
-    // qDebug() << "bug on start! " << start_idx << samples_count;
-    return sum;
+    // A little room is left in case the duration was underestimated
+    const int64_t frames = duration.msec() * rate / 1000.;
+    m_progress.capacity = frames / rms_buffer_size + 16;
   }
 
-  if(end_idx > samples_count)
+  const auto cache = QStandardPaths::standardLocations(
+      QStandardPaths::StandardLocation::CacheLocation);
+  if(cache.empty())
+    return;
+
+  // The data depends on the rate at which the file is decoded
+  QCryptographicHash h{QCryptographicHash::Sha1};
+  h.addData(abspath.toUtf8());
+  h.addData(QByteArray::number(rate));
+  auto hash = h.result();
+
+  QDir::root().mkpath(cache.first());
+  QDir cache_dir{cache.first()};
+  cache_dir.mkdir("waveforms");
+  if(!cache_dir.cd("waveforms"))
+    return;
+
+  m_cachePath
+      = cache_dir.absoluteFilePath(hash.toBase64(QByteArray::Base64UrlEncoding));
+
+  if(!mapCache())
+    QFile::remove(m_cachePath);
+}
+
+bool RMSData::mapCache()
+{
+  auto file = std::make_shared<QFile>(m_cachePath);
+  if(!file->exists() || !file->open(QIODevice::ReadOnly))
+    return false;
+
+  const auto size = file->size();
+  if(size < int64_t(sizeof(Header)))
+    return false;
+
+  auto data = reinterpret_cast<const char*>(file->map(0, size));
+  if(!data)
+    return false;
+
+  Header h;
+  std::memcpy(&h, data, sizeof(Header));
+
+  const QFileInfo source{m_path};
+  if(h.magic != rms_magic || h.version != rms_version || h.sampleRate != uint32_t(m_rate)
+     || h.channels != uint32_t(m_channels) || h.sourceSize != source.size()
+     || h.sourceModified != source.lastModified().toMSecsSinceEpoch())
+    return false;
+
+  // The mapping lives as long as the QFile, i.e. as long as the last reader
+  auto p = makePyramid(data, size, std::move(file));
+  if(!p)
+    return false;
+
+  publish(std::move(p));
+  return true;
+}
+
+std::shared_ptr<RMSData::Pyramid> RMSData::makePyramid(
+    const char* data, int64_t size, std::shared_ptr<const void> storage)
+{
+  auto p = std::make_shared<Pyramid>();
+  std::memcpy(&p->header, data, sizeof(Header));
+  const auto& header = p->header;
+
+  const int64_t channels = header.channels;
+  const int64_t blocks = header.bufferSize > 0 ? (header.frames + header.bufferSize - 1)
+                                                     / header.bufferSize
+                                               : 0;
+  if(channels == 0 || blocks == 0 || header.levels != levelCount(blocks))
+    return {};
+
+  const auto expected
+      = sizeof(Header) + pyramidEntries(blocks) * channels * sizeof(rms_peak_t);
+  if(size < int64_t(expected))
+    return {};
+
+  auto peaks = reinterpret_cast<const rms_peak_t*>(data + sizeof(Header));
+  int64_t level_blocks = blocks;
+  int64_t frames_per_block = header.bufferSize;
+  for(uint32_t i = 0; i < header.levels; i++)
   {
-    // qDebug() << "bug on end! " << end_idx << samples_count;
-    end_idx = samples_count;
+    p->levels.push_back({peaks, level_blocks, frames_per_block});
+    peaks += level_blocks * channels;
+    level_blocks = (level_blocks + 1) / 2;
+    frames_per_block *= 2;
   }
 
-  rms_sample_t* begin = (data + start_idx);
-  rms_sample_t* end = (data + end_idx);
+  p->complete = true;
+  p->storage = std::move(storage);
+  return p;
+}
 
-  constexpr float size_factor = 1. / std::numeric_limits<rms_sample_t>::max();
-  if(begin == end && start_frame < end_frame)
+bool RMSData::exists() const
+{
+  auto p = pyramid();
+  return p && p->complete;
+}
+
+void RMSData::decode(const std::vector<tcb::span<const ossia::audio_sample>>& audio)
+{
+  auto& prog = m_progress;
+  if(audio.empty() || std::ssize(audio) != m_channels || exists())
   {
-    // Note: we should not enter this case -
-    // instead AudioFileHandle::frame would be used
-    for(std::size_t k = 0; k < channels; k++)
-      sum[k] = begin[k] * size_factor;
-    return sum;
+    newData();
+    return;
   }
 
-  for(; begin < end; begin += channels)
+  // Only the whole blocks decoded since the last call are summarized.
+  // The entries already published are never written again: the readers
+  // of a previous Pyramid only look at those.
+  const int64_t blocks = int64_t(audio.front().size()) / rms_buffer_size;
+  if(blocks > prog.blocks && blocks <= prog.capacity)
   {
-    for(std::size_t k = 0; k < channels; k++)
-    {
-      const float val = begin[k];
-      sum[k] = abs_max(sum[k], val);
-    }
+    if(!prog.peaks)
+      prog.peaks = std::make_shared<std::vector<rms_peak_t>>(prog.capacity * m_channels);
+
+    auto& peaks = *prog.peaks;
+    for(int64_t b = prog.blocks; b < blocks; b++)
+      for(int c = 0; c < m_channels; c++)
+        peaks[b * m_channels + c]
+            = blockPeak(audio[c].data() + b * rms_buffer_size, rms_buffer_size);
+    prog.blocks = blocks;
+
+    auto p = std::make_shared<Pyramid>();
+    p->header.magic = rms_magic;
+    p->header.version = rms_version;
+    p->header.sampleRate = m_rate;
+    p->header.bufferSize = rms_buffer_size;
+    p->header.channels = m_channels;
+    p->header.levels = 1;
+    p->header.frames = blocks * rms_buffer_size;
+    p->levels.push_back({peaks.data(), blocks, rms_buffer_size});
+    p->storage = prog.peaks;
+    publish(std::move(p));
   }
-
-  for(std::size_t k = 0; k < channels; k++)
-    sum[k] *= size_factor;
-
-  return sum;
+  newData();
 }
 
-rms_sample_t RMSData::computeChannelRMS(
-    tcb::span<const ossia::audio_sample> chan, int64_t start_idx, int64_t buffer_size)
+void RMSData::decodeLast(const std::vector<tcb::span<const ossia::audio_sample>>& audio)
 {
-  float val = 0.;
-  auto begin = chan.begin() + start_idx;
-  auto end = begin + buffer_size;
+  if(audio.empty() || exists())
+  {
+    finishedDecoding();
+    return;
+  }
 
-  for(auto it = begin; it < end; ++it)
-    val = abs_max(val, *it);
-  return val * std::numeric_limits<rms_sample_t>::max();
+  const int64_t frames = audio.front().size();
+  build(
+      [audio](int64_t start, int64_t, const float** out) {
+    for(std::size_t c = 0; c < audio.size(); c++)
+      out[c] = audio[c].data() + start;
+    return true;
+      },
+      frames);
 }
 
-void RMSData::computeChannelRMS(
-    ossia::drwav_handle& wav, rms_sample_t* bytes, int64_t buffer_size)
-{ /*
-  const int channels = wav.channels();
-  float* val = (float*)alloca(sizeof(float) * channels);
-
-  float* floats = (float*)alloca(sizeof(float) * buffer_size * channels);
-  auto max = wav.read_pcm_frames_f32(buffer_size, floats);
-  if (max <= 0)
+void RMSData::decode(ossia::drwav_handle& audio)
+{
+  const int channels = audio.channels();
+  if(channels == 0 || exists())
+  {
+    newData();
+    finishedDecoding();
     return;
+  }
 
-  for (int c = 0; c < channels; c++)
-    val[c] = floats[c];
-
-  for (decltype(max) i = 1; i < max; i++)
+  // Each task gets its own handle as reading moves the cursor
+  struct Deinterleaver
   {
-    for (int c = 0; c < channels; c++)
+    ossia::drwav_handle wav;
+    std::vector<float> interleaved;
+    std::vector<std::vector<float>> channels;
+  };
+  auto state = std::make_shared<Deinterleaver>();
+  state->wav = audio;
+  state->channels.resize(channels);
+
+  build(
+      [state, channels](int64_t start, int64_t count, const float** out) {
+    auto& s = *state;
+    if(!s.wav.seek_to_pcm_frame(start))
+      return false;
+
+    s.interleaved.resize(count * channels);
+    const int64_t read = s.wav.read_pcm_frames_f32(count, s.interleaved.data());
+    for(int c = 0; c < channels; c++)
     {
-      const float f = floats[i * channels + c];
-      val[c] = abs_max(val[c], f);
+      auto& chan = s.channels[c];
+      chan.resize(count);
+      for(int64_t i = 0; i < read; i++)
+        chan[i] = s.interleaved[i * channels + c];
+      std::fill(chan.begin() + read, chan.end(), 0.f);
+      out[c] = chan.data();
     }
+    return true;
+      },
+      audio.totalPCMFrameCount());
+}
+
+void RMSData::build(
+    std::function<bool(int64_t, int64_t, const float**)> read, int64_t frames)
+{
+  if(frames <= 0)
+  {
+    newData();
+    finishedDecoding();
+    return;
   }
 
-  for (int c = 0; c < channels; c++)
+  Header h;
+  h.magic = rms_magic;
+  h.version = rms_version;
+  h.sampleRate = m_rate;
+  h.bufferSize = rms_buffer_size;
+  h.channels = m_channels;
+  h.frames = frames;
   {
-    bytes[c] = val[c] * std::numeric_limits<rms_sample_t>::max();
-  }*/
+    const QFileInfo source{m_path};
+    h.sourceSize = source.size();
+    h.sourceModified = source.lastModified().toMSecsSinceEpoch();
+  }
+
+  // A new build supersedes the previous one
+  cancel();
+  auto token = std::make_shared<BuildToken>();
+  m_build = token;
+  score::TaskPool::instance().post(
+      [this, token, h, read = std::move(read), path = m_cachePath]() mutable {
+    const int64_t channels = h.channels;
+    const int64_t blocks = (h.frames + h.bufferSize - 1) / h.bufferSize;
+    h.levels = levelCount(blocks);
+
+    QByteArray bytes;
+    bytes.resize(
+        sizeof(Header) + pyramidEntries(blocks) * channels * sizeof(rms_peak_t));
+    std::memcpy(bytes.data(), &h, sizeof(Header));
+    auto peaks = reinterpret_cast<rms_peak_t*>(bytes.data() + sizeof(Header));
+
+    // First level, from the audio data
+    ossia::small_vector<const float*, 8> chans(channels);
+    bool ok = true;
+    for(int64_t start = 0; start < h.frames && ok; start += rms_chunk_size)
+    {
+      std::lock_guard lock{token->mutex};
+      if(token->cancelled.load(std::memory_order_acquire))
+      {
+        ok = false;
+        break;
+      }
+
+      const int64_t count = std::min(rms_chunk_size, int64_t(h.frames - start));
+      if(!read(start, count, chans.data()))
+      {
+        ok = false;
+        break;
+      }
+
+      const int64_t first_block = start / h.bufferSize;
+      for(int64_t c = 0; c < channels; c++)
+      {
+        for(int64_t f = 0, b = first_block; f < count; f += h.bufferSize, b++)
+        {
+          const int64_t n = std::min(int64_t(h.bufferSize), count - f);
+          peaks[b * channels + c] = blockPeak(chans[c] + f, n);
+        }
+      }
+    }
+
+    // Next levels, each from the previous one
+    if(ok)
+    {
+      rms_peak_t* prev = peaks;
+      int64_t prev_blocks = blocks;
+      while(prev_blocks > 1)
+      {
+        rms_peak_t* cur = prev + prev_blocks * channels;
+        const int64_t cur_blocks = (prev_blocks + 1) / 2;
+        for(int64_t b = 0; b < cur_blocks; b++)
+        {
+          const int64_t b0 = 2 * b, b1 = std::min(2 * b + 1, prev_blocks - 1);
+          for(int64_t c = 0; c < channels; c++)
+          {
+            cur[b * channels + c]
+                = mergePeaks(prev[b0 * channels + c], prev[b1 * channels + c]);
+          }
+        }
+        prev = cur;
+        prev_blocks = cur_blocks;
+      }
+
+      if(!path.isEmpty() && !token->cancelled.load(std::memory_order_acquire))
+      {
+        QSaveFile f{path};
+        if(f.open(QIODevice::WriteOnly))
+        {
+          f.write(bytes);
+          f.commit();
+        }
+      }
+    }
+
+    // Posted events are discarded if the object is destroyed in the meantime.
+    ossia::qt::run_async(this, [this, token, ok, bytes = std::move(bytes)] {
+      // Result of a build cancelled by load() or by a newer build
+      if(token != m_build)
+        return;
+      m_build.reset();
+
+      if(ok && !exists())
+      {
+        if(m_cachePath.isEmpty() || !mapCache())
+        {
+          auto ram = std::make_shared<const QByteArray>(std::move(bytes));
+          if(auto p = makePyramid(ram->constData(), ram->size(), ram))
+            publish(std::move(p));
+        }
+      }
+      m_progress = {};
+      newData();
+      finishedDecoding();
+    });
+  });
 }
 
-void RMSData::computeRMS(
-    const std::vector<tcb::span<const ossia::audio_sample>>& audio, int buffer_size)
+double RMSData::Pyramid::sampleRateRatio(double expectedRate) const noexcept
 {
-  if(audio.empty())
-    return;
-  /*
-  // store the data in interleaved format, it's much easier...
-  const int64_t channels = audio.size();
-  const int64_t max_sample = audio.front().size();
+  return header.sampleRate / expectedRate;
+}
+
+const RMSData::Level& RMSData::Pyramid::levelFor(int64_t frames) const noexcept
+{
+  std::size_t i = 0;
+  while(i + 1 < levels.size() && levels[i + 1].frames_per_block <= frames)
+    i++;
+  return levels[i];
+}
 
-  const int64_t len = sizeof(rms_sample_t) * channels;
-  rms_sample_t* bytes = reinterpret_cast<rms_sample_t*>(alloca(len));
+ossia::small_vector<float, 8>
+RMSData::Pyramid::frame(int64_t start_frame, int64_t end_frame) const noexcept
+{
+  ossia::small_vector<float, 8> sum;
+  const int64_t channels = header.channels;
+  sum.resize(channels);
 
-  int64_t start_idx = frames_count * buffer_size;
-  while (start_idx + buffer_size < max_sample)
+  assert(start_frame >= 0);
+  assert(end_frame >= 0);
+  const auto& level = levelFor(end_frame - start_frame);
+  const int64_t start_idx = start_frame / level.frames_per_block;
+  const int64_t end_idx = std::min(
+      std::max(end_frame / level.frames_per_block, start_idx + 1), level.blocks);
+  if(start_idx >= end_idx)
+    return sum;
+
+  for(int64_t b = start_idx; b < end_idx; b++)
   {
-    for (int i = 0; i < channels; i++)
+    const rms_peak_t* p = level.data + b * channels;
+    for(int64_t k = 0; k < channels; k++)
     {
-      bytes[i] = computeChannelRMS(audio[i], start_idx, buffer_size);
+      const float v = p[k].rms;
+      sum[k] += v * v;
     }
-
-    m_ramBuffer.write(reinterpret_cast<const char*>(bytes), len);
-    start_idx += buffer_size;
-    frames_count++;
-    samples_count += channels;
   }
-*/
-  newData();
+
+  const float n = end_idx - start_idx;
+  for(int64_t k = 0; k < channels; k++)
+    sum[k] = std::sqrt(sum[k] / n) / rms_factor;
+
+  return sum;
 }
 
-void RMSData::computeLastRMS(
-    const std::vector<tcb::span<const ossia::audio_sample>>& audio, int buffer_size)
+void RMSData::Pyramid::minmax_frame(
+    int64_t start_frame, int64_t end_frame,
+    ossia::small_vector<FloatPair, 8>& out) const noexcept
 {
-  if(audio.empty())
+  const int64_t stride = header.channels;
+  const int64_t channels = std::min(int64_t(out.size()), stride);
+  const auto& level = levelFor(end_frame - start_frame);
+  const int64_t start_idx = start_frame / level.frames_per_block;
+  const int64_t end_idx = std::min(
+      std::max(end_frame / level.frames_per_block, start_idx + 1), level.blocks);
+  if(start_idx >= end_idx)
+  {
+    for(auto& val : out)
+      val = {};
     return;
-  /*
-  // store the data in interleaved format, it's much easier...
-  const int channels = std::ssize(audio);
-  const int64_t max_frames = audio.front().size();
+  }
 
-  const int64_t len = sizeof(rms_sample_t) * channels;
-  rms_sample_t* bytes = reinterpret_cast<rms_sample_t*>(alloca(len));
+  // The range covers at most a few blocks of the chosen level
+  const rms_peak_t* p = level.data + start_idx * stride;
+  for(int64_t k = 0; k < channels; k++)
+    out[k] = {float(p[k].min), float(p[k].max)};
 
-  int64_t start_idx = frames_count * buffer_size;
-  while (start_idx + buffer_size < max_frames)
+  for(int64_t b = start_idx + 1; b < end_idx; b++)
   {
-    for (int i = 0; i < channels; i++)
+    p = level.data + b * stride;
+    for(int64_t k = 0; k < channels; k++)
     {
-      bytes[i] = computeChannelRMS(audio[i], start_idx, buffer_size);
+      out[k].first = std::min(out[k].first, float(p[k].min));
+      out[k].second = std::max(out[k].second, float(p[k].max));
     }
-    m_ramBuffer.write(reinterpret_cast<const char*>(bytes), len);
-    start_idx += buffer_size;
-    frames_count++;
-    samples_count += channels;
   }
 
-  if (start_idx < max_frames - 1)
+  for(int64_t k = 0; k < channels; k++)
   {
-    for (int i = 0; i < channels; i++)
-    {
-      bytes[i]
-          = computeChannelRMS(audio[i], start_idx, max_frames - start_idx);
-    }
-    m_ramBuffer.write(reinterpret_cast<const char*>(bytes), len);
-    start_idx += buffer_size;
-    frames_count++;
-    samples_count += channels;
+    out[k].first /= rms_factor;
+    out[k].second /= rms_factor;
   }
-*/
-  newData();
 }
 }
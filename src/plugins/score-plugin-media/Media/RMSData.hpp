@@ -5,68 +5,168 @@
 
 #include <ossia/detail/span.hpp>
 
-#include <QBuffer>
-#include <QFile>
+#include <QObject>
 
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <verdigris>
+
+namespace ossia
+{
+class drwav_handle;
+}
 namespace Media
 {
+struct FloatPair;
 
 using rms_sample_t = int16_t;
+
+//! Summary of a block of frames of a channel, normalized to the rms_sample_t range
+struct rms_peak_t
+{
+  rms_sample_t min{};
+  rms_sample_t max{};
+  rms_sample_t rms{};
+};
+
+/**
+ * @brief Multi-resolution waveform cache of an audio file.
+ *
+ * Level 0 stores, for each block of Header::bufferSize frames and each
+ * channel, the minimum, maximum and RMS value of the block.
+ * Each following level halves the resolution of the previous one,
+ * until a level has a single block.
+ *
+ * While the file is being decoded, level 0 is filled progressively.
+ * The complete pyramid is built once decoding has finished, on the
+ * TaskPool, and is saved in the cache folder: the next sessions map the
+ * file directly instead of going through the audio data again.
+ * Querying a range of frames then only touches a handful of entries,
+ * whatever the length of the range.
+ */
 struct RMSData : public QObject
 {
   W_OBJECT(RMSData)
 public:
   struct Header
   {
+    uint32_t magic{};
+    uint32_t version{};
     uint32_t sampleRate{};
     uint32_t bufferSize{};
     uint32_t channels{};
-    uint32_t padding{};
+    uint32_t levels{};
+    int64_t frames{};
+
+    // Used to detect that the source file changed since the cache was built
+    int64_t sourceSize{};
+    int64_t sourceModified{};
+  };
+
+  struct Level
+  {
+    const rms_peak_t* data{};
+    int64_t blocks{};
+    int64_t frames_per_block{};
+  };
+
+  /**
+   * @brief Immutable state of the pyramid at some point.
+   *
+   * It keeps its storage alive, so that it can be read from the waveform
+   * computer thread while the RMSData loads another file or publishes a
+   * more complete pyramid.
+   */
+  struct Pyramid
+  {
+    Header header;
+    std::vector<Level> levels;
+
+    //! False while only the decoded part of level 0 is available
+    bool complete{};
+
+    //! Frames per entry of the finest level
+    int64_t blockSize() const noexcept { return header.bufferSize; }
+
+    //! Frames covered by the pyramid
+    int64_t frames() const noexcept { return header.frames; }
+
+    double sampleRateRatio(double expectedRate) const noexcept;
+
+    //! RMS value of each channel over the given range
+    ossia::small_vector<float, 8>
+    frame(int64_t start_frame, int64_t end_frame) const noexcept;
+
+    //! Minimum and maximum of each channel over the given range
+    void minmax_frame(
+        int64_t start_frame, int64_t end_frame,
+        ossia::small_vector<FloatPair, 8>& out) const noexcept;
+
+    //! Mapped file, QByteArray or vector in which the entries are stored
+    std::shared_ptr<const void> storage;
+
+  private:
+    //! Finds the coarsest level whose blocks are not larger than the range
+    const Level& levelFor(int64_t frames) const noexcept;
   };
 
   RMSData();
+  ~RMSData();
 
   void load(QString abspath, int channels, int rate, TimeVal duration);
+
+  //! True when the complete pyramid is ready to be queried
   bool exists() const;
 
+  //! Current pyramid, which may be null or incomplete. Thread-safe.
+  std::shared_ptr<const Pyramid> pyramid() const noexcept;
+
   // deinterleaved
   void decode(const std::vector<tcb::span<const ossia::audio_sample>>& audio);
   void decodeLast(const std::vector<tcb::span<const ossia::audio_sample>>& audio);
 
   // interleaved
   void decode(ossia::drwav_handle& audio);
-  double sampleRateRatio(double expectedRate) const noexcept;
-
-  ossia::small_vector<float, 8>
-  frame(int64_t start_sample, int64_t end_sample) const noexcept;
-
-  int64_t frames_count = 0;
-  int64_t samples_count = 0;
-
-  Header* header_ptr() const noexcept { return header; }
-  rms_sample_t* data_ptr() const noexcept { return data; }
 
   void newData() W_SIGNAL(newData);
   void finishedDecoding() W_SIGNAL(finishedDecoding);
 
 private:
-  rms_sample_t computeChannelRMS(
-      tcb::span<const ossia::audio_sample> chan, int64_t start_idx, int64_t buffer_size);
-  void computeRMS(
-      const std::vector<tcb::span<const ossia::audio_sample>>& audio, int buffer_size);
-  void computeLastRMS(
-      const std::vector<tcb::span<const ossia::audio_sample>>& audio, int buffer_size);
-  void
-  computeChannelRMS(ossia::drwav_handle& wav, rms_sample_t* bytes, int64_t buffer_size);
-
-  QFile m_file;
-  bool m_exists{false};
-
-  Header* header{};
-  rms_sample_t* data{};
-
-  QByteArray m_ramData;
-  QBuffer m_ramBuffer;
+  void publish(std::shared_ptr<const Pyramid> p) noexcept;
+  bool mapCache();
+  static std::shared_ptr<Pyramid>
+  makePyramid(const char* data, int64_t size, std::shared_ptr<const void> storage);
+  void build(
+      std::function<bool(int64_t, int64_t, const float**)> read, int64_t frames);
+  void cancel();
+
+  QString m_path;
+  QString m_cachePath;
+  int m_channels{};
+  int m_rate{};
+
+  mutable std::mutex m_pyramidMutex;
+  std::shared_ptr<const Pyramid> m_pyramid;
+
+  //! Level 0 being filled during decoding, allocated for the expected duration
+  struct Progress
+  {
+    std::shared_ptr<std::vector<rms_peak_t>> peaks;
+    int64_t blocks{};
+    int64_t capacity{};
+  } m_progress;
+
+  //! State shared with a background task, one per build
+  struct BuildToken
+  {
+    //! Held by the task while it reads the audio data
+    std::mutex mutex;
+    std::atomic_bool cancelled{false};
+  };
+  std::shared_ptr<BuildToken> m_build;
 };
 
 }
@@ -4,8 +4,11 @@
 #include <Process/ExecutionSetup.hpp>
 #include <Process/ExecutionTransaction.hpp>
 
+#include <Scenario/Document/Interval/IntervalModel.hpp>
 #include <Scenario/Execution/score2OSSIA.hpp>
 
+#include <Media/AudioPrefetcher.hpp>
+
 #include <score/tools/Bind.hpp>
 
 #include <ossia/dataflow/execution_state.hpp>
@@ -222,6 +225,20 @@ public:
       Execution::Transaction& commands)
   {
     auto& p = component.process();
+
+    // The file is decoded from the disk while playing: have its beginning
+    // read in advance, the sounds whose interval starts first being read first.
+    if(const auto& file = p.file(); file && r.samples > 0)
+    {
+      const double position
+          = p.startOffset().msec() * 0.001 * file->sampleRate() / r.samples;
+      int64_t priority = 0;
+      if(auto itv = qobject_cast<Scenario::IntervalModel*>(p.parent()))
+        priority = Scenario::absoluteDate(itv).impl;
+      AudioPrefetcher::instance().prefetch(
+          file->absoluteFileName(), position, priority);
+    }
+
     commands.push_back([n, r = r, samplerate = component.system().execState->sampleRate,
                         tempo = component.process().nativeTempo(),
                         res = make_resampler(component.process()),
@@ -1,6 +1,9 @@
 #include <Process/Dataflow/PortSerialization.hpp>
 
+#include <Scenario/Document/Interval/IntervalModel.hpp>
+
 #include <Audio/Settings/Model.hpp>
+#include <Media/DecodeScheduler.hpp>
 #include <Media/Sound/SoundModel.hpp>
 #include <Media/Tempo.hpp>
 
@@ -62,6 +65,14 @@ void ProcessModel::loadFile(const QString& file, int stream)
   m_file
       = AudioFileManager::instance().get(score::locateFilePath(file, ctx), stream, ctx);
 
+  // Files whose interval starts earlier are decoded first
+  if(!m_file->finishedDecoding())
+  {
+    if(auto itv = qobject_cast<Scenario::IntervalModel*>(parent()))
+      DecodeScheduler::instance().prioritize(
+          m_file->absoluteFileName(), Scenario::absoluteDate(itv).impl);
+  }
+
   m_file->on_mediaChanged.connect<&ProcessModel::on_mediaChanged>(*this);
 }
 
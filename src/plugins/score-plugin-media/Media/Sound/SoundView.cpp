@@ -1,5 +1,6 @@
 #include "SoundView.hpp"
 
+#include <Media/DecodeScheduler.hpp>
 #include <Media/RMSData.hpp>
 #include <Media/Sound/QImagePool.hpp>
 #include <Media/Sound/SoundModel.hpp>
@@ -49,6 +50,11 @@ LayerView::LayerView(const ProcessModel& m, QGraphicsItem* parent)
 
     update();
       });
+
+  // Emitted from the decoding threads
+  connect(
+      &DecodeScheduler::instance(), &DecodeScheduler::progress, this,
+      &LayerView::on_decodeProgress, Qt::QueuedConnection);
 }
 
 LayerView::~LayerView()
@@ -156,6 +162,18 @@ void LayerView::paint_impl(QPainter* painter) const
   if(!m_data)
     return;
 
+  // Only called for the items actually on screen
+  if(!m_data->finishedDecoding())
+  {
+    DecodeScheduler::instance().prioritize(
+        m_data->absoluteFileName(), DecodeScheduler::visible);
+
+    if(m_decodeTotal > 0)
+      painter->drawText(
+          boundingRect().adjusted(4., 2., -4., -2.), Qt::AlignLeft | Qt::AlignTop,
+          tr("Decoding... %1 / %2 files").arg(m_decodeFinished).arg(m_decodeTotal));
+  }
+
   int channels = std::ssize(m_images);
   if(channels == 0.)
   {
@@ -205,6 +223,14 @@ void LayerView::on_newData()
   recompute();
 }
 
+void LayerView::on_decodeProgress(int finished, int total)
+{
+  m_decodeFinished = finished;
+  m_decodeTotal = total;
+  if(m_data && !m_data->finishedDecoding())
+    update();
+}
+
 void LayerView::mousePressEvent(QGraphicsSceneMouseEvent* ev)
 {
   pressed(ev->scenePos());
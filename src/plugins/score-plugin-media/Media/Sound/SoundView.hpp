@@ -47,6 +47,7 @@ private:
   void scrollValueChanged(int);
 
   void on_newData();
+  void on_decodeProgress(int finished, int total);
 
   std::shared_ptr<AudioFile> m_data;
   int m_numChan{};
@@ -61,6 +62,10 @@ private:
   ComputedWaveform m_wf{};
   const ProcessModel& m_model;
 
+  //! Files decoded by the DecodeScheduler, shown until our file is decoded
+  int m_decodeFinished{};
+  int m_decodeTotal{};
+
   bool m_frontColors{true};
   mutable bool m_recomputed{false};
   mutable bool m_renderAll{true};
@@ -56,6 +56,7 @@ struct WaveformComputerImpl
     int64_t decoded_samples{};
     int64_t start_offset{};
     int64_t duration{};
+    const RMSData::Pyramid* rms{};
 
     using frame_fun_t = bool (*)(
         LoopWrapper& h, int64_t start_frame,
@@ -199,6 +200,37 @@ struct WaveformComputerImpl
       }
       return true;
     }
+
+    static bool rms_minmax_frame(
+        LoopWrapper& h, int64_t start_frame, int64_t end_frame,
+        ossia::small_vector<FloatPair, 8>& out) noexcept
+    {
+      const int64_t start = h.start_offset + start_frame;
+      const int64_t end = h.start_offset + end_frame;
+      const int64_t available = std::min(h.decoded_samples, h.rms->frames());
+      if(start < available && end < available)
+      {
+        h.rms->minmax_frame(start, end, out);
+        return true;
+      }
+      else
+      {
+        return false;
+      }
+    }
+    static bool loop_rms_minmax_frame(
+        LoopWrapper& h, int64_t start_frame, int64_t end_frame,
+        ossia::small_vector<FloatPair, 8>& out) noexcept
+    {
+      const int64_t start = h.start_offset + (start_frame % h.duration);
+      const int64_t end = h.start_offset + (end_frame % h.duration);
+      if(start < std::min(h.decoded_samples, h.rms->frames()))
+        h.rms->minmax_frame(start, start < end ? end : start, out);
+      else
+        for(auto& val : out)
+          val = {};
+      return true;
+    }
   } handle;
 
   const WaveformRequest& request;
@@ -663,9 +695,17 @@ struct WaveformComputerImpl
     }
     else
     {
-      // Show rms
+      // With the waveform pyramid, each pixel only reads a few of its
+      // entries instead of all the samples it covers.
+      // The copy keeps it alive if the GUI thread replaces it meanwhile.
+      const auto rms = data.rms().pyramid();
+      if(rms && infos.physical_samples_per_pixels >= rms->blockSize())
+      {
+        handle.rms = rms.get();
+        handle.minmax_frame_impl = request.loops ? LoopWrapper::loop_rms_minmax_frame
+                                                 : LoopWrapper::rms_minmax_frame;
+      }
       compute_mean_minmax(infos);
-      // compute_rms(infos, rms);
     }
   }
 };
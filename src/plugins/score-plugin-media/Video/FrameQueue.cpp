@@ -10,8 +10,13 @@
 #include <ossia/detail/algorithms.hpp>
 #endif
 
+#include <QDebug>
+
 extern "C" {
 #include <libavcodec/avcodec.h>
+#include <libavutil/buffer.h>
+#include <libavutil/cpu.h>
+#include <libavutil/imgutils.h>
 }
 namespace Video
 {
@@ -64,7 +69,10 @@ uint8_t* initFrameBuffer(AVFrame& frame, std::size_t bytes)
 
 FrameQueue::FrameQueue() { }
 
-FrameQueue::~FrameQueue() { }
+FrameQueue::~FrameQueue()
+{
+  releasePool();
+}
 
 void FreeAVFrame::operator()(AVFrame* f) const noexcept
 {
@@ -82,7 +90,10 @@ AVFramePointer FrameQueue::newFrame() noexcept
     return AVFramePointer{f};
   }
 
-  // Frames freed from the rendering thread
+  m_frameRequests.fetch_add(1, std::memory_order_relaxed);
+
+  // Frames freed from the rendering thread.
+  // Unreferencing them gives their buffers back to the pool.
   {
     AVFrame* f{};
     if(released.try_dequeue(f))
@@ -93,6 +104,7 @@ AVFramePointer FrameQueue::newFrame() noexcept
   }
 
   // We actually need to allocate :throw_up_emoji:
+  m_frameMisses.fetch_add(1, std::memory_order_relaxed);
   auto new_frame = av_frame_alloc();
   new_frame->buf[0] = nullptr;
   new_frame->data[0] = nullptr;
@@ -101,6 +113,109 @@ AVFramePointer FrameQueue::newFrame() noexcept
   return AVFramePointer{new_frame};
 }
 
+#if LIBAVUTIL_VERSION_MAJOR >= 57
+using pool_size_t = size_t;
+#else
+using pool_size_t = int;
+#endif
+
+// Only called by the pool when it has no free buffer left
+static AVBufferRef* allocPoolBuffer(void* opaque, pool_size_t size)
+{
+  static_cast<std::atomic<int64_t>*>(opaque)->fetch_add(1, std::memory_order_relaxed);
+  return av_buffer_alloc(size);
+}
+
+AVBufferRef* FrameQueue::acquireBuffer(std::size_t bytes) noexcept
+{
+  if(!m_pool || m_poolBufferSize != bytes)
+  {
+    // Buffers still in use keep the previous pool alive until they are released
+    releasePool();
+
+    m_poolBufferSize = bytes;
+    m_pool = av_buffer_pool_init2(
+        pool_size_t(bytes), &m_bufferMisses, allocPoolBuffer, nullptr);
+    if(!m_pool)
+      return nullptr;
+  }
+
+  m_bufferRequests.fetch_add(1, std::memory_order_relaxed);
+  return av_buffer_pool_get(m_pool);
+}
+
+void FrameQueue::releasePool() noexcept
+{
+  if(m_pool)
+    av_buffer_pool_uninit(&m_pool);
+  m_poolBufferSize = 0;
+}
+
+void FrameQueue::reserveBuffers(std::size_t bytes, int count)
+{
+  std::vector<AVBufferRef*> bufs;
+  bufs.reserve(count);
+  for(int i = 0; i < count; i++)
+  {
+    if(auto buf = acquireBuffer(bytes))
+      bufs.push_back(buf);
+  }
+
+  // Unreferencing the buffers puts them back in the pool
+  for(auto buf : bufs)
+    av_buffer_unref(&buf);
+}
+
+uint8_t* FrameQueue::initFrameBuffer(AVFrame& frame, std::size_t bytes)
+{
+  if(frame.data[0])
+    return frame.data[0];
+
+  auto buf = acquireBuffer(bytes);
+  if(!buf)
+    return nullptr;
+
+  frame.buf[0] = buf;
+  frame.data[0] = buf->data;
+  return buf->data;
+}
+
+std::size_t FrameQueue::frameBufferSize(int format, int width, int height) noexcept
+{
+  // Same alignment as av_frame_get_buffer, which sws_scale expects
+  const int bytes = av_image_get_buffer_size(
+      AVPixelFormat(format), width, height, av_cpu_max_align());
+  return bytes > 0 ? bytes : 0;
+}
+
+bool FrameQueue::allocFrameBuffer(AVFrame& frame) noexcept
+{
+  const auto bytes = frameBufferSize(frame.format, frame.width, frame.height);
+  if(bytes == 0)
+    return false;
+
+  auto buf = acquireBuffer(bytes);
+  if(!buf)
+    return false;
+
+  const auto fmt = AVPixelFormat(frame.format);
+  frame.buf[0] = buf;
+  av_image_fill_arrays(
+      frame.data, frame.linesize, buf->data, fmt, frame.width, frame.height,
+      av_cpu_max_align());
+  frame.extended_data = frame.data;
+  return true;
+}
+
+FrameQueue::Statistics FrameQueue::statistics() const noexcept
+{
+  const auto frames = m_frameRequests.load(std::memory_order_relaxed);
+  const auto frameMisses = m_frameMisses.load(std::memory_order_relaxed);
+  const auto buffers = m_bufferRequests.load(std::memory_order_relaxed);
+  const auto bufferMisses = m_bufferMisses.load(std::memory_order_relaxed);
+  return {frames - frameMisses, frameMisses, buffers - bufferMisses, bufferMisses};
+}
+
 void FrameQueue::enqueue_decoding_error(AVFrame* f)
 {
   this->m_decodeThreadFrameBuffer.push_back(f);
@@ -217,6 +332,15 @@ void FrameQueue::drain()
     av_frame_free(&frame);
   }
   m_decodeThreadFrameBuffer.clear();
+
+  releasePool();
+
+#if defined(SCORE_LIBAV_FRAME_DEBUGGING)
+  const auto stats = statistics();
+  qDebug() << "Frame pool: frames" << stats.frameHits << "hits" << stats.frameMisses
+           << "misses; buffers" << stats.bufferHits << "hits" << stats.bufferMisses
+           << "misses";
+#endif
 }
 
 }
@@ -19,6 +19,8 @@
 
 extern "C" {
 struct AVFrame;
+struct AVBufferPool;
+struct AVBufferRef;
 }
 namespace Video
 {
@@ -49,9 +51,25 @@ inline struct frame_counters
   } while(0)
 #endif
 
+/**
+ * @brief Queue of decoded frames between a decoder thread and a renderer.
+ *
+ * Both the AVFrame structures and the buffers of the frames that the queue
+ * allocates itself (e.g. the output of Rescale) are recycled: buffers come
+ * from a pool sized for the current format of the stream, so that
+ * steady-state decoding does not go through the allocator.
+ */
 struct SCORE_PLUGIN_MEDIA_EXPORT FrameQueue
 {
 public:
+  struct Statistics
+  {
+    int64_t frameHits{};
+    int64_t frameMisses{};
+    int64_t bufferHits{};
+    int64_t bufferMisses{};
+  };
+
   FrameQueue();
   ~FrameQueue();
 
@@ -62,6 +80,24 @@ public:
 
   AVFramePointer newFrame() noexcept;
 
+  //! Allocates count buffers of the given size in advance
+  void reserveBuffers(std::size_t bytes, int count);
+
+  //! Size of the buffer given by allocFrameBuffer to a frame, 0 if invalid
+  static std::size_t frameBufferSize(int format, int width, int height) noexcept;
+
+  //! Gives the frame a pooled buffer for a single plane of the given size
+  uint8_t* initFrameBuffer(AVFrame& frame, std::size_t bytes);
+
+  /**
+   * @brief Gives the frame pooled buffers for its format, width and height.
+   *
+   * Rows are aligned like in av_frame_get_buffer: the renderer only uploads
+   * a plane without copying it when its rows are not padded, e.g. for
+   * RGBA frames whose width is a multiple of 16.
+   */
+  bool allocFrameBuffer(AVFrame& frame) noexcept;
+
   void enqueue_decoding_error(AVFrame* f);
   void enqueue(AVFrame* f);
   AVFrame* dequeue() noexcept;
@@ -75,12 +111,26 @@ public:
 
   std::size_t size() const noexcept { return available.size_approx(); }
 
+  Statistics statistics() const noexcept;
+
 private:
+  AVBufferRef* acquireBuffer(std::size_t bytes) noexcept;
+  void releasePool() noexcept;
+
   ossia::mpmc_queue<AVFrame*> available;
   ossia::mpmc_queue<AVFrame*> released;
 
   std::vector<AVFrame*> m_decodeThreadFrameBuffer;
   std::atomic<AVFrame*> m_discardUntil{};
+
+  // Only used from the thread which fills the queue
+  AVBufferPool* m_pool{};
+  std::size_t m_poolBufferSize{};
+
+  std::atomic<int64_t> m_frameRequests{};
+  std::atomic<int64_t> m_frameMisses{};
+  std::atomic<int64_t> m_bufferRequests{};
+  std::atomic<int64_t> m_bufferMisses{};
 };
 
 SCORE_PLUGIN_MEDIA_EXPORT
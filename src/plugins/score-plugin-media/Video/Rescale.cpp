@@ -62,8 +62,7 @@ void Rescale::rescale(FrameQueue& m_frames, AVFramePointer& frame, ReadFrame& re
   rgb->width = src.width;
   rgb->height = src.height;
   rgb->format = AV_PIX_FMT_RGBA;
-  rgb->linesize[0] = 4 * src.width;
-  av_frame_get_buffer(rgb, 0);
+  m_frames.allocFrameBuffer(*rgb);
 
   // 2. Convert
   sws_scale(
@@ -68,6 +68,13 @@ void LibAVDecoder::init_scaler(VideoInterface& self) noexcept
 
   m_rescale.open(self);
   self.pixel_format = AV_PIX_FMT_RGBA;
+
+  // Enough for the frames buffered by the decoder and the ones being rendered.
+  // The size must match the one of the buffers that Rescale requests.
+  const auto bytes
+      = FrameQueue::frameBufferSize(AV_PIX_FMT_RGBA, self.width, self.height);
+  if(bytes > 0)
+    m_frames.reserveBuffers(bytes, 16);
 }
 
 int LibAVDecoder::init_codec_context(
@@ -7,6 +7,7 @@
 #include <Dataflow/WidgetInletFactory.hpp>
 #include <Library/LibraryInterface.hpp>
 #include <Media/AudioFileChooserWidget.hpp>
+#include <Media/Effect/Settings/DecodingSettings.hpp>
 #include <Media/Effect/Settings/Factory.hpp>
 #include <Media/Inspector/Factory.hpp>
 #include <Media/Libav.hpp>
@@ -116,6 +117,7 @@ std::vector<score::InterfaceBase*> score_plugin_media::factories(
          Execution::MergerComponentFactory>,
       FW<Process::ProcessDropHandler, Media::Sound::DropHandler>,
       FW<score::SettingsDelegateFactory, Media::Settings::Factory>,
+      FW<Media::Settings::PluginSettingsTab, Media::Settings::DecodingSettings>,
       FW<score::PanelDelegateFactory, Mixer::PanelDelegateFactory>,
       FW<Process::PortFactory, Dataflow::WidgetInletFactory<
                                    Process::AudioFileChooser, Media::AudioFileChooser>>
@@ -5,28 +5,31 @@
 #include <Midi/MidiProcess.hpp>
 
 #include <ossia/dataflow/nodes/midi.hpp>
+
+#include <QTimer>
 namespace Midi
 {
 namespace Executor
 {
 
 using midi_node = ossia::nodes::midi;
-static midi_node::note_set to_ossia(Component& c)
+
+// Notes starting before the process are cut at its start
+static NoteData clamped(NoteData data)
 {
-  midi_node::note_set notes;
-  auto& element = c.process();
-  notes.reserve(element.notes.size());
-  for(const auto& n : element.notes)
+  if(data.start() < 0 && data.end() > 0)
   {
-    auto data = n.noteData();
-    if(data.start() < 0 && data.end() > 0)
-    {
-      data.setStart(0.);
-      data.setDuration(data.duration() + data.start());
-    }
-    notes.insert(c.to_note(data));
+    data.setDuration(data.end());
+    data.setStart(0.);
   }
-  return notes;
+  return data;
+}
+
+static ossia::nodes::note_data to_ossia_note(const NoteData& n)
+{
+  return {
+      ossia::time_value{int64_t(n.start())}, ossia::time_value{int64_t(n.duration())},
+      n.pitch(), n.velocity()};
 }
 
 using midi_node_process = ossia::nodes::midi_node_process;
@@ -40,22 +43,12 @@ Component::Component(
   m_ossia_process = std::make_shared<midi_node_process>(midi);
 
   midi->set_channel(element.channel());
-  midi->set_notes(to_ossia(*this));
+  midi->set_notes(to_ossia());
 
   element.notes.added.connect<&Component::on_noteAdded>(this);
   element.notes.removing.connect<&Component::on_noteRemoved>(this);
   element.notes.replaced.connect<&Component::on_notesReplaced>(this);
-
-  for(auto& note : element.notes)
-  {
-    QObject::connect(
-        &note, &Note::noteChanged, this,
-        [&, midi, cur = to_note(note.noteData())]() mutable {
-      auto old = cur;
-      cur = to_note(note.noteData());
-      in_exec([old, cur, midi] { midi->update_note(old, cur); });
-        });
-  }
+  element.noteChanged.connect<&Component::on_noteChanged>(this);
 
   QObject::connect(
       &element, &Midi::ProcessModel::notesChanged, this, &Component::on_notesReplaced);
@@ -63,31 +56,109 @@ Component::Component(
 
 Component::~Component() { }
 
+midi_node::note_set Component::to_ossia()
+{
+  m_notes.clear();
+  m_changed.clear();
+  m_removed.clear();
+
+  auto& element = process();
+  std::vector<std::pair<NoteTable::id_type, NoteData>> table;
+  table.reserve(element.notes.size());
+  for(const auto& n : element.notes)
+    table.emplace_back(n.id().val(), to_table(n.noteData()));
+  m_notes.assign(std::move(table));
+
+  std::vector<ossia::nodes::note_data> notes;
+  notes.reserve(m_notes.size());
+  for(std::size_t i = 0; i < m_notes.size(); i++)
+    notes.push_back(to_ossia_note(m_notes.at(i)));
+
+  // Inserting all the notes at once only sorts them once
+  midi_node::note_set set;
+  set.insert(notes.begin(), notes.end());
+  return set;
+}
+
 void Component::on_noteAdded(const Note& n)
 {
-  auto midi = std::dynamic_pointer_cast<midi_node>(node);
-  in_exec([nd = to_note(n.noteData()), midi] { midi->add_note(nd); });
+  m_changed.insert(&n);
+  scheduleUpdate();
+}
 
-  QObject::connect(
-      &n, &Note::noteChanged, this, [&, midi, cur = to_note(n.noteData())]() mutable {
-        auto old = cur;
-        cur = to_note(n.noteData());
-        in_exec([old, cur, midi] { midi->update_note(old, cur); });
-      });
+void Component::on_noteChanged(const Note& n)
+{
+  m_changed.insert(&n);
+  scheduleUpdate();
 }
 
 void Component::on_noteRemoved(const Note& n)
 {
-  auto midi = std::dynamic_pointer_cast<midi_node>(node);
-  in_exec([nd = to_note(n.noteData()), midi] { midi->remove_note(nd); });
+  m_changed.erase(&n);
+  m_removed.push_back(n.id().val());
+  scheduleUpdate();
 }
 
 void Component::on_notesReplaced()
 {
+  // The replaced notes are already deleted: everything pending is dropped
+  auto midi = std::dynamic_pointer_cast<midi_node>(node);
+  in_exec([n = to_ossia(), midi]() mutable { midi->replace_notes(std::move(n)); });
+}
+
+void Component::scheduleUpdate()
+{
+  if(!m_updateScheduled)
+  {
+    m_updateScheduled = true;
+    QTimer::singleShot(0, this, [this] { sendUpdates(); });
+  }
+}
+
+void Component::sendUpdates()
+{
+  m_updateScheduled = false;
+  if(m_changed.empty() && m_removed.empty())
+    return;
+
+  NoteTable::Batch batch;
+  batch.removed = std::move(m_removed);
+  batch.set.reserve(m_changed.size());
+  for(const Note* n : m_changed)
+    batch.set.emplace_back(n->id().val(), to_table(n->noteData()));
+  m_changed.clear();
+  m_removed.clear();
+
+  std::vector<ossia::nodes::note_data> removed, added;
+  std::vector<std::pair<ossia::nodes::note_data, ossia::nodes::note_data>> updated;
+  m_notes.apply(
+      std::move(batch), [&](auto, const NoteData* before, const NoteData* after) {
+    if(before && after)
+      updated.emplace_back(to_ossia_note(*before), to_ossia_note(*after));
+    else if(after)
+      added.push_back(to_ossia_note(*after));
+    else
+      removed.push_back(to_ossia_note(*before));
+  });
+
   auto midi = std::dynamic_pointer_cast<midi_node>(node);
+  in_exec([midi, removed = std::move(removed), updated = std::move(updated),
+           added = std::move(added)] {
+    for(const auto& n : removed)
+      midi->remove_note(n);
+    for(const auto& [old, cur] : updated)
+      midi->update_note(old, cur);
+    for(const auto& n : added)
+      midi->add_note(n);
+  });
+}
 
-  in_exec([n = to_ossia(*this), midi]() mutable { midi->replace_notes(std::move(n)); });
+NoteData Component::to_table(const NoteData& n)
+{
+  const auto nd = to_note(clamped(n));
+  return {double(nd.start.impl), double(nd.duration.impl), nd.pitch, nd.velocity};
 }
+
 ossia::nodes::note_data Component::to_note(const NoteData& n)
 {
   auto& cv_time = system().time;
@@ -3,14 +3,12 @@
 #include <Process/ExecutionContext.hpp>
 
 #include <Midi/MidiNote.hpp>
+#include <Midi/NoteTable.hpp>
 
 #include <ossia/dataflow/node_process.hpp>
-#include <ossia/detail/flat_set.hpp>
+#include <ossia/dataflow/nodes/midi.hpp>
+#include <ossia/detail/hash_map.hpp>
 #include <ossia/editor/scenario/time_process.hpp>
-namespace ossia::nodes
-{
-struct note_data;
-}
 
 namespace Device
 {
@@ -32,10 +30,26 @@ public:
   ~Component() override;
 
   void on_noteAdded(const Midi::Note&);
+  void on_noteChanged(const Midi::Note&);
   void on_noteRemoved(const Midi::Note&);
   void on_notesReplaced();
 
   ossia::nodes::note_data to_note(const NoteData& n);
+
+private:
+  ossia::nodes::midi::note_set to_ossia();
+  NoteData to_table(const NoteData& n);
+  void scheduleUpdate();
+  void sendUpdates();
+
+  // The notes as they currently are in the execution node, with their start
+  // and duration in execution time
+  NoteTable m_notes;
+
+  // Changes not sent yet: they are sent all at once on the next event loop
+  ossia::hash_set<const Note*> m_changed;
+  std::vector<NoteTable::id_type> m_removed;
+  bool m_updateScheduled{};
 };
 
 using ComponentFactory = ::Execution::ProcessComponentFactory_T<Component>;
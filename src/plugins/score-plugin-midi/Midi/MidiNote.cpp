@@ -2,6 +2,8 @@
 // it. PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
 #include "MidiNote.hpp"
 
+#include <Midi/MidiProcess.hpp>
+
 #include <wobjectimpl.h>
 W_OBJECT_IMPL(Midi::Note)
 
@@ -28,7 +30,7 @@ void Note::scale(double s) noexcept
   {
     m_start *= s;
     m_duration *= s;
-    noteChanged();
+    changed();
   }
 }
 
@@ -37,7 +39,7 @@ void Note::setStart(double s) noexcept
   if(m_start != s)
   {
     m_start = s;
-    noteChanged();
+    changed();
   }
 }
 
@@ -46,7 +48,7 @@ void Note::setDuration(double s) noexcept
   if(m_duration != s)
   {
     m_duration = s;
-    noteChanged();
+    changed();
   }
 }
 
@@ -55,7 +57,7 @@ void Note::setPitch(midi_size_t s) noexcept
   if(m_pitch != s)
   {
     m_pitch = s;
-    noteChanged();
+    changed();
   }
 }
 
@@ -64,10 +66,18 @@ void Note::setVelocity(midi_size_t s) noexcept
   if(m_velocity != s)
   {
     m_velocity = s;
-    noteChanged();
+    changed();
   }
 }
 
+void Note::changed() noexcept
+{
+  noteChanged();
+
+  // Notes are always children of their process
+  static_cast<ProcessModel*>(parent())->noteChanged(*this);
+}
+
 NoteData Note::noteData() const noexcept
 {
   return NoteData{m_start, m_duration, m_pitch, m_velocity};
@@ -80,6 +90,6 @@ void Note::setData(NoteData d) noexcept
   m_pitch = d.m_pitch;
   m_velocity = d.m_velocity;
 
-  noteChanged();
+  changed();
 }
 }
@@ -103,6 +103,8 @@ public:
   void noteChanged() W_SIGNAL(noteChanged);
 
 private:
+  void changed() noexcept;
+
   double m_start{};
   double m_duration{};
 
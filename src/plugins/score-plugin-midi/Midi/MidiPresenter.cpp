@@ -60,25 +60,18 @@ Presenter::Presenter(
       },
       Qt::QueuedConnection);
   con(model, &ProcessModel::notesNeedUpdate, this, [&] {
-    for(auto note : m_notes)
-      updateNote(*note);
-  });
-
-  con(model, &ProcessModel::notesChanged, this, [&] {
-    for(auto note : m_notes)
+    // Only the notes which were modified since the last update are moved
+    for(const Note* n : m_changedNotes)
     {
-      delete note;
-    }
-
-    m_notes.clear();
-    m_selectedNotes.clear();
-
-    for(auto& note : model.notes)
-    {
-      on_noteAdded(note);
+      auto it = m_noteIndex.find(n);
+      if(it != m_noteIndex.end())
+        updateNote(*m_notes[it->second]);
     }
+    m_changedNotes.clear();
   });
 
+  con(model, &ProcessModel::notesChanged, this, [&] { on_notesReplaced(); });
+
   con(model, &ProcessModel::rangeChanged, this, [this](int min, int max) {
     m_view->setRange(min, max);
     for(auto note : m_notes)
@@ -88,6 +81,7 @@ Presenter::Presenter(
   model.notes.added.connect<&Presenter::on_noteAdded>(this);
   model.notes.removing.connect<&Presenter::on_noteRemoving>(this);
   model.notes.replaced.connect<&Presenter::on_notesReplaced>(this);
+  model.noteChanged.connect<&Presenter::on_noteDataChanged>(this);
 
   connect(m_view, &View::doubleClicked, this, [&](QPointF pos) {
     CommandDispatcher<>{context().context.commandStack}.submit(
@@ -307,9 +301,15 @@ void Presenter::on_noteAdded(const Note& n)
 {
   auto v = new NoteView{n, *this, m_view};
   updateNote(*v);
+  m_noteIndex[&n] = m_notes.size();
   m_notes.push_back(v);
 }
 
+void Presenter::on_noteDataChanged(const Note& n)
+{
+  m_changedNotes.insert(&n);
+}
+
 void Presenter::on_noteRemoving(const Note& n)
 {
   {
@@ -321,25 +321,38 @@ void Presenter::on_noteRemoving(const Note& n)
       m_selectedNotes.erase(it);
     }
   }
+
+  m_changedNotes.erase(&n);
+
+  auto it = m_noteIndex.find(&n);
+  if(it != m_noteIndex.end())
   {
-    auto it
-        = ossia::find_if(m_notes, [&](const auto& other) { return &other->note == &n; });
+    // The order of the views does not matter: the last one takes the place
+    // of the removed one, so that removing all the notes stays linear.
+    const std::size_t idx = it->second;
+    m_noteIndex.erase(it);
 
-    if(it != m_notes.end())
+    delete m_notes[idx];
+    if(idx != m_notes.size() - 1)
     {
-      delete *it;
-      m_notes.erase(it);
+      m_notes[idx] = m_notes.back();
+      m_noteIndex[&m_notes[idx]->note] = idx;
     }
+    m_notes.pop_back();
   }
 }
 
 void Presenter::on_notesReplaced()
 {
   m_selectedNotes.clear();
+  m_changedNotes.clear();
+  m_noteIndex.clear();
   for(auto& n : m_notes)
     delete n;
   m_notes.clear();
 
+  m_notes.reserve(this->model().notes.size());
+  m_noteIndex.reserve(this->model().notes.size());
   for(auto& note : this->model().notes)
   {
     on_noteAdded(note);
@@ -6,6 +6,8 @@
 
 #include <score/command/Dispatchers/SingleOngoingCommandDispatcher.hpp>
 
+#include <ossia/detail/hash_map.hpp>
+
 #include <nano_observer.hpp>
 class QMimeData;
 namespace Midi
@@ -49,6 +51,7 @@ public:
 private:
   void updateNote(NoteView&);
   void on_noteAdded(const Note&);
+  void on_noteDataChanged(const Note&);
   void on_noteRemoving(const Note&);
   void on_notesReplaced();
   void on_drop(const QPointF& pos, const QMimeData&);
@@ -59,6 +62,10 @@ private:
   std::vector<NoteView*> m_notes;
   std::vector<NoteView*> m_selectedNotes;
 
+  // Position of the view of each note in m_notes
+  ossia::hash_map<const Note*, std::size_t> m_noteIndex;
+  ossia::hash_set<const Note*> m_changedNotes;
+
   SingleOngoingCommandDispatcher<MoveNotes> m_moveDispatcher;
   SingleOngoingCommandDispatcher<ChangeNotesVelocity> m_velocityDispatcher;
 
@@ -35,6 +35,13 @@ public:
 
   score::EntityMap<Note> notes;
 
+  /**
+   * Emitted when the data of one of the notes changes.
+   * Allows to follow the changes of all the notes without having to
+   * connect to each of them.
+   */
+  mutable Nano::Signal<void(const Note&)> noteChanged;
+
   void setChannel(int n);
   int channel() const;
 
@@ -0,0 +1,239 @@
+#pragma once
+#include <Midi/MidiNote.hpp>
+
+#include <ossia/detail/hash_map.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace Midi
+{
+/**
+ * @brief Flat storage of note data, sorted by start.
+ *
+ * Each field is stored in its own column, so that looking for the notes of a
+ * time range only reads the start and duration columns.
+ * Notes are identified by an integer, usually the id of their Note.
+ * Changes are applied in batches: the columns are rebuilt in a single pass,
+ * and only the changed notes are sorted and looked up.
+ */
+class NoteTable
+{
+public:
+  using id_type = int32_t;
+
+  //! Changes applied at once by apply()
+  struct Batch
+  {
+    std::vector<id_type> removed;
+
+    //! Notes added, or modified if the id is already in the table
+    std::vector<std::pair<id_type, NoteData>> set;
+
+    bool empty() const noexcept { return removed.empty() && set.empty(); }
+  };
+
+  std::size_t size() const noexcept { return m_start.size(); }
+  bool empty() const noexcept { return m_start.empty(); }
+
+  id_type id(std::size_t i) const noexcept { return m_id[i]; }
+  NoteData at(std::size_t i) const noexcept
+  {
+    return {m_start[i], m_duration[i], m_pitch[i], m_velocity[i]};
+  }
+
+  const std::vector<double>& starts() const noexcept { return m_start; }
+  const std::vector<double>& durations() const noexcept { return m_duration; }
+
+  //! End of the last note to finish
+  double maxEnd() const noexcept { return m_maxEnd; }
+
+  //! Index of a note, or size() if it is not in the table
+  std::size_t find(id_type id) const noexcept
+  {
+    auto it = m_startOf.find(id);
+    if(it == m_startOf.end())
+      return size();
+
+    auto i = std::size_t(
+        std::lower_bound(m_start.begin(), m_start.end(), it->second)
+        - m_start.begin());
+    for(; i < size() && m_start[i] == it->second; i++)
+      if(m_id[i] == id)
+        return i;
+    return size();
+  }
+
+  void clear()
+  {
+    m_start.clear();
+    m_duration.clear();
+    m_pitch.clear();
+    m_velocity.clear();
+    m_id.clear();
+    m_startOf.clear();
+    m_maxDuration = 0.;
+    m_maxEnd = 0.;
+  }
+
+  //! Replaces the whole content, sorting it once
+  void assign(std::vector<std::pair<id_type, NoteData>> notes)
+  {
+    sortByStart(notes);
+
+    clear();
+    reserve(notes.size());
+    m_startOf.reserve(notes.size());
+    for(const auto& [id, n] : notes)
+    {
+      push_back(id, n);
+      m_startOf[id] = n.start();
+    }
+  }
+
+  /**
+   * Applies a batch of changes.
+   *
+   * f(id, const NoteData* before, const NoteData* after) is called for each
+   * change: before is null for added notes, after is null for removed ones.
+   * Removals come first: a note which is both removed and set is replaced.
+   */
+  template <typename F>
+  void apply(Batch batch, F&& f)
+  {
+    if(batch.empty())
+      return;
+
+    // Rows replaced or removed by the batch
+    std::vector<std::size_t> dropped;
+    dropped.reserve(batch.removed.size() + batch.set.size());
+    ossia::hash_map<id_type, NoteData> before;
+    auto drop = [&](id_type id) {
+      if(before.find(id) != before.end())
+        return;
+      if(auto i = find(id); i != size())
+      {
+        dropped.push_back(i);
+        before.emplace(id, at(i));
+      }
+    };
+
+    // If a note is set more than once, the last one wins
+    ossia::hash_set<id_type> set_ids;
+    {
+      std::vector<std::pair<id_type, NoteData>> set;
+      set.reserve(batch.set.size());
+      for(auto it = batch.set.rbegin(); it != batch.set.rend(); ++it)
+        if(set_ids.insert(it->first).second)
+          set.push_back(*it);
+      batch.set = std::move(set);
+    }
+
+    for(id_type id : batch.removed)
+      drop(id);
+    for(const auto& [id, n] : batch.set)
+      drop(id);
+
+    std::sort(dropped.begin(), dropped.end());
+    sortByStart(batch.set);
+
+    for(id_type id : batch.removed)
+    {
+      if(set_ids.find(id) != set_ids.end())
+        continue;
+      if(auto it = before.find(id); it != before.end())
+      {
+        f(id, &it->second, (const NoteData*)nullptr);
+        before.erase(it);
+        m_startOf.erase(id);
+      }
+    }
+    for(const auto& [id, n] : batch.set)
+    {
+      auto it = before.find(id);
+      f(id, it != before.end() ? &it->second : (const NoteData*)nullptr, &n);
+      m_startOf[id] = n.start();
+    }
+
+    // Merge the rows which are kept with the new ones
+    NoteTable res;
+    res.m_startOf = std::move(m_startOf);
+    res.reserve(size() - dropped.size() + batch.set.size());
+    std::size_t next_dropped = 0;
+    auto next_set = batch.set.begin();
+    for(std::size_t i = 0; i < size(); i++)
+    {
+      if(next_dropped < dropped.size() && dropped[next_dropped] == i)
+      {
+        next_dropped++;
+        continue;
+      }
+
+      for(; next_set != batch.set.end() && next_set->second.start() < m_start[i];
+          ++next_set)
+        res.push_back(next_set->first, next_set->second);
+      res.push_back(m_id[i], at(i));
+    }
+    for(; next_set != batch.set.end(); ++next_set)
+      res.push_back(next_set->first, next_set->second);
+
+    *this = std::move(res);
+  }
+
+  /**
+   * Calls f(index) for each note which overlaps [t0, t1[, in order of start.
+   */
+  template <typename F>
+  void forEachIn(double t0, double t1, F&& f) const
+  {
+    auto i = std::size_t(
+        std::lower_bound(m_start.begin(), m_start.end(), t0 - m_maxDuration)
+        - m_start.begin());
+    for(; i < size() && m_start[i] < t1; i++)
+      if(m_start[i] + m_duration[i] > t0)
+        f(i);
+  }
+
+private:
+  static void sortByStart(std::vector<std::pair<id_type, NoteData>>& notes)
+  {
+    std::stable_sort(notes.begin(), notes.end(), [](const auto& lhs, const auto& rhs) {
+      return lhs.second.start() < rhs.second.start();
+    });
+  }
+
+  void reserve(std::size_t n)
+  {
+    m_start.reserve(n);
+    m_duration.reserve(n);
+    m_pitch.reserve(n);
+    m_velocity.reserve(n);
+    m_id.reserve(n);
+  }
+
+  void push_back(id_type id, const NoteData& n)
+  {
+    m_start.push_back(n.start());
+    m_duration.push_back(n.duration());
+    m_pitch.push_back(n.pitch());
+    m_velocity.push_back(n.velocity());
+    m_id.push_back(id);
+    m_maxDuration = std::max(m_maxDuration, n.duration());
+    m_maxEnd = std::max(m_maxEnd, n.end());
+  }
+
+  std::vector<double> m_start;
+  std::vector<double> m_duration;
+  std::vector<midi_size_t> m_pitch;
+  std::vector<midi_size_t> m_velocity;
+  std::vector<id_type> m_id;
+
+  // Allows to find a note with a binary search on the start column
+  ossia::hash_map<id_type, double> m_startOf;
+
+  double m_maxDuration{};
+  double m_maxEnd{};
+};
+}
@@ -1,4 +1,5 @@
 #include <Process/Dataflow/Port.hpp>
+#include <Process/Execution/GUIThreadNode.hpp>
 
 #include <Explorer/DocumentPlugin/DeviceDocumentPlugin.hpp>
 
@@ -175,12 +176,10 @@ PdGraphNode::PdGraphNode(
   }
 
   // Set-up buffers
-  const std::size_t bs = libpd_blocksize();
-  m_inbuf.resize(m_audioIns * bs);
-  m_outbuf.resize(m_audioOuts * bs);
-  m_prev_outbuf.resize(m_audioOuts);
-  for(auto& circ : m_prev_outbuf)
-    circ.set_capacity(8192);
+  m_blocks.reset(
+      m_audioIns, m_audioOuts, libpd_blocksize(), ctx.execState->bufferSize);
+  m_inptrs.resize(m_audioIns);
+  m_outptrs.resize(m_audioOuts);
 
   // Create instance
   libpd_set_instance(m_instance->instance);
@@ -360,10 +359,6 @@ void PdGraphNode::run(const ossia::token_request& t, ossia::exec_state_facade e)
   libpd_set_instance(m_instance->instance);
   m_currentInstance = this;
   //libpd_init_audio(m_audioIns, m_audioOuts, e.sampleRate());
-  const uint64_t bs = libpd_blocksize();
-
-  // Clear audio inputs
-  ossia::fill(m_inbuf, 0.f);
 
   // Copy midi inputs
   if(m_midi_inlet)
@@ -417,102 +412,51 @@ void PdGraphNode::run(const ossia::token_request& t, ossia::exec_state_facade e)
     }
   }
 
-  // Compute number of samples to process
-  const std::size_t input_channels
-      = std::min(m_audioIns, m_audio_inlet ? m_audio_inlet->channels() : 0);
+  // Pd processes samples in blocks of libpd_blocksize(): the audio goes
+  // through m_blocks, which only delays the output by one block when the
+  // buffer size is not a multiple of it.
   const auto [start_sample, req_samples] = e.timings(t);
-  if(m_audioOuts == 0)
+  if(req_samples <= 0)
   {
-    libpd_process_raw(m_inbuf.data(), m_outbuf.data());
+    m_currentInstance = nullptr;
+    return;
   }
-  else if(int64_t prev_out_size = m_prev_outbuf[0].size(); req_samples > prev_out_size)
+
+  const std::size_t frames = start_sample + req_samples;
+  const std::size_t input_channels
+      = std::min(m_audioIns, m_audio_inlet ? m_audio_inlet->channels() : 0);
+  for(std::size_t i = 0; i < m_audioIns; i++)
   {
-    int64_t additional_samples = std::max(int64_t(bs), req_samples - prev_out_size);
-    while(additional_samples > 0)
+    if(i < input_channels)
     {
-      std::size_t offset = m_prev_outbuf[0].size();
-      // Copy audio inputs
-      if(m_audioIns > 0)
-      {
-        for(std::size_t i = 0U; i < input_channels; i++)
-        {
-          auto& channel = m_audio_inlet->channel(i);
-          int64_t available_input_samples = channel.size();
-          available_input_samples -= offset;
-
-          if(available_input_samples > 0)
-          {
-            int64_t samples_to_copy = std::min(int64_t(bs), additional_samples);
-            if(samples_to_copy < available_input_samples)
-            {
-              SCORE_ASSERT(offset + samples_to_copy <= channel.size());
-              SCORE_ASSERT(i * bs + samples_to_copy <= m_inbuf.size());
-              std::copy_n(
-                  channel.begin() + offset, samples_to_copy, m_inbuf.begin() + i * bs);
-            }
-            else
-            {
-              SCORE_ASSERT(offset + available_input_samples <= channel.size());
-              SCORE_ASSERT(i * bs + available_input_samples <= m_inbuf.size());
-              std::copy_n(
-                  channel.begin() + offset, available_input_samples,
-                  m_inbuf.begin() + i * bs);
-              std::fill_n(
-                  m_inbuf.begin() + i * bs + available_input_samples,
-                  bs - available_input_samples, 0.f);
-            }
-          }
-          else
-          {
-            std::fill_n(m_inbuf.begin() + i * bs, bs, 0.f);
-          }
-        }
-      }
-
-      // Process
-      libpd_process_raw(m_inbuf.data(), m_outbuf.data());
-
-      // Put the outputs back in the ring buffer
-      for(std::size_t i = 0; i < m_audioOuts; ++i)
-      {
-        for(std::size_t j = 0; j < bs; j++)
-        {
-          m_prev_outbuf[i].push_back(m_outbuf[i * bs + j]);
-        }
-      }
-      additional_samples -= bs;
+      auto& channel = m_audio_inlet->channel(i);
+      if(channel.size() < frames)
+        channel.resize(frames);
+      m_inptrs[i] = channel.data() + start_sample;
+    }
+    else
+    {
+      m_inptrs[i] = nullptr;
     }
   }
 
   if(m_audioOuts > 0)
   {
-    // Copy audio outputs. Message inputs are copied in callbacks.
-    // Note: due to Pd processing samples 64 by 64 this is not sample-accurate.
-    // i.e. we always start copying from the beginning of the latest buffer
-    // computed by pd. The solution is to store the last N samples computed and
-    // read them if necessary, but then this causes problems if messages &
-    // parameters changed in between.
-
+    // Message outputs are copied in callbacks.
     m_audio_outlet->set_channels(m_audioOuts);
-
-    if(req_samples > 0)
+    for(std::size_t i = 0; i < m_audioOuts; i++)
     {
-      for(std::size_t i = 0U; i < m_audioOuts; ++i)
-      {
-        auto& channel = m_audio_outlet->channel(i);
-        auto& circbuf = m_prev_outbuf[i];
-        const auto silence_samples = std::max(
-            uint64_t(channel.size()), uint64_t(t.physical_start(e.modelToSamples())));
-        const auto total_samples = silence_samples + req_samples;
-        channel.reserve(total_samples);
-        channel.resize(silence_samples);
-
-        channel.insert(channel.end(), circbuf.begin(), circbuf.begin() + req_samples);
-        circbuf.erase_begin(req_samples);
-      }
+      auto& channel = m_audio_outlet->channel(i);
+      if(channel.size() < frames)
+        channel.resize(frames);
+      m_outptrs[i] = channel.data() + start_sample;
     }
   }
 
+  m_blocks.process(
+      m_inptrs.data(), m_outptrs.data(), start_sample, req_samples,
+      [](const float* in, float* out) { libpd_process_raw(in, out); });
+
   // Teardown
   m_currentInstance = nullptr;
 }
@@ -558,7 +502,8 @@ Component::Component(
       out_mess.push_back(e.name().toStdString());
   }
 
-  auto pdnode = ossia::make_node<PdGraphNode>(
+  // The node can hold the last reference to the libpd instance
+  auto pdnode = Execution::make_gui_thread_node<PdGraphNode>(
       *ctx.execState, element.m_instance, f.canonicalPath().toStdString(),
       f.fileName().toStdString(), ctx, element.audioInputs(), element.audioOutputs(),
       model_inlets, model_outlets, element.patchSpec(), element.midiInput(),
@@ -591,4 +536,12 @@ Component::Component(
 
 Component::~Component() { }
 
+std::size_t Component::latency() const noexcept
+{
+  // Set once when the node is created
+  if(auto pdnode = static_cast<PdGraphNode*>(node.get()))
+    return pdnode->m_blocks.latency();
+  return 0;
+}
+
 }
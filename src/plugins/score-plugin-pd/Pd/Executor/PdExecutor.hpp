@@ -1,4 +1,5 @@
 #pragma once
+#include <Process/Execution/BlockAdapter.hpp>
 #include <Process/Execution/ProcessComponent.hpp>
 #include <Process/ExecutionContext.hpp>
 
@@ -15,8 +16,6 @@
 #include <ossia/editor/scenario/time_process.hpp>
 #include <ossia/editor/scenario/time_value.hpp>
 
-#include <boost/circular_buffer.hpp>
-
 #include <QString>
 
 #include <memory>
@@ -54,8 +53,9 @@ public:
   std::vector<Process::Port*> m_inport, m_outport;
   std::vector<std::string> m_inmess, m_outmess;
 
-  std::vector<float> m_inbuf, m_outbuf;
-  std::vector<boost::circular_buffer<float>> m_prev_outbuf;
+  Execution::BlockAdapter<float> m_blocks;
+  std::vector<const double*> m_inptrs;
+  std::vector<double*> m_outptrs;
   std::size_t m_firstInMessage{}, m_firstOutMessage{};
   ossia::audio_port* m_audio_inlet{};
   ossia::audio_port* m_audio_outlet{};
@@ -73,6 +73,8 @@ public:
   Component(Pd::ProcessModel& element, const Execution::Context& ctx, QObject* parent);
 
   ~Component();
+
+  std::size_t latency() const noexcept override;
 };
 
 using ComponentFactory = Execution::ProcessComponentFactory_T<Pd::Component>;
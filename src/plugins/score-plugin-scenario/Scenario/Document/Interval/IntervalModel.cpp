@@ -1104,4 +1104,12 @@ TimeVal timeDelta(const IntervalModel* self, const IntervalModel* parent)
   return TimeVal{};
 }
 
+TimeVal absoluteDate(const IntervalModel* self) noexcept
+{
+  TimeVal date = TimeVal::zero();
+  for(auto itv = self; itv; itv = closestParentInterval(itv->parent()))
+    date += itv->date();
+  return date;
+}
+
 }
@@ -334,6 +334,10 @@ ParentTimeInfo closestParentWithQuantification(const IntervalModel* self);
 
 SCORE_PLUGIN_SCENARIO_EXPORT
 TimeVal timeDelta(const IntervalModel* child, const IntervalModel* parent);
+
+//! Date of the interval relative to the start of the root interval
+SCORE_PLUGIN_SCENARIO_EXPORT
+TimeVal absoluteDate(const IntervalModel* self) noexcept;
 }
 
 DEFAULT_MODEL_METADATA(Scenario::IntervalModel, "Interval")
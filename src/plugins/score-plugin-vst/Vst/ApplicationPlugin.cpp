@@ -236,21 +236,7 @@ void ApplicationPlugin::rescanVSTs(QStringList paths)
       continue;
 
     auto proc = std::make_unique<QProcess>();
-
-#if defined(__APPLE__)
-    {
-      QString bundle_vstpuppet
-          = qApp->applicationDirPath()
-            + "/ossia-score-vstpuppet.app/Contents/MacOS/"
-              "ossia-score-vstpuppet";
-      if(QFile::exists(bundle_vstpuppet))
-        proc->setProgram(bundle_vstpuppet);
-      else
-        proc->setProgram(qApp->applicationDirPath() + "/ossia-score-vstpuppet");
-    }
-#else
-    proc->setProgram(qApp->applicationDirPath() + "/ossia-score-vstpuppet");
-#endif
+    proc->setProgram(puppetPath());
     proc->setArguments({path, QString::number(i)});
     m_processes.push_back({path, std::move(proc), false, {}});
     i++;
@@ -259,6 +245,18 @@ void ApplicationPlugin::rescanVSTs(QStringList paths)
 #endif
 }
 
+QString ApplicationPlugin::puppetPath()
+{
+#if defined(__APPLE__)
+  QString bundle_vstpuppet = qApp->applicationDirPath()
+                             + "/ossia-score-vstpuppet.app/Contents/MacOS/"
+                               "ossia-score-vstpuppet";
+  if(QFile::exists(bundle_vstpuppet))
+    return bundle_vstpuppet;
+#endif
+  return qApp->applicationDirPath() + "/ossia-score-vstpuppet";
+}
+
 void ApplicationPlugin::processIncomingMessage(const QString& txt)
 {
 #if QT_CONFIG(process)
@@ -39,6 +39,9 @@ public:
   ~ApplicationPlugin() override;
 
   void rescanVSTs(QStringList);
+
+  //! Path of ossia-score-vstpuppet, used to scan and to sandbox the plug-ins
+  static QString puppetPath();
   void processIncomingMessage(const QString& txt);
   void addInvalidVST(const QString& path);
   void addVST(const QString& path, const QJsonObject& json);
@@ -4,8 +4,11 @@
 #include <Process/ExecutionSetup.hpp>
 #include <Process/ExecutionTransaction.hpp>
 
+#include <Media/Effect/Settings/Model.hpp>
+
 #include <Vst/Control.hpp>
 #include <Vst/Node.hpp>
+#include <Vst/SandboxNode.hpp>
 
 #include <ossia/dataflow/execution_state.hpp>
 #include <ossia/dataflow/fx_node.hpp>
@@ -14,6 +17,8 @@
 #include <ossia/detail/logger.hpp>
 #include <ossia/network/domain/domain.hpp>
 
+#include <QDebug>
+
 #include <wobjectimpl.h>
 W_OBJECT_IMPL(vst::Executor)
 namespace vst
@@ -99,6 +104,12 @@ Executor::Executor(vst::Model& proc, const Execution::Context& ctx, QObject* par
 
   AEffect& fx = *proc.fx->fx;
 
+  if(setupSandbox(proc, ctx))
+  {
+    m_ossia_process = std::make_shared<ossia::node_process>(node);
+    return;
+  }
+
   if(fx.flags & effFlagsCanDoubleReplacing)
   {
     if(fx.flags & effFlagsIsSynth)
@@ -137,4 +148,42 @@ Executor::Executor(vst::Model& proc, const Execution::Context& ctx, QObject* par
   m_ossia_process = std::make_shared<ossia::node_process>(node);
 }
 
+Executor::~Executor() = default;
+
+std::size_t Executor::latency() const noexcept
+{
+  // The sandboxed node plays the output of the puppet one buffer late
+  return m_sandbox ? m_sandbox->latency() : 0;
+}
+
+bool Executor::setupSandbox(vst::Model& proc, const Execution::Context& ctx)
+{
+  if(!ctx.doc.app.settings<Media::Settings::Model>().getVstSandbox())
+    return false;
+
+  m_sandbox = SandboxProcess::start(
+      proc, ctx.execState->sampleRate, ctx.execState->bufferSize);
+  if(!m_sandbox)
+  {
+    qWarning() << "Cannot sandbox" << proc.prettyName() << "- processing it in score";
+    return false;
+  }
+
+  if(proc.fx->fx->flags & effFlagsIsSynth)
+  {
+    auto n = ossia::make_node<vst_sandbox_node<true>>(
+        *ctx.execState, proc.fx, m_sandbox->block());
+    setupNode(n);
+    node = std::move(n);
+  }
+  else
+  {
+    auto n = ossia::make_node<vst_sandbox_node<false>>(
+        *ctx.execState, proc.fx, m_sandbox->block());
+    setupNode(n);
+    node = std::move(n);
+  }
+  return true;
+}
+
 }
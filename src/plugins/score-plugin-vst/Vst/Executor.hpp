@@ -9,6 +9,7 @@
 
 namespace vst
 {
+class SandboxProcess;
 class Executor final
     : public Execution::ProcessComponent_T<vst::Model, ossia::node_process>
 {
@@ -19,10 +20,16 @@ public:
   static constexpr bool is_unique = true;
 
   Executor(vst::Model& proc, const Execution::Context& ctx, QObject* parent);
+  ~Executor();
+
+  std::size_t latency() const noexcept override;
 
 private:
   template <typename Node_T>
   void setupNode(Node_T& node);
+  bool setupSandbox(vst::Model& proc, const Execution::Context& ctx);
+
+  std::unique_ptr<SandboxProcess> m_sandbox;
 };
 using ExecutorFactory = Execution::ProcessComponentFactory_T<Executor>;
 }
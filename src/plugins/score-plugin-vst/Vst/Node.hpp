@@ -1,5 +1,6 @@
 #pragma once
 #include <Process/Dataflow/TimeSignature.hpp>
+#include <Process/Execution/GUIThreadNode.hpp>
 
 #include <Vst/EffectModel.hpp>
 
@@ -84,21 +85,27 @@ public:
     return p.get();
   }
 
-  auto& prepareOutput(int64_t offset, int64_t samples)
+  auto& prepareOutput(int64_t offset, int64_t samples, int channels = 2)
   {
     const auto bs = offset + samples;
     auto& p = *m_outlets[0]->template target<ossia::audio_port>();
-    p.set_channels(2);
+    p.set_channels(channels);
     for(auto& chan : p)
       chan.resize(bs, boost::container::default_init);
     return p.get();
   }
 
   void setupTimeInfo(const ossia::token_request& tk, ossia::exec_state_facade st)
+  {
+    setupTimeInfo(fx->info, tk, st);
+  }
+
+  static void setupTimeInfo(
+      VstTimeInfo& time_info, const ossia::token_request& tk,
+      ossia::exec_state_facade st)
   {
     static const constexpr double ppq_reference = 960.;
 
-    auto& time_info = fx->info;
     // TODO this isn't accurate when tempo becomes slower !
     // We need to track the actual number of audio buffers played through an interval
     time_info.samplePos = tk.start_date_to_physical(st.modelToSamples());
@@ -459,9 +466,10 @@ public:
   std::conditional_t<!UseDouble, std::array<ossia::float_vector, 2>, dummy_t> float_v;
 };
 
+// The plug-in is stopped in the destructor, which must not run on the GC thread
 template <bool b1, bool b2, typename... Args>
 auto make_vst_fx(Args&... args)
 {
-  return ossia::make_node<vst_node<b1, b2>>(args...);
+  return Execution::make_gui_thread_node<vst_node<b1, b2>>(args...);
 }
 }
@@ -0,0 +1,239 @@
+#include "Sandbox.hpp"
+
+#include <Vst/ApplicationPlugin.hpp>
+#include <Vst/EffectModel.hpp>
+
+#include <score/application/GUIApplicationContext.hpp>
+
+#include <ossia/detail/algorithms.hpp>
+
+#include <QDebug>
+#include <QFileInfo>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <new>
+
+#if defined(__linux__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace vst
+{
+std::shared_ptr<SandboxBlock> SandboxBlock::create(
+    int sampleRate, int bufferSize, int inputs, int outputs, uint32_t params,
+    uint32_t chunkCapacity)
+{
+#if defined(__linux__)
+  if(bufferSize <= 0 || bufferSize > sandbox::max_frames)
+    return {};
+  if(inputs < 0 || inputs > sandbox::max_channels || outputs < 0
+     || outputs > sandbox::max_channels)
+    return {};
+
+  static std::atomic_int count{};
+  auto name = "/ossia-score-vst-" + std::to_string(getpid()) + "-"
+              + std::to_string(count++);
+
+  int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+  if(fd < 0)
+    return {};
+
+  const auto size
+      = sandbox::shared_block::size(inputs, outputs, bufferSize, params, chunkCapacity);
+  void* ptr = MAP_FAILED;
+  if(ftruncate(fd, size) == 0)
+    ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+
+  if(ptr == MAP_FAILED)
+  {
+    shm_unlink(name.c_str());
+    return {};
+  }
+
+  std::shared_ptr<SandboxBlock> res{new SandboxBlock};
+  res->m_block = new(ptr) sandbox::shared_block;
+  res->m_size = size;
+  res->m_name = std::move(name);
+
+  auto& b = *res->m_block;
+  b.sample_rate = sampleRate;
+  b.buffer_size = bufferSize;
+  b.inputs = inputs;
+  b.outputs = outputs;
+  b.state_params = params;
+  b.chunk_capacity = chunkCapacity;
+  return res;
+#else
+  return {};
+#endif
+}
+
+SandboxBlock::~SandboxBlock()
+{
+#if defined(__linux__)
+  munmap(m_block, m_size);
+  shm_unlink(m_name.c_str());
+#endif
+}
+
+#if QT_CONFIG(process)
+//! Consecutive crashes after which the puppet is not restarted anymore
+static constexpr int max_restarts = 5;
+
+//! A puppet which ran for this long is considered as working again
+static constexpr qint64 stable_uptime = 30000;
+
+static intptr_t currentChunk(const AEffectWrapper& fx, void*& chunk)
+{
+  intptr_t size{};
+  if(fx.fx->flags & effFlagsProgramChunks)
+    size = fx.dispatch(effGetChunk, 0, 0, &chunk, 0.f);
+  return chunk && size > 0 ? size : 0;
+}
+#endif
+
+std::unique_ptr<SandboxProcess>
+SandboxProcess::start(const vst::Model& proc, int sampleRate, int bufferSize)
+{
+#if defined(__linux__) && QT_CONFIG(process)
+  if(!proc.fx || !proc.fx->fx)
+    return {};
+
+  const auto& fx = *proc.fx;
+  auto& app = score::GUIAppContext().applicationPlugin<vst::ApplicationPlugin>();
+  auto info = ossia::find_if(
+      app.vst_infos, [&](const VSTInfo& i) { return i.uniqueID == fx.fx->uniqueID; });
+  if(info == app.vst_infos.end() || info->path.isEmpty())
+    return {};
+
+  // The process is started asynchronously: only a missing puppet is caught here
+  if(!QFileInfo{ApplicationPlugin::puppetPath()}.isExecutable())
+    return {};
+
+  // Leaves room for the chunk to grow before the puppet has to be restarted
+  void* chunk{};
+  const intptr_t chunkSize = currentChunk(fx, chunk);
+  auto block = SandboxBlock::create(
+      sampleRate, bufferSize, std::clamp(fx.fx->numInputs, 2, sandbox::max_channels),
+      std::clamp(fx.fx->numOutputs, 2, sandbox::max_channels),
+      std::max(0, fx.fx->numParams), 2 * chunkSize);
+  if(!block)
+    return {};
+
+  std::unique_ptr<SandboxProcess> res{new SandboxProcess};
+  res->m_fx = proc.fx;
+  res->m_block = std::move(block);
+  res->m_path = info->path;
+
+  auto p = new QProcess;
+  res->m_process = p;
+  p->setProgram(ApplicationPlugin::puppetPath());
+  // The ID selects the plug-in to instantiate when the library is a shell
+  p->setArguments(
+      {"--process", info->path, QString::fromStdString(res->m_block->name()),
+       QString::number(fx.fx->uniqueID)});
+  p->setProcessChannelMode(QProcess::ForwardedChannels);
+  QObject::connect(p, &QProcess::errorOccurred, p, [p](QProcess::ProcessError err) {
+    if(err == QProcess::FailedToStart)
+      qWarning() << "Cannot start the VST sandbox:" << p->errorString();
+  });
+  QObject::connect(
+      p, qOverload<int, QProcess::ExitStatus>(&QProcess::finished), p,
+      [self = res.get()](int, QProcess::ExitStatus st) { self->onFinished(st); });
+
+  res->m_restart.setSingleShot(true);
+  QObject::connect(
+      &res->m_restart, &QTimer::timeout, &res->m_restart,
+      [self = res.get()] { self->launch(); });
+
+  res->launch();
+  return res;
+#else
+  return {};
+#endif
+}
+
+#if QT_CONFIG(process)
+void SandboxProcess::writeState()
+{
+  auto& b = m_block->block();
+  for(uint32_t i = 0; i < b.state_params; i++)
+    b.stateParams()[i] = m_fx->getParameter(i);
+
+  void* chunk{};
+  intptr_t chunkSize = currentChunk(*m_fx, chunk);
+  if(chunkSize > intptr_t(b.chunk_capacity))
+  {
+    qWarning() << "VST chunk too large for the sandbox, only the parameters are "
+                  "restored:"
+               << m_path;
+    chunkSize = 0;
+  }
+  b.state_chunk = chunkSize;
+  if(chunkSize > 0)
+    std::memcpy(b.stateChunk(), chunk, chunkSize);
+}
+
+void SandboxProcess::launch()
+{
+  writeState();
+  m_uptime.start();
+  m_process->start();
+}
+
+void SandboxProcess::onFinished(QProcess::ExitStatus st)
+{
+  if(st != QProcess::CrashExit)
+    return;
+
+  // The node plays silence until the new puppet is ready
+  m_block->block().ready.store(0, std::memory_order_release);
+
+  if(m_uptime.elapsed() > stable_uptime)
+    m_restarts = 0;
+  if(m_restarts == max_restarts)
+  {
+    qWarning() << "Sandboxed VST crashed, not restarting it anymore:" << m_path;
+    return;
+  }
+
+  qWarning() << "Sandboxed VST crashed, restarting it:" << m_path;
+  m_restart.start(1000 * ++m_restarts);
+}
+#endif
+
+SandboxProcess::~SandboxProcess()
+{
+#if QT_CONFIG(process)
+  m_restart.stop();
+  if(!m_process)
+    return;
+
+  auto p = m_process;
+  p->disconnect();
+  if(p->state() == QProcess::NotRunning)
+  {
+    delete p;
+    return;
+  }
+
+  // The puppet closes the plug-in and exits by itself: it is not waited for,
+  // and is only killed if it is still running after a while.
+#if defined(__linux__)
+  auto& b = m_block->block();
+  b.quit.store(1, std::memory_order_release);
+  sandbox::futex_wake(b.request);
+#endif
+
+  QObject::connect(
+      p, qOverload<int, QProcess::ExitStatus>(&QProcess::finished), p,
+      &QObject::deleteLater);
+  QTimer::singleShot(1000, p, [p] { p->kill(); });
+#endif
+}
+}
@@ -0,0 +1,82 @@
+#pragma once
+#include <Vst/SandboxProtocol.hpp>
+
+#include <QElapsedTimer>
+#include <QString>
+#include <QTimer>
+#if QT_CONFIG(process)
+#include <QProcess>
+#endif
+
+#include <memory>
+#include <string>
+
+namespace vst
+{
+class Model;
+struct AEffectWrapper;
+
+//! Shared memory block through which a sandboxed plug-in is processed
+class SandboxBlock
+{
+public:
+  //! Returns nullptr if the block could not be created
+  static std::shared_ptr<SandboxBlock> create(
+      int sampleRate, int bufferSize, int inputs, int outputs, uint32_t params,
+      uint32_t chunkCapacity);
+  ~SandboxBlock();
+
+  sandbox::shared_block& block() const noexcept { return *m_block; }
+  const std::string& name() const noexcept { return m_name; }
+
+private:
+  SandboxBlock() = default;
+  sandbox::shared_block* m_block{};
+  std::size_t m_size{};
+  std::string m_name;
+};
+
+/**
+ * @brief A VST running in an ossia-score-vstpuppet process.
+ *
+ * A crash while processing only stops this process, which is then restarted
+ * with the current state of the plug-in: meanwhile the node outputs silence.
+ * The puppet is started and stopped without waiting for it.
+ *
+ * The instance loaded in score is still used for the editor and the
+ * parameters shown in score, and its state is copied to the puppet when it
+ * starts: a plug-in which crashes when it is loaded or in its editor still
+ * brings score down.
+ */
+class SandboxProcess
+{
+public:
+  //! Returns nullptr if the plug-in cannot be sandboxed
+  static std::unique_ptr<SandboxProcess>
+  start(const vst::Model& proc, int sampleRate, int bufferSize);
+  ~SandboxProcess();
+
+  const std::shared_ptr<SandboxBlock>& block() const noexcept { return m_block; }
+
+  //! Delay added by the sandbox, in samples
+  std::size_t latency() const noexcept { return m_block->block().buffer_size; }
+
+private:
+  SandboxProcess() = default;
+
+  std::shared_ptr<AEffectWrapper> m_fx;
+  std::shared_ptr<SandboxBlock> m_block;
+  QString m_path;
+#if QT_CONFIG(process)
+  void writeState();
+  void launch();
+  void onFinished(QProcess::ExitStatus st);
+
+  // Not owned when the process is stopping, see ~SandboxProcess
+  QProcess* m_process{};
+  QTimer m_restart;
+  QElapsedTimer m_uptime;
+  int m_restarts{};
+#endif
+};
+}
@@ -0,0 +1,282 @@
+#pragma once
+#include <Vst/Node.hpp>
+#include <Vst/Sandbox.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <vector>
+
+namespace vst
+{
+namespace sandbox
+{
+/**
+ * @brief Plays the output of the puppet one buffer late.
+ *
+ * It starts with a buffer of silence: as the output of a tick is only queued
+ * on the next one, the delay stays of exactly one buffer even when the ticks
+ * are shorter than a buffer.
+ */
+class delay_line
+{
+public:
+  delay_line(int channels, int64_t bufferSize)
+      : m_channels(channels, std::vector<double>(bufferSize))
+      , m_bufferSize{bufferSize}
+      , m_queued{bufferSize}
+  {
+  }
+
+  int64_t latency() const noexcept { return m_bufferSize; }
+
+  //! Queues n frames of channel(c) for each channel c, or silence if it is null
+  template <typename F>
+  void push(int64_t n, F&& channel) noexcept
+  {
+    n = std::min(n, m_bufferSize - m_queued);
+    if(n <= 0)
+      return;
+
+    for(std::size_t c = 0; c < m_channels.size(); c++)
+    {
+      auto dst = m_channels[c].data() + m_queued;
+      if(const float* src = channel(c))
+        std::copy_n(src, n, dst);
+      else
+        std::fill_n(dst, n, 0.);
+    }
+    m_queued += n;
+  }
+
+  //! Writes the n oldest frames to out, starting at offset
+  template <typename Out>
+  void pop(Out& out, int64_t offset, int64_t n) noexcept
+  {
+    const int64_t available = std::min(n, m_queued);
+    for(std::size_t c = 0; c < m_channels.size() && c < std::size(out); c++)
+    {
+      auto& chan = m_channels[c];
+      auto dst = out[c].data() + offset;
+      std::copy_n(chan.data(), available, dst);
+      std::fill_n(dst + available, n - available, 0.);
+      std::copy(chan.data() + available, chan.data() + m_queued, chan.data());
+    }
+    m_queued -= available;
+  }
+
+private:
+  std::vector<std::vector<double>> m_channels;
+  int64_t m_bufferSize{};
+  int64_t m_queued{};
+};
+}
+
+/**
+ * @brief Node of a VST processed in an ossia-score-vstpuppet process.
+ *
+ * The sandbox runs one buffer behind: each tick collects the output of the
+ * buffer sent on the previous tick, then sends the current one, so that the
+ * puppet is never waited for. The output is thus delayed by one buffer, which
+ * the executor reports as the latency of the process.
+ * When the puppet is late, is still starting or has crashed, silence is
+ * played in place of its output and no new buffer is sent until it catches up.
+ * The note-offs received meanwhile are sent with the next buffer.
+ */
+template <bool IsSynth>
+class vst_sandbox_node final : public vst_node_base
+{
+public:
+  static constexpr bool synth = IsSynth;
+
+  vst_sandbox_node(
+      std::shared_ptr<AEffectWrapper> dat, std::shared_ptr<SandboxBlock> block)
+      : vst_node_base{std::move(dat)}
+      , m_block{std::move(block)}
+      , m_shm{m_block->block()}
+      , m_delay{m_shm.outputs, m_shm.buffer_size}
+      , m_sentValues(fx->fx->numParams, NAN)
+  {
+    m_inlets.push_back(new ossia::audio_inlet);
+    if constexpr(IsSynth)
+      m_inlets.push_back(new ossia::midi_inlet);
+
+    m_outlets.push_back(new ossia::audio_outlet);
+    if constexpr(IsSynth)
+      m_pendingNotesOff.reserve(max_pending_notes_off);
+  }
+
+  std::string label() const noexcept override { return ""; }
+
+  void all_notes_off() noexcept override
+  {
+    if constexpr(IsSynth)
+      m_notesOff = true;
+  }
+
+  void run(const ossia::token_request& tk, ossia::exec_state_facade st) noexcept override
+  {
+    if(muted() || tk.date <= tk.prev_date)
+      return;
+
+    const auto timings = st.timings(tk);
+    const int64_t offset = timings.start_sample;
+    const int64_t samples = timings.length;
+
+    auto& b = m_shm;
+    auto& ip = prepareInput(offset, samples);
+    auto& op = prepareOutput(offset, samples, b.outputs);
+
+    // The values are kept until the puppet is able to receive them
+    updateControls();
+
+    if(samples <= 0 || samples > b.buffer_size)
+    {
+      for(auto& chan : op)
+        std::fill_n(chan.data() + offset, std::max(samples, int64_t(0)), 0.);
+      return;
+    }
+
+    // Output of the previous buffer, if the puppet processed it in time
+    const bool idle = b.done.load(std::memory_order_acquire) == m_request;
+    const bool processed = idle && m_sent;
+    m_delay.push(m_pending, [&](std::size_t c) -> const float* {
+      return processed ? b.output(c) : nullptr;
+    });
+
+    m_pending = samples;
+    m_sent = idle && b.ready.load(std::memory_order_acquire);
+    if(m_sent)
+    {
+      b.frames = samples;
+      setupTimeInfo(b.time, tk, st);
+      writeControls();
+      writeMidi(offset);
+      for(int c = 0; c < b.inputs; c++)
+      {
+        if(c < std::ssize(ip))
+          std::copy_n(ip[c].data() + offset, samples, b.input(c));
+        else
+          std::fill_n(b.input(c), samples, 0.f);
+      }
+
+      b.request.store(++m_request, std::memory_order_release);
+      sandbox::futex_wake(b.request);
+    }
+    else
+    {
+      deferNotesOff();
+    }
+
+    m_delay.pop(op, offset, samples);
+  }
+
+private:
+  void updateControls()
+  {
+    for(vst_control& p : controls)
+    {
+      const auto& vec = p.port->get_data();
+      if(!vec.empty())
+        p.value = ossia::clamp<float>(ossia::convert<float>(last(vec)), 0.f, 1.f);
+    }
+  }
+
+  void writeControls()
+  {
+    int n = 0;
+    for(vst_control& p : controls)
+    {
+      if(n == sandbox::max_params)
+        break;
+      if(p.idx < 0 || p.idx >= std::ssize(m_sentValues))
+        continue;
+
+      auto& sent = m_sentValues[p.idx];
+      if(sent != p.value)
+      {
+        sent = p.value;
+        m_shm.params[n++] = {p.idx, p.value};
+      }
+    }
+    m_shm.num_params = n;
+  }
+
+  static bool isNoteOff(const libremidi::message& mess) noexcept
+  {
+    if(mess.bytes.size() < 3)
+      return false;
+    const uint8_t status = mess.bytes[0] & 0xF0;
+    return status == 0x80 || (status == 0x90 && mess.bytes[2] == 0);
+  }
+
+  // Room is left for the "all notes off" messages of all_notes_off()
+  static constexpr std::size_t max_pending_notes_off = sandbox::max_midi - 32;
+
+  //! Keeps the note-offs of a buffer which cannot be sent, so that no note hangs
+  void deferNotesOff()
+  {
+    if constexpr(IsSynth)
+    {
+      auto& ip = static_cast<ossia::midi_inlet*>(m_inlets[1])->data.messages;
+      for(const libremidi::message& mess : ip)
+      {
+        if(m_pendingNotesOff.size() == max_pending_notes_off)
+          break;
+        if(isNoteOff(mess))
+          m_pendingNotesOff.push_back({mess.bytes[0], mess.bytes[1], mess.bytes[2]});
+      }
+    }
+  }
+
+  void writeMidi(int64_t offset)
+  {
+    m_shm.clearMidi();
+    if constexpr(IsSynth)
+    {
+      for(const auto& bytes : m_pendingNotesOff)
+        m_shm.pushMidi(0, bytes.data(), bytes.size());
+      m_pendingNotesOff.clear();
+
+      if(m_notesOff)
+      {
+        // All notes off, then all sound off
+        for(uint8_t cc : {uint8_t(123), uint8_t(121)})
+        {
+          for(uint8_t chan = 0; chan < 16; chan++)
+          {
+            const uint8_t bytes[3]{uint8_t(176 + chan), cc, 0};
+            m_shm.pushMidi(0, bytes, 3);
+          }
+        }
+        m_notesOff = false;
+      }
+
+      // Sysex messages are sent whole
+      auto& ip = static_cast<ossia::midi_inlet*>(m_inlets[1])->data.messages;
+      for(const libremidi::message& mess : ip)
+      {
+        if(!m_shm.pushMidi(
+               mess.timestamp - offset, mess.bytes.data(), mess.bytes.size()))
+          break;
+      }
+    }
+  }
+
+  std::shared_ptr<SandboxBlock> m_block;
+  sandbox::shared_block& m_shm;
+  sandbox::delay_line m_delay;
+
+  //! Last value sent to the puppet for each parameter
+  std::vector<float> m_sentValues;
+  uint32_t m_request{};
+
+  //! Length of the previous tick, and whether it was sent to the puppet
+  int64_t m_pending{};
+  bool m_sent{};
+
+  std::vector<std::array<uint8_t, 3>> m_pendingNotesOff;
+  bool m_notesOff{};
+};
+
+}
@@ -0,0 +1,176 @@
+#pragma once
+#include <Vst/vst-compat.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+/**
+ * Shared memory layout used to process a VST in the ossia-score-vstpuppet
+ * process, when the plug-ins are sandboxed.
+ *
+ * The host creates the block, writes the sample rate, the buffer size, the
+ * channel counts and the state of the plug-in, then starts the puppet with the
+ * name of the block. The puppet loads the plug-in, applies the state and sets
+ * "ready". When the puppet crashes, the host resets "ready", rewrites the state
+ * and starts a new one on the same block.
+ *
+ * For each audio buffer, the host writes the inputs, the parameter changes and
+ * the MIDI events, then increments "request". The puppet processes the buffer,
+ * writes the outputs and sets "done" to the value of "request".
+ * The host never waits for "done": it collects the outputs on the next buffer.
+ *
+ * The variable-sized data follows the block: the input channels and the output
+ * channels (buffer_size floats each), the value of the parameters
+ * (state_params floats), then the chunk (state_chunk bytes, at most
+ * chunk_capacity).
+ */
+namespace vst::sandbox
+{
+static constexpr uint32_t block_magic = 0x42535653; // SVSB
+static constexpr uint32_t block_version = 2;
+
+static constexpr int max_frames = 4096;
+static constexpr int max_channels = 64;
+static constexpr int max_params = 256;
+static constexpr int max_midi = 256;
+
+//! Room for the bytes of the MIDI events of a buffer, sysex included
+static constexpr uint32_t max_midi_bytes = 65536;
+
+struct param_change
+{
+  int32_t index{};
+  float value{};
+};
+
+//! The bytes of the event are at midi_bytes + offset
+struct midi_event
+{
+  int32_t frame{};
+  uint32_t offset{};
+  uint32_t size{};
+};
+
+struct shared_block
+{
+  uint32_t magic{block_magic};
+  uint32_t version{block_version};
+
+  // Written by the host before starting the puppet
+  int32_t sample_rate{};
+  int32_t buffer_size{};
+  int32_t inputs{};
+  int32_t outputs{};
+  uint32_t state_params{};
+  uint32_t state_chunk{};
+  uint32_t chunk_capacity{};
+
+  std::atomic<uint32_t> ready{};
+  std::atomic<uint32_t> quit{};
+  std::atomic<uint32_t> request{};
+  std::atomic<uint32_t> done{};
+
+  // Written by the host before incrementing "request"
+  int32_t frames{};
+  int32_t num_params{};
+  int32_t num_midi{};
+  uint32_t midi_size{};
+  VstTimeInfo time{};
+  param_change params[max_params];
+  midi_event midi[max_midi];
+  uint8_t midi_bytes[max_midi_bytes];
+
+  float* input(int channel) noexcept { return audio() + channel * buffer_size; }
+  float* output(int channel) noexcept
+  {
+    return audio() + (inputs + channel) * buffer_size;
+  }
+
+  float* stateParams() noexcept { return audio() + (inputs + outputs) * buffer_size; }
+  char* stateChunk() noexcept
+  {
+    return reinterpret_cast<char*>(stateParams() + state_params);
+  }
+
+  static std::size_t size(
+      int32_t inputs, int32_t outputs, int32_t buffer_size, uint32_t params,
+      uint32_t chunk_capacity) noexcept
+  {
+    return sizeof(shared_block)
+           + (std::size_t(inputs) + outputs) * buffer_size * sizeof(float)
+           + params * sizeof(float) + chunk_capacity;
+  }
+
+  //! Adds a MIDI message to the request, false when there is no room left
+  bool pushMidi(int32_t frame, const uint8_t* bytes, std::size_t size) noexcept
+  {
+    if(num_midi >= max_midi || size > max_midi_bytes - midi_size)
+      return false;
+
+    midi[num_midi++] = {frame, midi_size, uint32_t(size)};
+    std::memcpy(midi_bytes + midi_size, bytes, size);
+    midi_size += size;
+    return true;
+  }
+
+  void clearMidi() noexcept
+  {
+    num_midi = 0;
+    midi_size = 0;
+  }
+
+  //! Calls f(frame, bytes, size) for each valid MIDI event of the request
+  template <typename F>
+  void forEachMidi(F&& f) noexcept
+  {
+    const int n = num_midi < 0 ? 0 : num_midi > max_midi ? max_midi : num_midi;
+    for(int i = 0; i < n; i++)
+    {
+      const auto& e = midi[i];
+      if(e.size > 0 && e.offset < max_midi_bytes && e.size <= max_midi_bytes - e.offset)
+        f(e.frame, midi_bytes + e.offset, e.size);
+    }
+  }
+
+private:
+  float* audio() noexcept { return reinterpret_cast<float*>(this + 1); }
+};
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free);
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t));
+
+#if defined(__linux__)
+// The block is shared between processes, thus the futexes cannot be private
+inline void futex_wake(std::atomic<uint32_t>& word) noexcept
+{
+  syscall(
+      SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAKE, 1, nullptr, nullptr, 0);
+}
+
+//! Sleeps while word == expected, at most for timeout_ns
+inline void futex_wait(
+    std::atomic<uint32_t>& word, uint32_t expected, int64_t timeout_ns) noexcept
+{
+  timespec ts{time_t(timeout_ns / 1000000000), long(timeout_ns % 1000000000)};
+  syscall(
+      SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAIT, expected, &ts, nullptr,
+      0);
+}
+#else
+// The sandbox is not started on the other platforms
+inline void futex_wake(std::atomic<uint32_t>&) noexcept { }
+inline void futex_wait(std::atomic<uint32_t>&, uint32_t, int64_t) noexcept
+{
+  std::this_thread::yield();
+}
+#endif
+}
@@ -2,6 +2,7 @@
 
 #include <ossia/detail/math.hpp>
 
+#include <QCheckBox>
 #include <QFileDialog>
 #include <QFormLayout>
 #include <QGridLayout>
@@ -34,6 +35,12 @@ void SettingsWidget::setVstPaths(QStringList val)
   }
 }
 
+void SettingsWidget::setVstSandbox(bool val)
+{
+  if(m_VstSandbox->isChecked() != val)
+    m_VstSandbox->setChecked(val);
+}
+
 QString SettingsWidget::name() const noexcept
 {
   return "VST";
@@ -100,6 +107,18 @@ QWidget* SettingsWidget::make(const score::ApplicationContext& ctx)
   vstPathWidgetLayout->addRow(tr("VST paths"), m_VstPaths);
   vstPathWidgetLayout->addRow(button_lay);
 
+  m_VstSandbox = new QCheckBox{tr("Run the plug-ins in a separate process")};
+  m_VstSandbox->setToolTip(
+      tr("A plug-in crashing while processing audio is then restarted instead of "
+         "stopping score.\n"
+         "Adds one buffer of latency. Applies to the plug-ins started afterwards."));
+#if !defined(__linux__)
+  // The sandbox is only implemented on Linux
+  m_VstSandbox->setEnabled(false);
+#endif
+  vstPathWidgetLayout->addRow(m_VstSandbox);
+  connect(m_VstSandbox, &QCheckBox::toggled, this, &SettingsWidget::VstSandboxChanged);
+
   splitter->addWidget(vstPathWidget);
   splitter->setStretchFactor(0, 1);
   splitter->setCollapsible(0, false);
@@ -165,6 +184,7 @@ QWidget* SettingsWidget::make(const score::ApplicationContext& ctx)
   splitter->setCollapsible(1, false);
 
   SETTINGS_PRESENTER(VstPaths);
+  SETTINGS_PRESENTER(VstSandbox);
 
   return splitter;
 }
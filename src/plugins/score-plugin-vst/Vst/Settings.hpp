@@ -7,6 +7,7 @@
 
 #include <verdigris>
 
+class QCheckBox;
 class QListWidget;
 
 namespace vst
@@ -23,16 +24,19 @@ public:
   explicit SettingsWidget();
 
   void setVstPaths(QStringList val);
+  void setVstSandbox(bool val);
 
   QString name() const noexcept override;
   QWidget* make(const score::ApplicationContext& ctx) override;
 
 public:
   void VstPathsChanged(QStringList arg_1) W_SIGNAL(VstPathsChanged, arg_1);
+  void VstSandboxChanged(bool arg_1) W_SIGNAL(VstSandboxChanged, arg_1);
 
 private:
   Model* m_model{};
   QListWidget* m_VstPaths{};
+  QCheckBox* m_VstSandbox{};
   QStringList m_curitems;
 
   score::SettingsCommandDispatcher m_disp;
@@ -1,5 +1,6 @@
 #pragma once
 #include <Process/Dataflow/TimeSignature.hpp>
+#include <Process/Execution/GUIThreadNode.hpp>
 
 #include <Vst3/EffectModel.hpp>
 
@@ -797,9 +798,10 @@ public:
   std::conditional_t<!UseDouble, std::vector<ossia::float_vector>, dummy_t> float_v;
 };
 
+// The plug-in is stopped in the destructor, which must not run on the GC thread
 template <bool b1, typename... Args>
 auto make_vst_fx(Args&... args)
 {
-  return ossia::make_node<vst_node<b1>>(args...);
+  return Execution::make_gui_thread_node<vst_node<b1>>(args...);
 }
 }
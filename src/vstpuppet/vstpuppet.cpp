@@ -1,4 +1,5 @@
 #include <Vst/Loader.hpp>
+#include <Vst/SandboxProtocol.hpp>
 
 #include <QFile>
 #include <QGuiApplication>
@@ -9,8 +10,26 @@
 #include <QWebSocket>
 #include <QWindow>
 
+#include <algorithm>
+#include <cstdlib>
 #include <iostream>
 #include <set>
+#include <string_view>
+#include <vector>
+
+#if defined(__linux__)
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/prctl.h>
+#include <sys/stat.h>
+#endif
+
+// Block shared with score when processing a plug-in
+static vst::sandbox::shared_block* g_block{};
+
+// Plug-in requested by score, asked for by shell plug-ins while being loaded
+static int32_t g_currentId{};
 
 intptr_t vst_host_callback(
     AEffect* effect, int32_t opcode, int32_t index, intptr_t value, void* ptr, float opt)
@@ -20,6 +39,12 @@ intptr_t vst_host_callback(
   switch(opcode)
   {
     case audioMasterGetTime: {
+      if(g_block)
+      {
+        result = reinterpret_cast<intptr_t>(&g_block->time);
+        break;
+      }
+
       static VstTimeInfo time;
       time.samplePos = 0.;
       time.sampleRate = 44100.;
@@ -47,7 +72,7 @@ intptr_t vst_host_callback(
     case audioMasterIdle:
       break;
     case audioMasterCurrentId:
-      result = effect->uniqueID;
+      result = effect ? effect->uniqueID : g_currentId;
       break;
     case audioMasterUpdateDisplay:
       break;
@@ -65,10 +90,10 @@ intptr_t vst_host_callback(
       result = kVstVersion;
       break;
     case audioMasterGetSampleRate:
-      result = 44100;
+      result = g_block ? g_block->sample_rate : 44100;
       break;
     case audioMasterGetBlockSize:
-      result = 512;
+      result = g_block ? g_block->buffer_size : 512;
       break;
     case audioMasterGetCurrentProcessLevel:
       result = kVstProcessLevelUser;
@@ -160,8 +185,201 @@ QString load_vst(const QString& path, int id)
   return {};
 }
 
+#if defined(__linux__)
+static void run_vst(AEffect* fx, vst::sandbox::shared_block& b)
+{
+  using namespace vst::sandbox;
+  auto dispatch = [fx](int32_t opcode, int32_t index = 0, intptr_t value = 0,
+                       void* ptr = nullptr, float opt = 0.f) {
+    return fx->dispatcher(fx, opcode, index, value, ptr, opt);
+  };
+
+  // Same setup as vst::Model::initFx and vst::vst_node, in single precision
+  dispatch(effSetSampleRate, 0, b.sample_rate, nullptr, b.sample_rate);
+  dispatch(effSetBlockSize, 0, b.buffer_size, nullptr, b.buffer_size);
+  dispatch(effOpen);
+  dispatch(effSetSampleRate, 0, b.sample_rate, nullptr, b.sample_rate);
+  dispatch(effSetBlockSize, 0, b.buffer_size, nullptr, b.buffer_size);
+
+  VstSpeakerArrangement i_arr{}, o_arr{};
+  i_arr.type = kSpeakerArrStereo;
+  i_arr.numChannels = 2;
+  i_arr.speakers[0].type = kSpeakerL;
+  i_arr.speakers[1].type = kSpeakerR;
+  o_arr = i_arr;
+  dispatch(effSetSpeakerArrangement, 0, (intptr_t)&i_arr, (void*)&o_arr, 0);
+  dispatch(effSetProcessPrecision, 0, kVstProcessPrecision32);
+
+  for(int i = 0; i < std::min(int(b.state_params), fx->numParams); i++)
+    fx->setParameter(fx, i, b.stateParams()[i]);
+  if(b.state_chunk > 0 && (fx->flags & effFlagsProgramChunks))
+    dispatch(effSetChunk, 0, b.state_chunk, b.stateChunk(), 0.f);
+
+  dispatch(effMainsChanged, 0, 1);
+  dispatch(effStartProcess);
+
+  // The channels not shared with score get silence, and their output is dropped
+  const int channels = std::max({b.inputs, b.outputs, fx->numInputs, fx->numOutputs});
+  std::vector<float> silence(b.buffer_size), dropped(b.buffer_size);
+  std::vector<float*> inputs(channels, silence.data());
+  std::vector<float*> outputs(channels, dropped.data());
+  for(int i = 0; i < b.inputs; i++)
+    inputs[i] = b.input(i);
+  for(int i = 0; i < b.outputs; i++)
+    outputs[i] = b.output(i);
+
+  // Some plug-ins read past numEvents, thus the array of pointers is larger
+  std::vector<VstMidiEvent> midi(max_midi);
+  std::vector<VstMidiSysexEvent> sysex(max_midi);
+  std::vector<char> events_buffer(sizeof(VstEvents) + sizeof(void*) * max_midi * 2);
+  auto events = reinterpret_cast<VstEvents*>(events_buffer.data());
+
+  // When restarted after a crash, the request which was being processed is
+  // dropped: score gets silence for it.
+  std::fill_n(b.output(0), std::size_t(b.outputs) * b.buffer_size, 0.f);
+  uint32_t processed = b.request.load(std::memory_order_acquire);
+  b.done.store(processed, std::memory_order_release);
+  b.ready.store(1, std::memory_order_release);
+  futex_wake(b.done);
+
+  while(!b.quit.load(std::memory_order_acquire))
+  {
+    const uint32_t request = b.request.load(std::memory_order_acquire);
+    if(request == processed)
+    {
+      futex_wait(b.request, processed, 100'000'000);
+      continue;
+    }
+
+    for(int i = 0; i < std::clamp(b.num_params, 0, max_params); i++)
+    {
+      const auto& p = b.params[i];
+      if(p.index >= 0 && p.index < fx->numParams)
+        fx->setParameter(fx, p.index, p.value);
+    }
+
+    std::fill(events_buffer.begin(), events_buffer.end(), 0);
+    int n = 0;
+    b.forEachMidi([&](int32_t frame, uint8_t* bytes, uint32_t size) {
+      VstEvent* ev{};
+      if(bytes[0] == 0xF0 || size > 4)
+      {
+        VstMidiSysexEvent& e = sysex[n];
+        std::memset(&e, 0, sizeof(VstMidiSysexEvent));
+        e.type = kVstSysExType;
+        e.byteSize = sizeof(VstMidiSysexEvent);
+        e.deltaFrames = frame;
+        e.dumpBytes = size;
+        e.sysexDump = reinterpret_cast<char*>(bytes);
+        ev = reinterpret_cast<VstEvent*>(&e);
+      }
+      else
+      {
+        VstMidiEvent& e = midi[n];
+        std::memset(&e, 0, sizeof(VstMidiEvent));
+        e.type = kVstMidiType;
+        e.byteSize = sizeof(VstMidiEvent);
+        e.deltaFrames = frame;
+        e.flags = kVstMidiEventIsRealtime;
+        std::memcpy(e.midiData, bytes, size);
+        ev = reinterpret_cast<VstEvent*>(&e);
+      }
+      events->events[n++] = ev;
+    });
+    if(n > 0)
+    {
+      events->numEvents = n;
+      dispatch(effProcessEvents, 0, 0, events, 0.f);
+    }
+
+    fx->processReplacing(
+        fx, inputs.data(), outputs.data(), std::clamp(b.frames, 0, b.buffer_size));
+
+    // Mono plug-ins are upmixed to stereo, as when processed in score
+    if(fx->numOutputs == 1 && b.outputs > 1)
+      std::copy_n(b.output(0), b.buffer_size, b.output(1));
+
+    processed = request;
+    b.done.store(processed, std::memory_order_release);
+    futex_wake(b.done);
+  }
+
+  dispatch(effStopProcess);
+  dispatch(effMainsChanged, 0, 0);
+  dispatch(effClose);
+}
+
+//! Processes a plug-in for score, through the shared block created by score
+static int process_vst(const char* path, const char* block_name, int32_t id)
+{
+  using namespace vst::sandbox;
+
+  // Do not outlive score
+  prctl(PR_SET_PDEATHSIG, SIGKILL);
+
+  int fd = shm_open(block_name, O_RDWR, 0);
+  if(fd < 0)
+  {
+    std::cerr << "Cannot open " << block_name << std::endl;
+    return 1;
+  }
+
+  struct stat st{};
+  void* ptr = MAP_FAILED;
+  if(fstat(fd, &st) == 0 && std::size_t(st.st_size) >= sizeof(shared_block))
+    ptr = mmap(nullptr, st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if(ptr == MAP_FAILED)
+    return 1;
+
+  auto& b = *static_cast<shared_block*>(ptr);
+  if(b.magic != block_magic || b.version != block_version || b.buffer_size <= 0
+     || b.buffer_size > max_frames || b.inputs < 0 || b.inputs > max_channels
+     || b.outputs < 0 || b.outputs > max_channels || b.state_chunk > b.chunk_capacity
+     || std::size_t(st.st_size) < shared_block::size(
+            b.inputs, b.outputs, b.buffer_size, b.state_params, b.chunk_capacity))
+  {
+    std::cerr << "Invalid block " << block_name << std::endl;
+    munmap(ptr, st.st_size);
+    return 1;
+  }
+
+  int ret = 1;
+  g_block = &b;
+  g_currentId = id;
+  try
+  {
+    vst::Module plugin{path};
+    if(auto m = plugin.getMain())
+    {
+      if(auto p = (AEffect*)m(vst_host_callback))
+      {
+        if(id != 0 && p->uniqueID != id)
+          std::cerr << "Unexpected plug-in " << p->uniqueID << " in " << path
+                    << std::endl;
+        run_vst(p, b);
+        ret = 0;
+      }
+    }
+  }
+  catch(const std::runtime_error& e)
+  {
+    std::cerr << e.what() << std::endl;
+  }
+  g_block = nullptr;
+
+  munmap(ptr, st.st_size);
+  return ret;
+}
+#endif
+
 int main(int argc, char** argv)
 {
+#if defined(__linux__)
+  if(argc > 3 && std::string_view(argv[1]) == "--process")
+    return process_vst(argv[2], argv[3], argc > 4 ? std::atoi(argv[4]) : 0);
+#endif
+
   if(argc > 1)
   {
     int id = 0;
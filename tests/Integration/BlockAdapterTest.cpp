@@ -0,0 +1,148 @@
+#include <Process/Execution/BlockAdapter.hpp>
+
+#include <QtTest/QTest>
+
+#include <score_integration.hpp>
+
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
+#include <wobjectimpl.h>
+
+using Execution::BlockAdapter;
+
+class BlockAdapterTest : public QObject
+{
+  W_OBJECT(BlockAdapterTest)
+
+public:
+  BlockAdapterTest(int& argc, char** argv) { }
+
+private:
+  // Offset in the host buffer and frames of each call
+  using Calls = std::vector<std::pair<std::size_t, std::size_t>>;
+
+  // Runs the DSP over a ramp, cut in the given calls
+  template <typename F>
+  static std::vector<float> run(BlockAdapter<float>& adapter, const Calls& calls, F dsp)
+  {
+    std::size_t total = 0;
+    for(auto [offset, frames] : calls)
+      total += frames;
+    std::vector<float> in(total), out(total, -1.f);
+    std::iota(in.begin(), in.end(), 1.f);
+
+    std::size_t pos = 0;
+    for(auto [offset, frames] : calls)
+    {
+      const float* ip[1]{in.data() + pos};
+      float* op[1]{out.data() + pos};
+      adapter.process(ip, op, offset, frames, dsp);
+      pos += frames;
+    }
+    return out;
+  }
+
+  static std::vector<float>
+  runIdentity(BlockAdapter<float>& adapter, const Calls& calls, int& blocks)
+  {
+    const auto bs = adapter.blockSize();
+    return run(adapter, calls, [&](const float* i, float* o) {
+      std::copy_n(i, bs, o);
+      blocks++;
+    });
+  }
+
+  void test_direct()
+  {
+    BlockAdapter<float> adapter;
+    adapter.reset(1, 1, 64, 256);
+    QCOMPARE(adapter.latency(), std::size_t(0));
+
+    int blocks = 0;
+    auto out = runIdentity(adapter, {{0, 256}, {0, 256}, {0, 128}}, blocks);
+    QCOMPARE(blocks, 10);
+    for(std::size_t i = 0; i < out.size(); i++)
+      QCOMPARE(out[i], float(i + 1));
+  }
+  W_SLOT(test_direct)
+
+  void test_direct_partial()
+  {
+    // A process starting in the middle of a buffer and stopping before its end
+    BlockAdapter<float> adapter;
+    adapter.reset(1, 1, 64, 256);
+
+    int blocks = 0;
+    auto out = runIdentity(adapter, {{156, 100}, {0, 256}, {0, 30}}, blocks);
+    QCOMPARE(blocks, 2 + 4 + 1);
+    QCOMPARE(adapter.latency(), std::size_t(0));
+    for(std::size_t i = 0; i < out.size(); i++)
+      QCOMPARE(out[i], float(i + 1));
+  }
+  W_SLOT(test_direct_partial)
+
+  void test_direct_continuity()
+  {
+    // A DSP with a state: it outputs the number of samples it has processed.
+    // The third buffer is cut in two calls, which do not end on a block.
+    BlockAdapter<float> adapter;
+    adapter.reset(1, 1, 64, 256);
+
+    int blocks = 0;
+    float count = 0.f;
+    auto out = run(
+        adapter, {{156, 100}, {0, 256}, {0, 100}, {100, 156}, {0, 64}},
+        [&](const float*, float* o) {
+      for(int i = 0; i < 64; i++)
+        o[i] = count++;
+      blocks++;
+    });
+
+    // The DSP starts on the block before the process, and never drifts
+    QCOMPARE(blocks, 2 + 4 + 2 + 2 + 1);
+    QCOMPARE(out.front(), 28.f);
+    for(std::size_t i = 0; i < out.size(); i++)
+      QCOMPARE(out[i], float(28 + i));
+    QCOMPARE(count, float(28 + out.size()));
+  }
+  W_SLOT(test_direct_continuity)
+
+  void test_delayed()
+  {
+    BlockAdapter<float> adapter;
+    adapter.reset(1, 1, 64, 100);
+    QCOMPARE(adapter.latency(), std::size_t(64));
+
+    int blocks = 0;
+    auto out = runIdentity(adapter, {{0, 100}, {0, 100}, {0, 100}, {0, 37}}, blocks);
+    QCOMPARE(blocks, 337 / 64);
+    for(std::size_t i = 0; i < out.size(); i++)
+    {
+      const float expected = i < 64 ? 0.f : float(i + 1 - 64);
+      QCOMPARE(out[i], expected);
+    }
+  }
+  W_SLOT(test_delayed)
+
+  void test_silent_input()
+  {
+    BlockAdapter<float> adapter;
+    adapter.reset(2, 2, 64, 128);
+
+    std::vector<float> in(128, 1.f), out0(128, -1.f), out1(128, -1.f);
+    const float* ip[2]{in.data(), nullptr};
+    float* op[2]{out0.data(), out1.data()};
+    adapter.process(ip, op, 0, 128, [](const float* i, float* o) {
+      std::copy_n(i, 2 * 64, o);
+    });
+
+    QVERIFY(std::all_of(out0.begin(), out0.end(), [](float f) { return f == 1.f; }));
+    QVERIFY(std::all_of(out1.begin(), out1.end(), [](float f) { return f == 0.f; }));
+  }
+  W_SLOT(test_silent_input)
+};
+
+W_OBJECT_IMPL(BlockAdapterTest)
+SCORE_INTEGRATION_TEST_OBJECT(BlockAdapterTest)
@@ -0,0 +1,119 @@
+#include <JS/Qml/QmlObjects.hpp>
+
+#include <QtTest/QTest>
+
+#include <score_integration.hpp>
+
+#include <ossia/dataflow/audio_port.hpp>
+
+#include <QJSEngine>
+
+#include <cmath>
+
+#include <wobjectimpl.h>
+
+class JSArrayTest : public QObject
+{
+  W_OBJECT(JSArrayTest)
+
+public:
+  JSArrayTest(int& argc, char** argv) { }
+
+private:
+  void test_audio_inlet()
+  {
+    QJSEngine engine;
+    QObject root;
+    auto inlet = new JS::AudioInlet{&root};
+    engine.globalObject().setProperty("inlet", engine.newQObject(inlet));
+
+    ossia::audio_vector audio(2);
+    audio[0] = {1., 2., 3., 4.};
+    audio[1] = {-1., -2.};
+    inlet->setSource(&audio);
+
+    auto res = engine.evaluate(R"_(
+      var b = inlet.buffer(0);
+      var c = inlet.buffer(1);
+      [b.length, b[0] + b[1] + b[2] + b[3], c.length, c[1], inlet.buffer(2).length]
+    )_");
+    QVERIFY(!res.isError());
+    QCOMPARE(res.property(0).toInt(), 4);
+    QCOMPARE(res.property(1).toNumber(), 10.);
+    QCOMPARE(res.property(2).toInt(), 2);
+    QCOMPARE(res.property(3).toNumber(), -2.);
+    QCOMPARE(res.property(4).toInt(), 0);
+
+    // The next tick sees the new samples of the port
+    audio[0][0] = 10.;
+    res = engine.evaluate("inlet.buffer(0)[0]");
+    QCOMPARE(res.toNumber(), 10.);
+  }
+  W_SLOT(test_audio_inlet)
+
+  void test_audio_outlet()
+  {
+    QJSEngine engine;
+    QObject root;
+    auto outlet = new JS::AudioOutlet{&root};
+    engine.globalObject().setProperty("outlet", engine.newQObject(outlet));
+
+    outlet->setFrames(4);
+    auto res = engine.evaluate(R"_(
+      var o = outlet.buffer(0);
+      for(var i = 0; i < o.length; i++)
+        o[i] = i * 0.5;
+      o[2] = NaN;
+      o.length
+    )_");
+    QVERIFY(!res.isError());
+    QCOMPARE(res.toInt(), 4);
+
+    // Written at the offset of the tick, without shrinking the channel
+    ossia::audio_vector out(1);
+    out[0].assign(8, 7.);
+    outlet->writeBuffers(out, 2);
+    QCOMPARE(out[0].size(), std::size_t(8));
+    const double expected[8]{7., 7., 0., 0.5, 0., 1.5, 7., 7.};
+    for(int i = 0; i < 8; i++)
+      QCOMPARE(out[0][i], expected[i]);
+
+    // Channels which were not asked for in the tick are left untouched
+    out[0].assign(8, 7.);
+    outlet->writeBuffers(out, 0);
+    QCOMPARE(out[0][0], 7.);
+
+    // The buffer is cleared for each tick
+    res = engine.evaluate("outlet.buffer(0)[1]");
+    QCOMPARE(res.toNumber(), 0.);
+  }
+  W_SLOT(test_audio_outlet)
+
+  void test_value_outlet()
+  {
+    QJSEngine engine;
+    QObject root;
+    auto outlet = new JS::ValueOutlet{&root};
+    engine.globalObject().setProperty("outlet", engine.newQObject(outlet));
+
+    QVERIFY(outlet->bufferValues().empty());
+    auto res = engine.evaluate(R"_(
+      var v = outlet.buffer(3);
+      v[0] = 1; v[1] = 2; v[2] = 3;
+    )_");
+    QVERIFY(!res.isError());
+
+    const auto values = outlet->bufferValues();
+    QCOMPARE(values.size(), std::size_t(3));
+    QCOMPARE(values[0], 1.);
+    QCOMPARE(values[1], 2.);
+    QCOMPARE(values[2], 3.);
+
+    outlet->clear();
+    QVERIFY(outlet->bufferValues().empty());
+  }
+  W_SLOT(test_value_outlet)
+};
+
+W_OBJECT_IMPL(JSArrayTest)
+SCORE_INTEGRATION_TEST_OBJECT(JSArrayTest)
@@ -0,0 +1,163 @@
+#include <Midi/NoteTable.hpp>
+
+#include <QtTest/QTest>
+
+#include <score_integration.hpp>
+
+#include <algorithm>
+#include <map>
+#include <random>
+#include <vector>
+
+#include <wobjectimpl.h>
+
+using Midi::NoteData;
+using Midi::NoteTable;
+
+class MidiNoteTableTest : public QObject
+{
+  W_OBJECT(MidiNoteTableTest)
+
+public:
+  MidiNoteTableTest(int& argc, char** argv) { }
+
+private:
+  static std::vector<int> idsIn(const NoteTable& t, double t0, double t1)
+  {
+    std::vector<int> res;
+    t.forEachIn(t0, t1, [&](std::size_t i) { res.push_back(t.id(i)); });
+    return res;
+  }
+
+  void test_assign()
+  {
+    NoteTable t;
+    t.assign(
+        {{1, {0.5, 0.1, 60, 100}}, {2, {0.1, 0.2, 61, 90}}, {3, {0.1, 0.5, 62, 80}}});
+
+    QCOMPARE(t.size(), std::size_t(3));
+    QCOMPARE(t.id(0), 2);
+    QCOMPARE(t.id(1), 3);
+    QCOMPARE(t.id(2), 1);
+    QCOMPARE(t.find(3), std::size_t(1));
+    QCOMPARE(t.find(4), t.size());
+    QCOMPARE(int(t.at(t.find(1)).pitch()), 60);
+    QCOMPARE(t.maxEnd(), 0.6);
+
+    // Note 3 started before the range but is still playing
+    QCOMPARE(idsIn(t, 0.35, 0.4), std::vector<int>{3});
+    QCOMPARE(idsIn(t, 0.4, 0.55), (std::vector<int>{3, 1}));
+    QCOMPARE(idsIn(t, 0.7, 1.), std::vector<int>{});
+  }
+  W_SLOT(test_assign)
+
+  void test_apply()
+  {
+    NoteTable t;
+    t.assign({{1, {0.5, 0.1, 60, 100}}, {2, {0.1, 0.2, 61, 90}}});
+
+    NoteTable::Batch batch;
+    batch.removed = {2, 2, 7};
+    batch.set = {{1, {0.0, 0.1, 60, 100}}, {3, {0.2, 0.1, 64, 100}}};
+
+    int removed = 0, updated = 0, added = 0;
+    t.apply(batch, [&](int id, const NoteData* before, const NoteData* after) {
+      if(before && after)
+      {
+        QCOMPARE(id, 1);
+        QCOMPARE(before->start(), 0.5);
+        QCOMPARE(after->start(), 0.0);
+        updated++;
+      }
+      else if(after)
+      {
+        QCOMPARE(id, 3);
+        added++;
+      }
+      else
+      {
+        QCOMPARE(id, 2);
+        removed++;
+      }
+    });
+
+    QCOMPARE(removed, 1);
+    QCOMPARE(updated, 1);
+    QCOMPARE(added, 1);
+    QCOMPARE(t.size(), std::size_t(2));
+    QCOMPARE(t.id(0), 1);
+    QCOMPARE(t.id(1), 3);
+    QCOMPARE(t.find(2), t.size());
+
+    // A note removed and added again in the same batch, e.g. through an undo,
+    // is replaced
+    batch = {};
+    batch.removed = {3};
+    batch.set = {{3, {0.4, 0.1, 65, 100}}};
+    updated = 0;
+    t.apply(batch, [&](int, const NoteData* before, const NoteData* after) {
+      QVERIFY(before && after);
+      updated++;
+    });
+    QCOMPARE(updated, 1);
+    QCOMPARE(int(t.at(t.find(3)).pitch()), 65);
+  }
+  W_SLOT(test_apply)
+
+  void test_random_batches()
+  {
+    NoteTable t;
+    std::map<int, NoteData> ref;
+    std::mt19937 rng{1234};
+    for(int iter = 0; iter < 1000; iter++)
+    {
+      NoteTable::Batch batch;
+      const int k = rng() % 10;
+      for(int j = 0; j < k; j++)
+      {
+        const int id = rng() % 50;
+        if(rng() % 3 == 0)
+          batch.removed.push_back(id);
+        else
+          batch.set.push_back(
+              {id,
+               {(rng() % 100) / 10., (rng() % 30) / 10., Midi::midi_size_t(rng() % 128),
+                64}});
+      }
+
+      auto expected = ref;
+      for(int id : batch.removed)
+        expected.erase(id);
+      for(const auto& [id, n] : batch.set)
+        expected[id] = n;
+
+      t.apply(batch, [&](int id, const NoteData* before, const NoteData* after) {
+        QCOMPARE(before != nullptr, ref.count(id) == 1);
+        QCOMPARE(after != nullptr, expected.count(id) == 1);
+      });
+      ref = std::move(expected);
+
+      QCOMPARE(t.size(), ref.size());
+      QVERIFY(std::is_sorted(t.starts().begin(), t.starts().end()));
+      for(const auto& [id, n] : ref)
+      {
+        const auto i = t.find(id);
+        QVERIFY(i < t.size());
+        QCOMPARE(t.at(i).start(), n.start());
+        QCOMPARE(t.at(i).duration(), n.duration());
+        QCOMPARE(t.at(i).pitch(), n.pitch());
+      }
+
+      const double t0 = (rng() % 100) / 10.;
+      std::size_t count = 0;
+      for(const auto& [id, n] : ref)
+        if(n.start() < t0 + 1. && n.end() > t0)
+          count++;
+      QCOMPARE(idsIn(t, t0, t0 + 1.).size(), count);
+    }
+  }
+  W_SLOT(test_random_batches)
+};
+
+W_OBJECT_IMPL(MidiNoteTableTest)
+SCORE_INTEGRATION_TEST_OBJECT(MidiNoteTableTest)
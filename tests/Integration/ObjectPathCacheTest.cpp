@@ -0,0 +1,82 @@
+#include <score/model/IdentifiedObject.hpp>
+#include <score/model/path/ObjectPathCache.hpp>
+
+#include <QtTest/QTest>
+
+#include <score_integration.hpp>
+
+#include <wobjectimpl.h>
+
+namespace
+{
+struct Node : IdentifiedObject<Node>
+{
+  using IdentifiedObject::IdentifiedObject;
+};
+}
+
+class ObjectPathCacheTest : public QObject
+{
+  W_OBJECT(ObjectPathCacheTest)
+
+public:
+  ObjectPathCacheTest(int& argc, char** argv) { }
+
+private:
+  void test_hit()
+  {
+    QObject root;
+    auto a = new Node{Id<Node>{1}, "A", &root};
+    auto b = new Node{Id<Node>{2}, "B", a};
+    const ObjectPath path{{"A", 1}, {"B", 2}};
+
+    score::ObjectPathCache cache;
+    QCOMPARE(cache.find(path, &root), (QObject*)nullptr);
+
+    cache.insert(path, b);
+    QCOMPARE(cache.find(path, &root), (QObject*)b);
+    QCOMPARE(cache.find(path, &root), (QObject*)b);
+
+    // Same path from another document
+    QObject other;
+    QCOMPARE(cache.find(path, &other), (QObject*)nullptr);
+  }
+  W_SLOT(test_hit)
+
+  void test_invalidation()
+  {
+    QObject root;
+    auto a = new Node{Id<Node>{1}, "A", &root};
+    auto a2 = new Node{Id<Node>{3}, "A", &root};
+    auto b = new Node{Id<Node>{2}, "B", a};
+    const ObjectPath path{{"A", 1}, {"B", 2}};
+
+    score::ObjectPathCache cache;
+
+    // Moved to another parent
+    cache.insert(path, b);
+    b->setParent(a2);
+    QCOMPARE(cache.find(path, &root), (QObject*)nullptr);
+    b->setParent(a);
+    QCOMPARE(cache.find(path, &root), (QObject*)b);
+
+    // Identifier changed
+    b->setId(Id<Node>{5});
+    QCOMPARE(cache.find(path, &root), (QObject*)nullptr);
+    b->setId(Id<Node>{2});
+    QCOMPARE(cache.find(path, &root), (QObject*)b);
+
+    // Cleared, e.g. when the document closes
+    cache.clear();
+    QCOMPARE(cache.find(path, &root), (QObject*)nullptr);
+
+    // Deleted
+    cache.insert(path, b);
+    delete b;
+    QCOMPARE(cache.find(path, &root), (QObject*)nullptr);
+  }
+  W_SLOT(test_invalidation)
+};
+
+W_OBJECT_IMPL(ObjectPathCacheTest)
+SCORE_INTEGRATION_TEST_OBJECT(ObjectPathCacheTest)
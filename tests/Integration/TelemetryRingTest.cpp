@@ -0,0 +1,109 @@
+#include <Execution/ExecutionTelemetry.hpp>
+
+#include <QtTest/QTest>
+
+#include <score_integration.hpp>
+
+#include <memory>
+#include <thread>
+
+#include <wobjectimpl.h>
+
+using Execution::TelemetryRing;
+using Execution::TickTelemetry;
+
+class TelemetryRingTest : public QObject
+{
+  W_OBJECT(TelemetryRingTest)
+
+public:
+  TelemetryRingTest(int& argc, char** argv) { }
+
+private:
+  void test_fifo()
+  {
+    auto ring = std::make_unique<TelemetryRing>();
+    TickTelemetry t;
+    QVERIFY(!ring->pop(t));
+
+    for(int i = 0; i < 10; i++)
+      QVERIFY(ring->push({i, 100, i, 0, false}));
+
+    for(int i = 0; i < 10; i++)
+    {
+      QVERIFY(ring->pop(t));
+      QCOMPARE(t.duration_ns, int64_t(i));
+      QCOMPARE(t.commands, i);
+    }
+    QVERIFY(!ring->pop(t));
+  }
+  W_SLOT(test_fifo)
+
+  void test_overflow()
+  {
+    auto ring = std::make_unique<TelemetryRing>();
+    for(std::size_t i = 0; i < TelemetryRing::capacity; i++)
+      QVERIFY(ring->push({int64_t(i)}));
+
+    QVERIFY(!ring->push({-1}));
+    QVERIFY(!ring->push({-1}));
+    QCOMPARE(ring->takeDropped(), int64_t(2));
+    QCOMPARE(ring->takeDropped(), int64_t(0));
+
+    // The oldest records are kept
+    TickTelemetry t;
+    QVERIFY(ring->pop(t));
+    QCOMPARE(t.duration_ns, int64_t(0));
+    QVERIFY(ring->push({int64_t(TelemetryRing::capacity)}));
+  }
+  W_SLOT(test_overflow)
+
+  void test_clear()
+  {
+    auto ring = std::make_unique<TelemetryRing>();
+    for(std::size_t i = 0; i < TelemetryRing::capacity + 5; i++)
+      ring->push({int64_t(i)});
+
+    ring->clear();
+    TickTelemetry t;
+    QVERIFY(!ring->pop(t));
+    QCOMPARE(ring->takeDropped(), int64_t(0));
+
+    QVERIFY(ring->push({42}));
+    QVERIFY(ring->pop(t));
+    QCOMPARE(t.duration_ns, int64_t(42));
+  }
+  W_SLOT(test_clear)
+
+  void test_concurrent()
+  {
+    auto ring = std::make_unique<TelemetryRing>();
+    constexpr int64_t count = 100000;
+
+    std::thread producer{[&] {
+      for(int64_t i = 0; i < count; i++)
+        while(!ring->push({i}))
+          std::this_thread::yield();
+    }};
+
+    int64_t expected = 0;
+    bool ordered = true;
+    TickTelemetry t;
+    while(expected < count)
+    {
+      if(ring->pop(t))
+      {
+        ordered &= (t.duration_ns == expected);
+        expected++;
+      }
+    }
+    producer.join();
+
+    QVERIFY(ordered);
+    QVERIFY(!ring->pop(t));
+  }
+  W_SLOT(test_concurrent)
+};
+
+W_OBJECT_IMPL(TelemetryRingTest)
+SCORE_INTEGRATION_TEST_OBJECT(TelemetryRingTest)
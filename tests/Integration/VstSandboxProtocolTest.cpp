@@ -0,0 +1,209 @@
+#include <Vst/SandboxNode.hpp>
+
+#include <QtTest/QTest>
+
+#include <score_integration.hpp>
+
+#include <cstddef>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+#include <wobjectimpl.h>
+
+using namespace vst::sandbox;
+
+class VstSandboxProtocolTest : public QObject
+{
+  W_OBJECT(VstSandboxProtocolTest)
+
+public:
+  VstSandboxProtocolTest(int& argc, char** argv) { }
+
+private:
+  //! Stands for the shared memory mapped by both processes
+  struct test_block
+  {
+    test_block(int inputs, int outputs, int frames, uint32_t params, uint32_t chunk)
+        : memory(
+            shared_block::size(inputs, outputs, frames, params, chunk)
+                / sizeof(std::max_align_t)
+            + 1)
+        , block{*new(memory.data()) shared_block}
+    {
+      block.buffer_size = frames;
+      block.inputs = inputs;
+      block.outputs = outputs;
+      block.state_params = params;
+      block.chunk_capacity = chunk;
+    }
+
+    std::vector<std::max_align_t> memory;
+    shared_block& block;
+  };
+
+  void test_layout()
+  {
+    test_block t{3, 4, 64, 5, 16};
+    auto& b = t.block;
+
+    for(int c = 0; c < b.inputs; c++)
+      std::fill_n(b.input(c), b.buffer_size, float(c));
+    for(int c = 0; c < b.outputs; c++)
+      std::fill_n(b.output(c), b.buffer_size, float(10 + c));
+    std::fill_n(b.stateParams(), b.state_params, 0.5f);
+    std::fill_n(b.stateChunk(), b.chunk_capacity, 'x');
+
+    for(int c = 0; c < b.inputs; c++)
+      QVERIFY(std::all_of(
+          b.input(c), b.input(c) + b.buffer_size, [=](float f) { return f == c; }));
+    for(int c = 0; c < b.outputs; c++)
+      QVERIFY(std::all_of(b.output(c), b.output(c) + b.buffer_size, [=](float f) {
+        return f == 10 + c;
+      }));
+    QCOMPARE(b.stateParams()[4], 0.5f);
+
+    const auto end = reinterpret_cast<char*>(&b) + shared_block::size(3, 4, 64, 5, 16);
+    QCOMPARE(b.stateChunk() + b.chunk_capacity, end);
+  }
+  W_SLOT(test_layout)
+
+  void test_midi()
+  {
+    test_block t{2, 2, 64, 0, 0};
+    auto& b = t.block;
+
+    const uint8_t note[3]{0x90, 60, 100};
+    std::vector<uint8_t> sysex(300);
+    std::iota(sysex.begin(), sysex.end(), 0);
+    sysex.front() = 0xF0;
+    sysex.back() = 0xF7;
+
+    b.clearMidi();
+    QVERIFY(b.pushMidi(3, note, 3));
+    QVERIFY(b.pushMidi(7, sysex.data(), sysex.size()));
+
+    std::vector<std::pair<int32_t, std::vector<uint8_t>>> received;
+    b.forEachMidi([&](int32_t frame, const uint8_t* bytes, uint32_t size) {
+      received.push_back({frame, {bytes, bytes + size}});
+    });
+    QCOMPARE(received.size(), std::size_t(2));
+    QCOMPARE(received[0].first, 3);
+    QCOMPARE(received[0].second, std::vector<uint8_t>(note, note + 3));
+    QCOMPARE(received[1].first, 7);
+    QCOMPARE(received[1].second, sysex);
+
+    // Events which do not fit are refused
+    std::vector<uint8_t> huge(max_midi_bytes);
+    QVERIFY(!b.pushMidi(0, huge.data(), huge.size()));
+    b.clearMidi();
+    for(int i = 0; i < max_midi; i++)
+      QVERIFY(b.pushMidi(i, note, 3));
+    QVERIFY(!b.pushMidi(0, note, 3));
+
+    // Events pointing out of the block are skipped by the puppet
+    b.midi[0].offset = max_midi_bytes - 1;
+    int count = 0;
+    b.forEachMidi([&](auto...) { count++; });
+    QCOMPARE(count, max_midi - 1);
+  }
+  W_SLOT(test_midi)
+
+  void test_request()
+  {
+    test_block t{2, 3, 128, 0, 0};
+    auto& b = t.block;
+
+    // Puppet: copies the inputs to the outputs, the last one gets the sum
+    std::thread puppet{[&] {
+      uint32_t processed = b.request.load(std::memory_order_acquire);
+      b.done.store(processed, std::memory_order_release);
+      b.ready.store(1, std::memory_order_release);
+      while(!b.quit.load(std::memory_order_acquire))
+      {
+        const uint32_t request = b.request.load(std::memory_order_acquire);
+        if(request == processed)
+        {
+          futex_wait(b.request, processed, 1'000'000);
+          continue;
+        }
+
+        for(int i = 0; i < b.frames; i++)
+        {
+          b.output(0)[i] = b.input(0)[i];
+          b.output(1)[i] = b.input(1)[i];
+          b.output(2)[i] = b.input(0)[i] + b.input(1)[i];
+        }
+        processed = request;
+        b.done.store(processed, std::memory_order_release);
+        futex_wake(b.done);
+      }
+    }};
+
+    while(!b.ready.load(std::memory_order_acquire))
+      std::this_thread::yield();
+
+    uint32_t request = b.done.load(std::memory_order_acquire);
+    for(int n = 1; n <= 10; n++)
+    {
+      b.frames = 12 * n;
+      for(int i = 0; i < b.frames; i++)
+      {
+        b.input(0)[i] = n;
+        b.input(1)[i] = i;
+      }
+      b.request.store(++request, std::memory_order_release);
+      futex_wake(b.request);
+
+      while(b.done.load(std::memory_order_acquire) != request)
+        futex_wait(b.done, request - 1, 1'000'000);
+
+      for(int i = 0; i < b.frames; i++)
+      {
+        QCOMPARE(b.output(0)[i], float(n));
+        QCOMPARE(b.output(1)[i], float(i));
+        QCOMPARE(b.output(2)[i], float(n + i));
+      }
+    }
+
+    b.quit.store(1, std::memory_order_release);
+    futex_wake(b.request);
+    puppet.join();
+  }
+  W_SLOT(test_request)
+
+  void test_delay()
+  {
+    // Frames are numbered from 1: the first buffer played is silent
+    constexpr int64_t bs = 64;
+    delay_line delay{2, bs};
+    QCOMPARE(delay.latency(), bs);
+
+    std::vector<std::vector<double>> out(2, std::vector<double>(bs));
+    std::vector<float> previous;
+    std::vector<double> played;
+    int64_t sent = 0;
+    for(int64_t samples : {64, 10, 64, 1, 33, 64, 64, 20})
+    {
+      // Output of the previous tick, as written by the puppet
+      delay.push(int64_t(previous.size()), [&](std::size_t) {
+        return previous.data();
+      });
+
+      previous.resize(samples);
+      std::iota(previous.begin(), previous.end(), float(sent + 1));
+      sent += samples;
+
+      delay.pop(out, 0, samples);
+      QCOMPARE(out[0], out[1]);
+      played.insert(played.end(), out[0].begin(), out[0].begin() + samples);
+    }
+
+    for(std::size_t i = 0; i < played.size(); i++)
+      QCOMPARE(played[i], i < bs ? 0. : double(i - bs + 1));
+  }
+  W_SLOT(test_delay)
+};
+
+W_OBJECT_IMPL(VstSandboxProtocolTest)
+SCORE_INTEGRATION_TEST_OBJECT(VstSandboxProtocolTest)
@@ -0,0 +1,85 @@
+#include <score_integration.hpp>
+
+#include <Scenario/Commands/Metadata/ChangeElementComments.hpp>
+#include <Scenario/Document/Interval/IntervalModel.hpp>
+#include <Scenario/Document/ScenarioDocument/ScenarioDocumentModel.hpp>
+
+#include <score/plugins/documentdelegate/DocumentDelegateFactory.hpp>
+
+#include <core/command/CommandArena.hpp>
+#include <core/document/Document.hpp>
+#include <core/document/DocumentModel.hpp>
+#include <core/presenter/DocumentManager.hpp>
+
+#include <QLocale>
+
+#include <clocale>
+#include <memory>
+#include <vector>
+
+using ChangeComments = Scenario::Command::ChangeElementComments<Scenario::IntervalModel>;
+
+static void run_test()
+{
+  const auto& ctx = score::GUIAppContext();
+  auto& docs = ctx.interfaces<score::DocumentDelegateList>();
+  SCORE_ASSERT(!docs.empty());
+  auto doc = ctx.docManager.newDocument(ctx, Id<score::DocumentModel>{}, *docs.begin());
+  QApplication::processEvents();
+  SCORE_ASSERT(doc);
+
+  auto& scenario_dm
+      = safe_cast<Scenario::ScenarioDocumentModel&>(doc->model().modelDelegate());
+  auto& itv = scenario_dm.baseInterval();
+  const auto& dctx = doc->context();
+  const QString initial = itv.metadata().getComment();
+
+  std::vector<std::unique_ptr<ChangeComments>> cmds;
+  for(int i = 0; i < 8; i++)
+    cmds.push_back(std::make_unique<ChangeComments>(itv, QString("comment %1").arg(i)));
+
+  // Everything in memory, then everything moved to the arena file
+  for(qint64 limit : {qint64(1) << 20, qint64(1)})
+  {
+    score::CommandArena arena{limit};
+    {
+      std::vector<std::unique_ptr<score::CompactCommand>> compacted;
+      for(auto& cmd : cmds)
+        compacted.push_back(std::make_unique<score::CompactCommand>(arena, *cmd));
+      SCORE_ASSERT((arena.memory() == 0) == (limit == 1));
+
+      // Read back out of order
+      for(int i : {5, 0, 7, 3, 1, 6, 2, 4})
+      {
+        auto& cmd = *cmds[i];
+        auto& compact = *compacted[i];
+        SCORE_ASSERT(compact.serialize() == cmd.serialize());
+        SCORE_ASSERT(compact.key() == cmd.key());
+        SCORE_ASSERT(compact.parentKey() == cmd.parentKey());
+        SCORE_ASSERT(compact.description() == cmd.description());
+
+        compact.redo(dctx);
+        SCORE_ASSERT(itv.metadata().getComment() == QString("comment %1").arg(i));
+        compact.undo(dctx);
+        SCORE_ASSERT(itv.metadata().getComment() == initial);
+      }
+    }
+    SCORE_ASSERT(arena.memory() == 0);
+  }
+
+  ctx.docManager.forceCloseDocument(ctx, *doc);
+  QApplication::processEvents();
+  qApp->exit(0);
+}
+
+int main(int argc, char** argv)
+{
+  QLocale::setDefault(QLocale::C);
+  std::setlocale(LC_ALL, "C");
+
+  score::MinimalGUIApplication app(argc, argv);
+
+  QMetaObject::invokeMethod(&app, run_test, Qt::QueuedConnection);
+
+  return app.exec();
+}